@@ -0,0 +1,1415 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined (__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <linux/input.h>
+#endif
+
+#include "decaf/input/actionmap.hh"
+#include "decaf/input/combo.hh"
+#include "decaf/input/deadzone.hh"
+#include "decaf/input/gamepad.hh"
+#include "decaf/input/gamepadcontext.hh"
+#include "decaf/input/gamepadhistory.hh"
+#include "decaf/input/gamepadimpl.hh"
+#include "decaf/input/latelatch.hh"
+#include "decaf/input/latency.hh"
+#include "decaf/input/response.hh"
+#include "decaf/input/responsebatch.hh"
+#include "decaf/input/rumble.hh"
+#include "decaf/input/stickfilter.hh"
+#include "decaf/input/mock/gamepadimpl_mock.hh"
+#include "decaf/input/remote/remotestream.hh"
+#include "decaf/input/remote/statecodec.hh"
+#include "decaf/input/replay/replayformat.hh"
+#include "decaf/math/vector.hh"
+#include "decaf/math/vectorarray.hh"
+
+#if defined (__linux__)
+#include "decaf/input/linux/gamepadimpl_linux.hh"
+#endif
+
+using namespace decaf;
+
+namespace
+{
+
+	////////////////////////////////////////////////////////////
+	// Harness
+	////////////////////////////////////////////////////////////
+
+	/// <summary>Keeps the compiler from discarding a value that is only computed for timing.</summary>
+	template <typename T>
+	inline void DoNotOptimize(const T& value)
+	{
+#if defined (__GNUC__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		static volatile char sink;
+		sink = *reinterpret_cast<const volatile char*>(&value);
+#endif
+	}
+
+	struct Case
+	{
+		std::string name;
+		size_t itemsPerIteration;
+		std::function<void(uint64_t)> run;
+		const double* bytesPerItem;
+	};
+
+	struct Result
+	{
+		std::string name;
+		uint64_t iterations;
+		size_t itemsPerIteration;
+		double nsPerItem;
+		double minNsPerItem;
+		double maxNsPerItem;
+		double bytesPerItem;
+	};
+
+	struct Options
+	{
+		std::string filter;
+		std::string output;
+		double minTime = 0.05;
+		int repetitions = 5;
+		bool list = false;
+	};
+
+	std::vector<Case>& Cases()
+	{
+		static std::vector<Case> cases;
+		return cases;
+	}
+
+	/// <param name='bytesPerItem'>Optionally, a size the case reports per item, e.g. encoded bytes, read after it has run.</param>
+	void Register(std::string name, size_t itemsPerIteration, std::function<void(uint64_t)> run, const double* bytesPerItem = nullptr)
+	{
+		Cases().push_back({ std::move(name), itemsPerIteration, std::move(run), bytesPerItem });
+	}
+
+	double Seconds(const std::function<void(uint64_t)>& run, uint64_t iterations)
+	{
+		auto start = std::chrono::steady_clock::now();
+		run(iterations);
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	Result Measure(const Case& c, const Options& options)
+	{
+		// Grow the iteration count until one run takes at least the minimum time.
+		uint64_t iterations = 1;
+		double elapsed = Seconds(c.run, iterations);
+
+		while (elapsed < options.minTime && iterations < (uint64_t(1) << 40))
+		{
+			double scale = elapsed > 0.0 ? (options.minTime * 1.2) / elapsed : 10.0;
+			iterations = std::max(iterations + 1, static_cast<uint64_t>(iterations * std::min(std::max(scale, 1.5), 10.0)));
+			elapsed = Seconds(c.run, iterations);
+		}
+
+		std::vector<double> samples;
+
+		for (int i = 0; i < options.repetitions; ++i)
+			samples.push_back(Seconds(c.run, iterations) * 1e9 / (double(iterations) * c.itemsPerIteration));
+
+		std::sort(samples.begin(), samples.end());
+
+		return { c.name, iterations, c.itemsPerIteration, samples[samples.size() / 2], samples.front(), samples.back(), c.bytesPerItem != nullptr ? *c.bytesPerItem : -1.0 };
+	}
+
+	void WriteJson(FILE* file, const std::vector<Result>& results)
+	{
+		static const char* KernelNames[] = { "scalar", "sse2", "avx2" };
+
+		fprintf(file, "{\n  \"context\": {\n");
+		fprintf(file, "    \"suite\": \"gamepad_bench\",\n");
+		fprintf(file, "    \"response_kernel\": \"%s\",\n", KernelNames[static_cast<int>(Response::ActiveKernel())]);
+#if defined (DECAF_MATH_SSE)
+		fprintf(file, "    \"vector_simd\": true,\n");
+#else
+		fprintf(file, "    \"vector_simd\": false,\n");
+#endif
+#if defined (NDEBUG)
+		fprintf(file, "    \"build\": \"release\"\n");
+#else
+		fprintf(file, "    \"build\": \"debug\"\n");
+#endif
+		fprintf(file, "  },\n  \"benchmarks\": [\n");
+
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const Result& r = results[i];
+			char bytes[48] = "";
+
+			if (r.bytesPerItem >= 0.0)
+				snprintf(bytes, sizeof(bytes), ", \"bytes_per_item\": %.2f", r.bytesPerItem);
+
+			fprintf(file, "    { \"name\": \"%s\", \"iterations\": %llu, \"items_per_iteration\": %zu, \"ns_per_item\": %.4f, \"min_ns_per_item\": %.4f, \"max_ns_per_item\": %.4f, \"items_per_second\": %.1f%s }%s\n",
+				r.name.c_str(), static_cast<unsigned long long>(r.iterations), r.itemsPerIteration, r.nsPerItem, r.minNsPerItem, r.maxNsPerItem,
+				r.nsPerItem > 0.0 ? 1e9 / r.nsPerItem : 0.0, bytes, i + 1 < results.size() ? "," : "");
+		}
+
+		fprintf(file, "  ]\n}\n");
+	}
+
+	////////////////////////////////////////////////////////////
+	// Gamepad
+	////////////////////////////////////////////////////////////
+
+	/// <summary>Moves the sticks in circles and walks a bit through the buttons, so consecutive updates always differ.</summary>
+	GamepadImpl_Mock::RawState Wander(Gamepad::Index index, uint64_t update, void*)
+	{
+		GamepadImpl_Mock::RawState raw = {};
+		double phase = double(update) * 0.05 + static_cast<int>(index);
+
+		raw.thumbLX = static_cast<int16_t>(32000.0 * std::cos(phase));
+		raw.thumbLY = static_cast<int16_t>(32000.0 * std::sin(phase));
+		raw.thumbRX = static_cast<int16_t>(12000.0 * std::cos(phase * 3.0));
+		raw.thumbRY = static_cast<int16_t>(12000.0 * std::sin(phase * 3.0));
+		raw.leftTrigger = static_cast<uint8_t>(update);
+		raw.rightTrigger = static_cast<uint8_t>(255 - update);
+		raw.buttons = static_cast<uint16_t>(1u << (update % 16));
+		raw.connected = true;
+
+		return raw;
+	}
+
+	const Gamepad::Button AllButtons[] =
+	{
+		Gamepad::Button::DPAD_UP, Gamepad::Button::DPAD_DOWN, Gamepad::Button::DPAD_LEFT, Gamepad::Button::DPAD_RIGHT,
+		Gamepad::Button::START, Gamepad::Button::BACK, Gamepad::Button::LTHUMB, Gamepad::Button::RTHUMB,
+		Gamepad::Button::LSHOULDER, Gamepad::Button::RSHOULDER, Gamepad::Button::A, Gamepad::Button::B,
+		Gamepad::Button::X, Gamepad::Button::Y
+	};
+
+	constexpr size_t ButtonCount = sizeof(AllButtons) / sizeof(AllButtons[0]);
+
+	void RegisterGamepad(GamepadImpl_Mock& mock)
+	{
+		Register("gamepad/update", 1, [](uint64_t n)
+		{
+			for (uint64_t i = 0; i < n; ++i)
+				Gamepad::Update();
+		});
+
+		Register("gamepad/poll", 1, [](uint64_t n)
+		{
+			Gamepad pad(Gamepad::Index::ONE);
+
+			for (uint64_t i = 0; i < n; ++i)
+				DoNotOptimize(pad.Poll());
+		});
+
+		Register("gamepad/update_poll", 1, [](uint64_t n)
+		{
+			Gamepad pad(Gamepad::Index::ONE);
+
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				Gamepad::Update();
+				DoNotOptimize(pad.Poll());
+			}
+		});
+
+		Register("gamepad/poll_mark_consumed", 1, [](uint64_t n)
+		{
+			Gamepad pad(Gamepad::Index::ONE);
+
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				DoNotOptimize(pad.Poll());
+				pad.MarkConsumed();
+			}
+		});
+
+		Register("latency/record", 1, [](uint64_t n)
+		{
+			static LatencyHistogram histogram;
+
+			for (uint64_t i = 0; i < n; ++i)
+				histogram.Record((i * 2654435761u) & 0xfffff);
+		});
+
+		Register("latency/stats", 1, [](uint64_t n)
+		{
+			for (uint64_t i = 0; i < n; ++i)
+				DoNotOptimize(Gamepad::GetLatency(Gamepad::Index::ONE, Gamepad::Latency::SAMPLE_TO_POLL));
+		});
+
+		Register("rumble/set_rumble_unchanged", 1, [](uint64_t n)
+		{
+			for (uint64_t i = 0; i < n; ++i)
+				Gamepad::SetRumble(Gamepad::Index::ONE, 0.5f, 0.25f);
+
+			Gamepad::FlushRumble();
+		});
+
+		Register("rumble/tick_4x4_effects", Gamepad::IndexCount, [](uint64_t n)
+		{
+			static RumbleMixer mixer;
+			RumbleEffect effect = { 0.8f, 0.4f, 0, RumbleEffect::Forever, 0, 0 };
+
+			for (size_t pad = 0; pad < Gamepad::IndexCount; ++pad)
+			{
+				mixer.StopAll(static_cast<Gamepad::Index>(pad), 0);
+
+				for (effect.priority = 0; effect.priority < 4; ++effect.priority)
+					mixer.Play(static_cast<Gamepad::Index>(pad), effect, 0);
+			}
+
+			for (uint64_t i = 0; i < n; ++i)
+				mixer.Tick(i);
+		});
+
+		Register("gamepad/poll_batch4", Gamepad::IndexCount, [](uint64_t n)
+		{
+			Gamepad pads[] = { Gamepad(Gamepad::Index::ONE), Gamepad(Gamepad::Index::TWO), Gamepad(Gamepad::Index::THREE), Gamepad(Gamepad::Index::FOUR) };
+
+			for (uint64_t i = 0; i < n; ++i)
+				DoNotOptimize(Gamepad::Poll(pads, Gamepad::IndexCount));
+		});
+
+		Register("gamepad/state_changed", 1, [](uint64_t n)
+		{
+			Gamepad pad(Gamepad::Index::ONE);
+			Gamepad::Update();
+			pad.Poll();
+
+			for (uint64_t i = 0; i < n; ++i)
+				DoNotOptimize(pad.StateChanged());
+		});
+
+		Register("gamepad/changed_fields", 1, [](uint64_t n)
+		{
+			Gamepad pad(Gamepad::Index::ONE);
+			Gamepad::Update();
+			pad.Poll();
+
+			for (uint64_t i = 0; i < n; ++i)
+				DoNotOptimize(pad.FieldChanged(Gamepad::Field::LEFT_STICK));
+		});
+
+		Register("gamepad/is_connected", 1, [](uint64_t n)
+		{
+			Gamepad pad(Gamepad::Index::ONE);
+			pad.Poll();
+
+			for (uint64_t i = 0; i < n; ++i)
+				DoNotOptimize(pad.IsConnected());
+		});
+
+		Register("gamepad/is_connected_empty_slot", 1, [](uint64_t n)
+		{
+			for (uint64_t i = 0; i < n; ++i)
+				DoNotOptimize(Gamepad::IsConnected(Gamepad::Index::FOUR));
+		});
+
+		Register("gamepad/is_button_down_loop", ButtonCount, [](uint64_t n)
+		{
+			Gamepad pad(Gamepad::Index::ONE);
+			pad.Poll();
+
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				for (Gamepad::Button button : AllButtons)
+					DoNotOptimize(pad.IsButtonDown(button));
+			}
+		});
+
+		Register("gamepad/was_button_pressed_loop", ButtonCount, [](uint64_t n)
+		{
+			Gamepad pad(Gamepad::Index::ONE);
+			pad.Poll();
+
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				for (Gamepad::Button button : AllButtons)
+					DoNotOptimize(pad.WasButtonPressed(button));
+			}
+		});
+
+		Register("gamepad/was_button_released_loop", ButtonCount, [](uint64_t n)
+		{
+			Gamepad pad(Gamepad::Index::ONE);
+			pad.Poll();
+
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				for (Gamepad::Button button : AllButtons)
+					DoNotOptimize(pad.WasButtonReleased(button));
+			}
+		});
+
+		Register("actions/evaluate_32", 32, [](uint64_t n)
+		{
+			// 32 actions over a gameplay layer and a menu layer that shadows some of them: chords, modifiers and axis thresholds.
+			ActionMap map;
+			ActionMap::LayerId gameplay = map.AddLayer("gameplay", 0);
+			ActionMap::LayerId menu = map.AddLayer("menu", 10);
+
+			for (size_t i = 0; i < 32; ++i)
+			{
+				ActionMap::ActionId action = map.DefineAction("action" + std::to_string(i));
+				Gamepad::Button button = AllButtons[i % ButtonCount];
+
+				if (i % 4 == 0)
+					map.Bind(gameplay, action, ActionBinding::Axis(static_cast<Gamepad::Axis>(i / 4 % 6), (i & 8) ? -0.5f : 0.5f));
+				else if (i % 4 == 1)
+					map.Bind(gameplay, action, ActionBinding::Button(button).With(Gamepad::Button::LSHOULDER));
+				else
+					map.Bind(gameplay, action, ActionBinding::Button(button).Without(Gamepad::Button::LSHOULDER));
+
+				if (i % 8 == 0)
+					map.Bind(menu, action, ActionBinding::Button(button));
+			}
+
+			map.EnableLayer(gameplay, true);
+			map.EnableLayer(menu, true);
+
+			Gamepad pad(Gamepad::Index::ONE);
+			pad.Poll();
+			ActionFrame frame;
+
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				map.Evaluate(pad, frame);
+				DoNotOptimize(frame);
+			}
+		});
+
+		Register("gamepad/get_state", 1, [](uint64_t n)
+		{
+			for (uint64_t i = 0; i < n; ++i)
+				DoNotOptimize(Gamepad::GetState(Gamepad::Index::ONE));
+		});
+
+		Register("gamepad/get_state_deadzone", 1, [](uint64_t n)
+		{
+			for (uint64_t i = 0; i < n; ++i)
+				DoNotOptimize(Gamepad::GetState(Gamepad::Index::ONE, 0.3f));
+		});
+
+		static const std::pair<const char*, DeadzoneSettings::Mode> Modes[] =
+		{
+			{ "axial", DeadzoneSettings::Mode::AXIAL },
+			{ "radial", DeadzoneSettings::Mode::RADIAL },
+			{ "scaled_radial", DeadzoneSettings::Mode::SCALED_RADIAL },
+			{ "hybrid", DeadzoneSettings::Mode::HYBRID }
+		};
+
+		for (const auto& mode : Modes)
+		{
+			DeadzoneSettings settings = { mode.second, 0.24f, 0.95f };
+
+			Register(std::string("gamepad/get_state_deadzone_") + mode.first, 1, [settings](uint64_t n)
+			{
+				for (uint64_t i = 0; i < n; ++i)
+					DoNotOptimize(Gamepad::GetState(Gamepad::Index::ONE, settings));
+			});
+		}
+
+		Register("gamepad/get_states4", Gamepad::IndexCount, [](uint64_t n)
+		{
+			Gamepad::State states[Gamepad::IndexCount];
+
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				DoNotOptimize(Gamepad::GetStates(states, Gamepad::IndexCount));
+				DoNotOptimize(states);
+			}
+		});
+
+		// Compare with gamepad/get_state, which makes the same read through IGamepadImpl::Instance.
+		Register("context/get_state_typed", 1, [](uint64_t n)
+		{
+			static GamepadContext<GamepadImpl_Mock> context;
+			context.GetBackend().SetGenerator(Wander);
+			context.Update();
+
+			for (uint64_t i = 0; i < n; ++i)
+				DoNotOptimize(context.GetState(Gamepad::Index::ONE));
+		});
+
+		Register("context/get_state_any", 1, [](uint64_t n)
+		{
+			static GamepadContext<GamepadImpl_Mock> context;
+			context.GetBackend().SetGenerator(Wander);
+			context.Update();
+
+			AnyGamepadContext any(context);
+
+			for (uint64_t i = 0; i < n; ++i)
+				DoNotOptimize(any.GetState(Gamepad::Index::ONE));
+		});
+
+		Register("parse/mock_get_state", 1, [&](uint64_t n)
+		{
+			for (uint64_t i = 0; i < n; ++i)
+				DoNotOptimize(mock.GetState(Gamepad::Index::ONE));
+		});
+	}
+
+	////////////////////////////////////////////////////////////
+	// Parse and normalize
+	////////////////////////////////////////////////////////////
+
+	template <typename T>
+	std::vector<T> RandomValues(size_t count, T minimum, T maximum, unsigned seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> distribution(minimum, maximum);
+		std::vector<T> values(count);
+
+		for (T& value : values)
+			value = static_cast<T>(distribution(rng));
+
+		return values;
+	}
+
+	void RegisterParse()
+	{
+		constexpr size_t Samples = 4096;
+
+		static std::vector<int16_t> rawX = RandomValues<int16_t>(Samples, -32768, 32767, 1);
+		static std::vector<int16_t> rawY = RandomValues<int16_t>(Samples, -32768, 32767, 2);
+		static std::vector<uint8_t> rawTrigger = RandomValues<uint8_t>(Samples, 0, 255, 3);
+		static std::vector<float> outX(Samples), outY(Samples);
+
+		Register("parse/stick_response", Samples, [](uint64_t n)
+		{
+			const StickResponse& response = StickResponse::XInputLeft();
+
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				for (size_t s = 0; s < Samples; ++s)
+				{
+					Vector2f stick = response(rawX[s], rawY[s]);
+					outX[s] = stick[0];
+					outY[s] = stick[1];
+				}
+
+				DoNotOptimize(outX.data());
+			}
+		});
+
+		static const std::pair<const char*, Response::Kernel> Kernels[] =
+		{
+			{ "scalar", Response::Kernel::SCALAR },
+			{ "sse2", Response::Kernel::SSE2 },
+			{ "avx2", Response::Kernel::AVX2 }
+		};
+
+		Response::Kernel best = Response::ActiveKernel();
+
+		for (const auto& kernel : Kernels)
+		{
+			if (Response::SelectKernel(kernel.second) != kernel.second)
+				continue;
+
+			Response::Kernel selected = kernel.second;
+
+			Register(std::string("batch/convert_stick_") + kernel.first, Samples, [selected, best](uint64_t n)
+			{
+				Response::SelectKernel(selected);
+
+				for (uint64_t i = 0; i < n; ++i)
+				{
+					Response::ConvertStick(StickResponse::XInputLeft(), rawX.data(), rawY.data(), outX.data(), outY.data(), Samples);
+					DoNotOptimize(outX.data());
+				}
+
+				Response::SelectKernel(best);
+			});
+
+			Register(std::string("batch/convert_trigger_") + kernel.first, Samples, [selected, best](uint64_t n)
+			{
+				Response::SelectKernel(selected);
+
+				for (uint64_t i = 0; i < n; ++i)
+				{
+					Response::ConvertTrigger(TriggerResponse::Linear(), rawTrigger.data(), outX.data(), Samples);
+					DoNotOptimize(outX.data());
+				}
+
+				Response::SelectKernel(best);
+			});
+		}
+
+		Response::SelectKernel(best);
+
+		static std::vector<Vector2f> sticks(Samples);
+
+		for (size_t s = 0; s < Samples; ++s)
+			sticks[s] = StickResponse::Linear()(rawX[s], rawY[s]);
+
+		static const std::pair<const char*, DeadzoneSettings::Mode> Modes[] =
+		{
+			{ "axial", DeadzoneSettings::Mode::AXIAL },
+			{ "radial", DeadzoneSettings::Mode::RADIAL },
+			{ "scaled_radial", DeadzoneSettings::Mode::SCALED_RADIAL },
+			{ "hybrid", DeadzoneSettings::Mode::HYBRID }
+		};
+
+		for (const auto& mode : Modes)
+		{
+			DeadzoneSettings settings = { mode.second, 0.24f, 0.95f };
+
+			Register(std::string("batch/deadzone_") + mode.first, Samples, [settings](uint64_t n)
+			{
+				std::vector<Vector2f> work(sticks);
+
+				for (uint64_t i = 0; i < n; ++i)
+				{
+					std::copy(sticks.begin(), sticks.end(), work.begin());
+					Deadzone::Apply(work.data(), work.size(), settings);
+					DoNotOptimize(work.data());
+				}
+			});
+		}
+
+		static const std::pair<const char*, StickFilterSettings> Filters[] =
+		{
+			{ "one_euro", StickFilterSettings::OneEuro() },
+			{ "critically_damped", StickFilterSettings::CriticallyDamped() },
+			{ "one_euro_lead", StickFilterSettings::OneEuro(1.0f, 20.0f, 0.01f) }
+		};
+
+		// One pass over all four pads per iteration, each with a new 1 ms sample.
+		for (const auto& filter : Filters)
+		{
+			StickFilterSettings settings = filter.second;
+
+			Register(std::string("batch/stick_filter_") + filter.first, Gamepad::IndexCount, [settings](uint64_t n)
+			{
+				StickFilter filters;
+				Gamepad::State states[Gamepad::IndexCount] = {};
+
+				for (size_t p = 0; p < Gamepad::IndexCount; ++p)
+				{
+					filters.SetSettings(static_cast<Gamepad::Index>(p), settings, settings);
+					states[p].connected = true;
+				}
+
+				for (uint64_t i = 0; i < n; ++i)
+				{
+					for (size_t p = 0; p < Gamepad::IndexCount; ++p)
+					{
+						states[p].leftStick = sticks[(i + p) % Samples];
+						states[p].rightStick = sticks[(i + p + 1) % Samples];
+						states[p].timestamp = (i + 1) * 1000000;
+					}
+
+					filters.Apply(states, Gamepad::IndexCount, (i + 1) * 1000000);
+					DoNotOptimize(states);
+				}
+			});
+		}
+
+#if defined (__linux__)
+		// Drives the evdev backend through a pipe: one full report (4 axes, 2 triggers, 1 button, SYN) per iteration.
+		Register("parse/linux_evdev_report", 1, [](uint64_t n)
+		{
+			int fds[2];
+
+			if (pipe(fds) != 0)
+				return;
+
+			fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+
+			GamepadImpl_Linux backend(false);
+			backend.Attach(Gamepad::Index::ONE, fds[0]);
+
+			input_event report[8];
+			memset(report, 0, sizeof(report));
+
+			const uint16_t types[] = { EV_ABS, EV_ABS, EV_ABS, EV_ABS, EV_ABS, EV_ABS, EV_KEY, EV_SYN };
+			const uint16_t codes[] = { ABS_X, ABS_Y, ABS_RX, ABS_RY, ABS_Z, ABS_RZ, BTN_SOUTH, SYN_REPORT };
+
+			for (size_t e = 0; e < 8; ++e)
+			{
+				report[e].type = types[e];
+				report[e].code = codes[e];
+			}
+
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				for (size_t e = 0; e < 6; ++e)
+					report[e].value = static_cast<int32_t>((i * 7919 + e * 104729) % 65536) - 32768;
+
+				report[4].value &= 0xff;
+				report[5].value &= 0xff;
+				report[6].value = static_cast<int32_t>(i & 1);
+
+				if (write(fds[1], report, sizeof(report)) != static_cast<ssize_t>(sizeof(report)))
+					break;
+
+				backend.Update();
+				DoNotOptimize(backend.GetState(Gamepad::Index::ONE));
+			}
+
+			close(fds[1]);
+		});
+
+		// 64 pipe-backed devices, of which the first `active` receive a stick report per iteration.
+		auto driveDevices = [](uint64_t n, size_t active)
+		{
+			constexpr size_t DeviceCount = 64;
+
+			GamepadImpl_Linux backend(false);
+			int writers[DeviceCount];
+
+			for (size_t d = 0; d < DeviceCount; ++d)
+			{
+				int fds[2];
+
+				if (pipe(fds) != 0)
+					return;
+
+				writers[d] = fds[1];
+				backend.AttachDevice(fds[0]);
+			}
+
+			input_event report[2];
+			memset(report, 0, sizeof(report));
+			report[0].type = EV_ABS;
+			report[0].code = ABS_X;
+			report[1].type = EV_SYN;
+			report[1].code = SYN_REPORT;
+
+			Gamepad::DeviceId ids[DeviceCount];
+			Gamepad::State states[DeviceCount];
+
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				report[0].value = static_cast<int32_t>(i & 0x7fff);
+
+				for (size_t d = 0; d < active; ++d)
+				{
+					if (write(writers[d], report, sizeof(report)) != static_cast<ssize_t>(sizeof(report)))
+						return;
+				}
+
+				backend.Update();
+				DoNotOptimize(backend.GetDevices(ids, states, DeviceCount));
+			}
+
+			for (int writer : writers)
+				close(writer);
+		};
+
+		Register("devices/64_idle", 1, [driveDevices](uint64_t n) { driveDevices(n, 0); });
+		Register("devices/64_4_active", 4, [driveDevices](uint64_t n) { driveDevices(n, 4); });
+		Register("devices/64_all_active", 64, [driveDevices](uint64_t n) { driveDevices(n, 64); });
+#endif
+
+		// A long history of one pad's states, read back once per iteration: stored decoded, and stored raw and decoded on demand.
+		constexpr size_t HistoryCount = 65536;
+		static const double StateBytes = sizeof(Gamepad::State);
+		static const double RawBytes = sizeof(Gamepad::RawState);
+
+		auto rawHistory = std::make_shared<std::vector<Gamepad::RawState>>(HistoryCount);
+		auto stateHistory = std::make_shared<std::vector<Gamepad::State>>(HistoryCount);
+
+		for (size_t i = 0; i < HistoryCount; ++i)
+		{
+			Gamepad::RawState& raw = (*rawHistory)[i];
+			raw.thumbLX = static_cast<int16_t>((i * 7919) % 65536 - 32768);
+			raw.thumbLY = static_cast<int16_t>((i * 104729) % 65536 - 32768);
+			raw.leftTrigger = static_cast<uint8_t>(i);
+			raw.buttons = static_cast<uint16_t>(i & 0xf3ff);
+
+			GamepadResponse::XInput().Decode(raw, (*stateHistory)[i]);
+		}
+
+		Register("history/scan_65536_states", HistoryCount, [stateHistory](uint64_t n)
+		{
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				float sum = 0.0f;
+
+				for (const Gamepad::State& state : *stateHistory)
+					sum += state.leftStick[0] + state.leftTrigger;
+
+				DoNotOptimize(sum);
+			}
+		}, &StateBytes);
+
+		Register("history/scan_65536_raw_states", HistoryCount, [rawHistory](uint64_t n)
+		{
+			const GamepadResponse& response = GamepadResponse::XInput();
+
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				float sum = 0.0f;
+
+				for (const Gamepad::RawState& raw : *rawHistory)
+					sum += response.leftStick.X(raw.thumbLX) + response.leftTrigger(raw.leftTrigger);
+
+				DoNotOptimize(sum);
+			}
+		}, &RawBytes);
+	}
+
+	////////////////////////////////////////////////////////////
+	// Combos
+	////////////////////////////////////////////////////////////
+
+	/// <summary>Records a seeded session of a fighting-game player at 1 kHz: motions, dashes, charges and presses, with only the changes kept, as in a replay file.</summary>
+	std::vector<Replay::Record> RecordSession(size_t moves, unsigned seed)
+	{
+		static const uint8_t Motions[][4] =
+		{
+			{ 2, 3, 6, 0 }, { 6, 2, 3, 0 }, { 2, 1, 4, 0 }, { 6, 5, 6, 0 }, { 4, 5, 4, 0 }, { 4, 6, 0, 0 }, { 8, 0, 0, 0 }, { 5, 0, 0, 0 }
+		};
+
+		static const uint16_t Presses[] =
+		{
+			static_cast<uint16_t>(Gamepad::Button::A), static_cast<uint16_t>(Gamepad::Button::B), static_cast<uint16_t>(Gamepad::Button::X),
+			static_cast<uint16_t>(Gamepad::Button::Y), static_cast<uint16_t>(Gamepad::Button::X) | static_cast<uint16_t>(Gamepad::Button::A)
+		};
+
+		std::mt19937 rng(seed);
+		std::vector<Replay::Record> records;
+		uint64_t time = 0;
+		Gamepad::State state = {};
+		state.connected = true;
+
+		auto sample = [&](uint64_t delay)
+		{
+			time += delay * 1000000;
+			Replay::Record record;
+			Replay::Encode(state, Gamepad::Index::ONE, time, record);
+			records.push_back(record);
+		};
+
+		for (size_t m = 0; m < moves; ++m)
+		{
+			const uint8_t* motion = Motions[rng() % (sizeof(Motions) / sizeof(Motions[0]))];
+
+			for (size_t k = 0; k < 4 && motion[k] != 0; ++k)
+			{
+				state.leftStick = Vector2f(static_cast<float>((motion[k] - 1) % 3 - 1), static_cast<float>((motion[k] - 1) / 3 - 1));
+				sample(8 + rng() % 40);
+			}
+
+			state.buttons = Presses[rng() % (sizeof(Presses) / sizeof(Presses[0]))];
+			sample(5 + rng() % 30);
+			state.buttons = 0;
+			sample(30 + rng() % 60);
+			state.leftStick = Vector2f(0.0f, 0.0f);
+			sample(20 + rng() % 300);
+		}
+
+		return records;
+	}
+
+	/// <summary>Makes the classic motions plus random 2 to 6 step patterns, so most of them share prefixes like real move lists.</summary>
+	void AddPatterns(ComboRecognizer& recognizer, size_t count, unsigned seed)
+	{
+		constexpr uint64_t Frame = 16666667;
+
+		const ComboStep classics[][4] =
+		{
+			{ ComboStep::Direction(2), ComboStep::Direction(3, 8 * Frame), ComboStep::Direction(6, 8 * Frame), ComboStep::Press(Gamepad::Button::X, 8 * Frame) },
+			{ ComboStep::Direction(6), ComboStep::Direction(2, 8 * Frame), ComboStep::Direction(3, 8 * Frame), ComboStep::Press(Gamepad::Button::X, 8 * Frame) },
+			{ ComboStep::Direction(4, 0, 30 * Frame), ComboStep::Direction(5, 60 * Frame), ComboStep::Direction(6, 8 * Frame), ComboStep::Press(Gamepad::Button::A, 8 * Frame) },
+			{ ComboStep::Direction(6), ComboStep::Direction(5, 10 * Frame), ComboStep::Direction(6, 10 * Frame), ComboStep::Chord(static_cast<uint16_t>(Gamepad::Button::X) | static_cast<uint16_t>(Gamepad::Button::A), 10 * Frame) }
+		};
+
+		for (const auto& classic : classics)
+			recognizer.AddPattern("classic", std::vector<ComboStep>(classic, classic + 4));
+
+		std::mt19937 rng(seed);
+
+		for (size_t p = recognizer.PatternCount(); p < count; ++p)
+		{
+			std::vector<ComboStep> steps;
+			size_t length = 2 + rng() % 5;
+
+			for (size_t k = 0; k + 1 < length; ++k)
+				steps.push_back(ComboStep::Direction(static_cast<uint8_t>(1 + rng() % 9), 10 * Frame));
+
+			steps.push_back(ComboStep::Press(AllButtons[10 + rng() % 4], 10 * Frame));
+			recognizer.AddPattern("random", steps);
+		}
+	}
+
+	void RegisterCombos()
+	{
+		static std::vector<Replay::Record> session = RecordSession(2000, 7);
+
+		// The same recorded session against a handful and against thousands of patterns: the cost per sample should barely move.
+		for (size_t patterns : { size_t(16), size_t(4096) })
+		{
+			// Compiling thousands of patterns takes longer than a run, so it is done once, outside the timing.
+			auto recognizer = std::make_shared<ComboRecognizer>();
+			AddPatterns(*recognizer, patterns, 11);
+			recognizer->Compile();
+
+			Register("combo/advance_" + std::to_string(patterns) + "_patterns", session.size(), [recognizer](uint64_t n)
+			{
+				ComboRecognizer::Match matches[64];
+				ComboRecognizer::Cursor cursor;
+				Gamepad::State state = {};
+
+				for (uint64_t i = 0; i < n; ++i)
+				{
+					ComboRecognizer::Reset(cursor);
+					size_t found = 0;
+
+					for (const Replay::Record& record : session)
+					{
+						Replay::Decode(record, state);
+						state.timestamp = record.timestamp;
+						found += recognizer->Advance(cursor, state, matches, 64);
+					}
+
+					DoNotOptimize(found);
+				}
+			});
+		}
+	}
+
+	////////////////////////////////////////////////////////////
+	// History
+	////////////////////////////////////////////////////////////
+
+	void RegisterHistory()
+	{
+		static std::vector<Replay::Record> session = RecordSession(2000, 7);
+		static std::vector<Gamepad::RawState> packed;
+		constexpr uint64_t Millisecond = 1000000;
+
+		// Records hold states packed the way Gamepad::PackedState is.
+		for (const Replay::Record& record : session)
+			packed.push_back(record.state);
+
+		Register("history/push_session", session.size(), [](uint64_t n)
+		{
+			GamepadHistory history(1024);
+
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				history.Clear();
+
+				for (size_t k = 0; k < session.size(); ++k)
+					history.Push(packed[k], true, session[k].timestamp);
+
+				DoNotOptimize(history.Count());
+			}
+		});
+
+		// Every question a frame might ask of every button, against a full history.
+		Register("history/queries_14_buttons", ButtonCount * 4, [](uint64_t n)
+		{
+			GamepadHistory history(1024);
+
+			for (size_t k = 0; k < session.size(); ++k)
+				history.Push(packed[k], true, session[k].timestamp);
+
+			uint64_t now = session.back().timestamp;
+			Gamepad::State state;
+
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				size_t answers = 0;
+
+				for (Gamepad::Button button : AllButtons)
+				{
+					answers += history.WasPressedWithin(button, 120 * Millisecond, now);
+					answers += static_cast<size_t>(history.HeldDuration(button, now) > 0);
+					answers += history.PressCount(button, 250 * Millisecond, now);
+					answers += history.StateAt(now - (i & 1023) * Millisecond, state);
+				}
+
+				DoNotOptimize(answers);
+			}
+		});
+	}
+
+	////////////////////////////////////////////////////////////
+	// Late latch
+	////////////////////////////////////////////////////////////
+
+	/// <summary>What a renderer might latch: a camera's yaw and pitch rates from the right stick, stamped with their sample.</summary>
+	struct CameraSlot
+	{
+		float yaw;
+		float pitch;
+		uint64_t timestamp;
+	};
+
+	void LatchCamera(Gamepad::Index, const Gamepad::State& state, void* slot, void* context)
+	{
+		CameraSlot& camera = *static_cast<CameraSlot*>(slot);
+		float rate = *static_cast<const float*>(context);
+
+		camera.yaw = state.rightStick[0] * rate;
+		camera.pitch = state.rightStick[1] * rate;
+		camera.timestamp = state.timestamp;
+	}
+
+	void RegisterLateLatch()
+	{
+		static float rate = 3.0f;
+
+		Register("latch/fill_4_slots", 4, [](uint64_t n)
+		{
+			LateLatch latch;
+			CameraSlot slots[4] = {};
+			Gamepad::State states[Gamepad::IndexCount] = {};
+
+			for (size_t i = 0; i < 4; ++i)
+				latch.Register(static_cast<Gamepad::Index>(i), &LatchCamera, &slots[i], &rate);
+
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				states[0].rightStick[0] = float(i & 255) / 255.0f;
+				DoNotOptimize(latch.Fill(states));
+				DoNotOptimize(slots[0].yaw);
+			}
+		});
+
+		// The whole call a renderer makes before submitting, against a sampler running at 1 kHz.
+		Register("latch/sampled_1_slot", 1, [](uint64_t n)
+		{
+			CameraSlot camera = {};
+			uint32_t handle = Gamepad::RegisterLatch(Gamepad::Index::ONE, &LatchCamera, &camera, &rate);
+			Gamepad::StartSampling(std::chrono::microseconds(1000));
+
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				DoNotOptimize(Gamepad::Latch());
+				DoNotOptimize(camera.yaw);
+			}
+
+			Gamepad::StopSampling();
+			Gamepad::UnregisterLatch(handle);
+		});
+	}
+
+	////////////////////////////////////////////////////////////
+	// Remote
+	////////////////////////////////////////////////////////////
+
+	/// <summary>Resamples recorded sessions into 60 Hz ticks of four pads, each pad playing the session from a different point.</summary>
+	std::vector<Gamepad::State> RecordTicks(const std::vector<Replay::Record>& session, size_t ticks)
+	{
+		constexpr uint64_t Tick = 16666667;
+
+		std::vector<Gamepad::State> states(ticks * Gamepad::IndexCount);
+		uint64_t duration = session.back().timestamp;
+
+		for (size_t p = 0; p < Gamepad::IndexCount; ++p)
+		{
+			size_t cursor = 0;
+			uint64_t offset = duration / Gamepad::IndexCount * p;
+			Gamepad::State state = {};
+
+			for (size_t t = 0; t < ticks; ++t)
+			{
+				uint64_t time = (offset + t * Tick) % duration;
+
+				if (cursor > 0 && session[cursor - 1].timestamp > time)
+					cursor = 0;
+
+				while (cursor < session.size() && session[cursor].timestamp <= time)
+					Replay::Decode(session[cursor++], state);
+
+				states[t * Gamepad::IndexCount + p] = state;
+			}
+		}
+
+		return states;
+	}
+
+	void RegisterRemote()
+	{
+		constexpr size_t Ticks = 3600;
+
+		static std::vector<Gamepad::State> ticks = RecordTicks(RecordSession(2000, 7), Ticks);
+
+		// The receiver acknowledges after `lag` ticks: 1 is a LAN, 6 is about 100 ms of round trip, so datagrams carry 6 frames.
+		for (uint32_t lag : { 1u, 6u })
+		{
+			static double bytes[2];
+			double* bytesPerFrame = &bytes[lag == 1 ? 0 : 1];
+
+			Register("remote/encode_4pads_ack_lag_" + std::to_string(lag), Ticks, [lag, bytesPerFrame](uint64_t n)
+			{
+				RemoteSender sender;
+				uint8_t buffer[Remote::MaxDatagram];
+				uint64_t total = 0;
+
+				for (uint64_t i = 0; i < n; ++i)
+				{
+					for (size_t t = 0; t < Ticks; ++t)
+					{
+						uint32_t frame = sender.Push(&ticks[t * Gamepad::IndexCount], Gamepad::IndexCount);
+						total += sender.Encode(buffer, sizeof(buffer));
+
+						if (frame > lag)
+							sender.Acknowledge(frame - lag);
+					}
+
+					DoNotOptimize(buffer);
+				}
+
+				*bytesPerFrame = double(total) / double(n * Ticks);
+			}, bytesPerFrame);
+
+			Register("remote/decode_4pads_ack_lag_" + std::to_string(lag), Ticks, [lag](uint64_t n)
+			{
+				// Encode once up front so only decoding is timed.
+				RemoteSender sender;
+				std::vector<std::vector<uint8_t>> datagrams;
+
+				for (size_t t = 0; t < Ticks; ++t)
+				{
+					uint32_t frame = sender.Push(&ticks[t * Gamepad::IndexCount], Gamepad::IndexCount);
+					uint8_t buffer[Remote::MaxDatagram];
+					datagrams.emplace_back(buffer, buffer + sender.Encode(buffer, sizeof(buffer)));
+
+					if (frame > lag)
+						sender.Acknowledge(frame - lag);
+				}
+
+				for (uint64_t i = 0; i < n; ++i)
+				{
+					RemoteReceiver receiver;
+
+					for (const std::vector<uint8_t>& datagram : datagrams)
+						receiver.Decode(datagram.data(), datagram.size());
+
+					DoNotOptimize(receiver.GetState(Gamepad::Index::ONE));
+				}
+			});
+		}
+
+		static double rawBytes = sizeof(Gamepad::State) * Gamepad::IndexCount;
+
+		Register("remote/copy_4pads_raw_struct", Ticks, [](uint64_t n)
+		{
+			std::vector<uint8_t> buffer(sizeof(Gamepad::State) * Gamepad::IndexCount);
+
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				for (size_t t = 0; t < Ticks; ++t)
+				{
+					memcpy(buffer.data(), &ticks[t * Gamepad::IndexCount], buffer.size());
+					DoNotOptimize(buffer.data());
+				}
+			}
+		}, &rawBytes);
+	}
+
+	////////////////////////////////////////////////////////////
+	// VectorN
+	////////////////////////////////////////////////////////////
+
+	constexpr size_t VectorCount = 1024;
+
+	template <typename V, size_t S>
+	std::vector<V> RandomVectors(size_t count, unsigned seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> distribution(0.1f, 1.0f);
+		std::vector<V> values(count);
+
+		for (V& value : values)
+		{
+			for (size_t c = 0; c < S; ++c)
+				value[c] = distribution(rng);
+		}
+
+		return values;
+	}
+
+	/// <summary>Registers a benchmark that applies <paramref name='op'/> to <c>VectorCount</c> pairs of vectors per iteration.</summary>
+	template <typename V, size_t S, typename F>
+	void VectorCase(const std::string& type, const char* op, F func)
+	{
+		Register("vector/" + type + "/" + op, VectorCount, [func](uint64_t n)
+		{
+			std::vector<V> a = RandomVectors<V, S>(VectorCount, 1);
+			std::vector<V> b = RandomVectors<V, S>(VectorCount, 2);
+			std::vector<V> out(VectorCount);
+
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				for (size_t v = 0; v < VectorCount; ++v)
+					func(a[v], b[v], out[v]);
+
+				DoNotOptimize(out.data());
+			}
+		});
+	}
+
+	template <typename V, typename T, size_t S>
+	void RegisterVector(const std::string& type)
+	{
+		VectorCase<V, S>(type, "add", [](const V& a, const V& b, V& out) { out = a + b; });
+		VectorCase<V, S>(type, "subtract", [](const V& a, const V& b, V& out) { out = a - b; });
+		VectorCase<V, S>(type, "multiply", [](const V& a, const V& b, V& out) { out = a * b; });
+		VectorCase<V, S>(type, "divide", [](const V& a, const V& b, V& out) { out = a / b; });
+		VectorCase<V, S>(type, "multiply_scalar", [](const V& a, const V&, V& out) { out = a * T(1.5); });
+		VectorCase<V, S>(type, "divide_scalar", [](const V& a, const V&, V& out) { out = a / T(1.5); });
+		VectorCase<V, S>(type, "negate", [](const V& a, const V&, V& out) { out = -a; });
+		VectorCase<V, S>(type, "fused_expression", [](const V& a, const V& b, V& out) { out = (a + b) * T(0.5) - a * b; });
+		VectorCase<V, S>(type, "add_assign", [](const V&, const V& b, V& out) { out += b; });
+		VectorCase<V, S>(type, "subtract_assign", [](const V&, const V& b, V& out) { out -= b; });
+		VectorCase<V, S>(type, "multiply_assign", [](const V& a, const V&, V& out) { out = a; out *= a; });
+		VectorCase<V, S>(type, "divide_assign", [](const V& a, const V& b, V& out) { out = a; out /= b; });
+		VectorCase<V, S>(type, "multiply_assign_scalar", [](const V& a, const V&, V& out) { out = a; out *= T(1.5); });
+		VectorCase<V, S>(type, "divide_assign_scalar", [](const V& a, const V&, V& out) { out = a; out /= T(1.5); });
+		VectorCase<V, S>(type, "equal", [](const V& a, const V& b, V& out) { out[0] = T(a == b); });
+		VectorCase<V, S>(type, "not_equal", [](const V& a, const V& b, V& out) { out[0] = T(a != b); });
+		VectorCase<V, S>(type, "dot", [](const V& a, const V& b, V& out) { out[0] = Vector::Dot(a, b); });
+		VectorCase<V, S>(type, "length_squared", [](const V& a, const V&, V& out) { out[0] = a.LengthSquared(); });
+		VectorCase<V, S>(type, "length", [](const V& a, const V&, V& out) { out[0] = a.Length(); });
+		VectorCase<V, S>(type, "length_fast", [](const V& a, const V&, V& out) { out[0] = a.LengthFast(); });
+		VectorCase<V, S>(type, "normalize", [](const V& a, const V&, V& out) { out = a; out.Normalize(); });
+		VectorCase<V, S>(type, "normalize_fast", [](const V& a, const V&, V& out) { out = a; out.NormalizeFast(); });
+		VectorCase<V, S>(type, "reflect", [](const V& a, const V& b, V& out) { out = Vector::Reflect(a, b); });
+		VectorCase<V, S>(type, "refract", [](const V& a, const V& b, V& out) { out = Vector::Refract(a, b, T(0.75)); });
+		VectorCase<V, S>(type, "min", [](const V& a, const V& b, V& out) { out = Vector::Min(a, b); });
+		VectorCase<V, S>(type, "max", [](const V& a, const V& b, V& out) { out = Vector::Max(a, b); });
+
+		if constexpr (S == 3)
+			VectorCase<V, S>(type, "cross", [](const V& a, const V& b, V& out) { out = Vector::Cross(a, b); });
+	}
+
+	////////////////////////////////////////////////////////////
+	// VectorArray
+	////////////////////////////////////////////////////////////
+
+	constexpr size_t ArrayCount = 1 << 16;
+
+	void RegisterVectorArray()
+	{
+		static std::vector<Vector3f> aos = RandomVectors<Vector3f, 3>(ArrayCount, 3);
+		static std::vector<Vector3f> aosNormals = RandomVectors<Vector3f, 3>(ArrayCount, 4);
+		static VectorArray3f soa, soaNormals, soaOut;
+		static std::vector<float> scalars(ArrayCount);
+
+		for (size_t i = 0; i < ArrayCount; ++i)
+		{
+			soa.PushBack(aos[i]);
+			soaNormals.PushBack(aosNormals[i]);
+		}
+
+		Register("vector_array/3f/length_aos", ArrayCount, [](uint64_t n)
+		{
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				for (size_t v = 0; v < ArrayCount; ++v)
+					scalars[v] = aos[v].Length();
+
+				DoNotOptimize(scalars.data());
+			}
+		});
+
+		Register("vector_array/3f/dot_aos", ArrayCount, [](uint64_t n)
+		{
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				for (size_t v = 0; v < ArrayCount; ++v)
+					scalars[v] = Vector::Dot(aos[v], aosNormals[v]);
+
+				DoNotOptimize(scalars.data());
+			}
+		});
+
+		Register("vector_array/3f/reflect_aos", ArrayCount, [](uint64_t n)
+		{
+			std::vector<Vector3f> out(ArrayCount);
+
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				for (size_t v = 0; v < ArrayCount; ++v)
+					out[v] = Vector::Reflect(aos[v], aosNormals[v]);
+
+				DoNotOptimize(out.data());
+			}
+		});
+
+		Register("vector_array/3f/normalize_aos", ArrayCount, [](uint64_t n)
+		{
+			std::vector<Vector3f> work(ArrayCount);
+
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				std::copy(aos.begin(), aos.end(), work.begin());
+
+				for (Vector3f& v : work)
+					v.Normalize();
+
+				DoNotOptimize(work.data());
+			}
+		});
+
+		for (size_t threads : { size_t(1), size_t(0) })
+		{
+			std::string suffix = threads == 1 ? "_soa" : "_soa_threaded";
+
+			Register("vector_array/3f/length" + suffix, ArrayCount, [threads](uint64_t n)
+			{
+				for (uint64_t i = 0; i < n; ++i)
+				{
+					Vector::Length(soa, scalars.data(), threads);
+					DoNotOptimize(scalars.data());
+				}
+			});
+
+			Register("vector_array/3f/dot" + suffix, ArrayCount, [threads](uint64_t n)
+			{
+				for (uint64_t i = 0; i < n; ++i)
+				{
+					Vector::Dot(soa, soaNormals, scalars.data(), threads);
+					DoNotOptimize(scalars.data());
+				}
+			});
+
+			Register("vector_array/3f/reflect" + suffix, ArrayCount, [threads](uint64_t n)
+			{
+				for (uint64_t i = 0; i < n; ++i)
+				{
+					Vector::Reflect(soa, soaNormals, soaOut, threads);
+					DoNotOptimize(soaOut.Component(0));
+				}
+			});
+
+			Register("vector_array/3f/min" + suffix, ArrayCount, [threads](uint64_t n)
+			{
+				for (uint64_t i = 0; i < n; ++i)
+				{
+					Vector::Min(soa, soaNormals, soaOut, threads);
+					DoNotOptimize(soaOut.Component(0));
+				}
+			});
+
+			Register("vector_array/3f/max" + suffix, ArrayCount, [threads](uint64_t n)
+			{
+				for (uint64_t i = 0; i < n; ++i)
+				{
+					Vector::Max(soa, soaNormals, soaOut, threads);
+					DoNotOptimize(soaOut.Component(0));
+				}
+			});
+
+			Register("vector_array/3f/normalize" + suffix, ArrayCount, [threads](uint64_t n)
+			{
+				for (uint64_t i = 0; i < n; ++i)
+				{
+					soaOut = soa;
+					Vector::Normalize(soaOut, threads);
+					DoNotOptimize(soaOut.Component(0));
+				}
+			});
+		}
+	}
+
+	void PrintUsage(const char* program)
+	{
+		fprintf(stderr,
+			"usage: %s [--filter SUBSTRING] [--json FILE] [--min-time SECONDS] [--repetitions N] [--list]\n"
+			"Runs the input and math benchmarks and writes the results as JSON (to stdout unless --json is given).\n", program);
+	}
+
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+
+		if (arg == "--filter" && i + 1 < argc)
+			options.filter = argv[++i];
+		else if (arg == "--json" && i + 1 < argc)
+			options.output = argv[++i];
+		else if (arg == "--min-time" && i + 1 < argc)
+			options.minTime = std::atof(argv[++i]);
+		else if (arg == "--repetitions" && i + 1 < argc)
+			options.repetitions = std::max(1, std::atoi(argv[++i]));
+		else if (arg == "--list")
+			options.list = true;
+		else
+		{
+			PrintUsage(argv[0]);
+			return arg == "--help" || arg == "-h" ? 0 : 1;
+		}
+	}
+
+	GamepadImpl_Mock mock;
+	mock.SetGenerator(Wander);
+	mock.Update();
+	IGamepadImpl::SetInstance(&mock);
+
+	RegisterGamepad(mock);
+	RegisterParse();
+	RegisterCombos();
+	RegisterHistory();
+	RegisterLateLatch();
+	RegisterRemote();
+	RegisterVector<Vector2f, float, 2>("2f");
+	RegisterVector<Vector3f, float, 3>("3f");
+	RegisterVector<Vector4f, float, 4>("4f");
+	RegisterVectorArray();
+
+	std::vector<Result> results;
+
+	for (const Case& c : Cases())
+	{
+		if (!options.filter.empty() && c.name.find(options.filter) == std::string::npos)
+			continue;
+
+		if (options.list)
+		{
+			printf("%s\n", c.name.c_str());
+			continue;
+		}
+
+		results.push_back(Measure(c, options));
+		if (results.back().bytesPerItem >= 0.0)
+			fprintf(stderr, "%-48s %12.3f ns/item %10.2f bytes/item\n", c.name.c_str(), results.back().nsPerItem, results.back().bytesPerItem);
+		else
+			fprintf(stderr, "%-48s %12.3f ns/item\n", c.name.c_str(), results.back().nsPerItem);
+	}
+
+	if (!options.list)
+	{
+		FILE* file = options.output.empty() ? stdout : fopen(options.output.c_str(), "w");
+
+		if (file == nullptr)
+		{
+			fprintf(stderr, "cannot open %s\n", options.output.c_str());
+			return 1;
+		}
+
+		WriteJson(file, results);
+
+		if (file != stdout)
+			fclose(file);
+	}
+
+	IGamepadImpl::SetInstance(nullptr);
+
+	return 0;
+}
@@ -0,0 +1,46 @@
+#ifndef DECAF_CONCURRENT_PARALLELFOR_HH_
+#define DECAF_CONCURRENT_PARALLELFOR_HH_
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace decaf
+{
+
+	/// <summary>Splits <c>[0, count)</c> into contiguous ranges and calls <paramref name='func'/>(begin, end) for each of them.</summary>
+	/// <param name='threads'>The number of ranges to run concurrently. <c>0</c> uses one per hardware thread; <c>1</c> runs inline.</param>
+	/// <param name='minChunk'>The smallest range worth handing to another thread.</param>
+	/// <remarks>The calling thread processes the first range itself, and the call returns once every range is done.</remarks>
+	template <typename F>
+	inline void ParallelFor(size_t count, size_t threads, size_t minChunk, F&& func)
+	{
+		if (threads == 0)
+			threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+		threads = std::min(threads, std::max<size_t>(count / std::max<size_t>(minChunk, 1), 1));
+
+		if (threads <= 1)
+		{
+			func(size_t(0), count);
+			return;
+		}
+
+		std::vector<std::thread> workers;
+		workers.reserve(threads - 1);
+
+		size_t chunk = (count + threads - 1) / threads;
+
+		for (size_t begin = chunk; begin < count; begin += chunk)
+			workers.emplace_back([&func, begin, chunk, count] { func(begin, std::min(begin + chunk, count)); });
+
+		func(size_t(0), std::min(chunk, count));
+
+		for (auto& worker : workers)
+			worker.join();
+	}
+
+}
+
+#endif
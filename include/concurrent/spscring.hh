@@ -0,0 +1,94 @@
+#ifndef DECAF_CONCURRENT_SPSCRING_HH_
+#define DECAF_CONCURRENT_SPSCRING_HH_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace decaf
+{
+
+	/// <summary>A fixed-capacity, lock-free single-producer/single-consumer ring buffer.</summary>
+	/// <remarks>Entries stay in place until the consumer releases them, so the consumer can read a published range without copying it out.</remarks>
+	template <typename T, size_t Capacity>
+	class SpscRing
+	{
+
+		static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+
+	public:
+
+		SpscRing()
+			: m_head{ 0 }, m_cachedTail{ 0 }, m_tail{ 0 } { }
+
+		SpscRing(const SpscRing&) = delete;
+		SpscRing& operator=(const SpscRing&) = delete;
+
+		/// <summary>Appends an entry. Producer only.</summary>
+		/// <returns><c>false</c> if the ring is full and the entry was dropped.</returns>
+		inline bool TryPush(const T& value)
+		{
+			size_t head = m_head.load(std::memory_order_relaxed);
+
+			if (head - m_cachedTail == Capacity)
+			{
+				m_cachedTail = m_tail.load(std::memory_order_acquire);
+
+				if (head - m_cachedTail == Capacity)
+					return false;
+			}
+
+			m_entries[head & Mask] = value;
+			m_head.store(head + 1, std::memory_order_release);
+
+			return true;
+		}
+
+		/// <summary>Gets the number of entries published and not yet released. Consumer only.</summary>
+		inline size_t Available()
+		{
+			return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_relaxed);
+		}
+
+		/// <summary>Gets the <paramref name='i'/>-th unreleased entry, counted from the oldest. Consumer only.</summary>
+		inline const T& Peek(size_t i) const
+		{
+			return m_entries[(m_tail.load(std::memory_order_relaxed) + i) & Mask];
+		}
+
+		/// <summary>Hands the <paramref name='count'/> oldest entries back to the producer. Consumer only.</summary>
+		inline void Release(size_t count)
+		{
+			m_tail.store(m_tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+		}
+
+		/// <summary>Copies up to <paramref name='max'/> entries into <paramref name='out'/> and releases them. Consumer only.</summary>
+		/// <returns>The number of entries copied.</returns>
+		inline size_t Pop(T* out, size_t max)
+		{
+			size_t count = std::min(Available(), max);
+
+			for (size_t i = 0; i < count; ++i)
+				out[i] = Peek(i);
+
+			Release(count);
+			return count;
+		}
+
+	private:
+
+		static constexpr size_t Mask = Capacity - 1;
+
+		std::array<T, Capacity> m_entries;
+
+		alignas(64) std::atomic<size_t> m_head;
+		size_t m_cachedTail;
+
+		alignas(64) std::atomic<size_t> m_tail;
+
+	};
+
+}
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef DECAF_CONCURRENT_TRIPLEBUFFER_HH_
+#define DECAF_CONCURRENT_TRIPLEBUFFER_HH_
+
+#include <atomic>
+#include <cstdint>
+
+namespace decaf
+{
+
+	/// <summary>A wait-free single-producer/single-consumer buffer that always hands the consumer the newest complete value.</summary>
+	/// <remarks>The producer fills <c>WriteBuffer</c> and calls <c>Publish</c>; the consumer calls <c>Acquire</c> and reads <c>ReadBuffer</c>.
+	/// Both sides only ever exchange buffer indices, so neither side can observe a value that is still being written.</remarks>
+	template <typename T>
+	class TripleBuffer
+	{
+
+	public:
+
+		TripleBuffer()
+			: m_buffers{}, m_middle{ 1 }, m_back{ 2 }, m_front{ 0 } { }
+
+		TripleBuffer(const TripleBuffer&) = delete;
+		TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+		/// <summary>Gets the buffer the producer may write to.</summary>
+		inline T& WriteBuffer()
+		{
+			return m_buffers[m_back];
+		}
+
+		/// <summary>Makes the contents of <c>WriteBuffer</c> visible to the consumer.</summary>
+		inline void Publish()
+		{
+			uint8_t previous = m_middle.exchange(static_cast<uint8_t>(m_back | Dirty), std::memory_order_acq_rel);
+			m_back = static_cast<uint8_t>(previous & IndexMask);
+		}
+
+		/// <summary>Swaps the newest published value into <c>ReadBuffer</c>.</summary>
+		/// <returns><c>true</c> if a value was published since the last call.</returns>
+		inline bool Acquire()
+		{
+			if ((m_middle.load(std::memory_order_relaxed) & Dirty) == 0)
+				return false;
+
+			uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+			m_front = static_cast<uint8_t>(previous & IndexMask);
+
+			return true;
+		}
+
+		/// <summary>Gets the buffer the consumer may read from.</summary>
+		inline const T& ReadBuffer() const
+		{
+			return m_buffers[m_front];
+		}
+
+	private:
+
+		static constexpr uint8_t IndexMask = 0x3;
+		static constexpr uint8_t Dirty = 0x4;
+
+		T m_buffers[3];
+
+		alignas(64) std::atomic<uint8_t> m_middle;
+		alignas(64) uint8_t m_back;
+		alignas(64) uint8_t m_front;
+
+	};
+
+}
+
+#endif
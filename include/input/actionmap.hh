@@ -0,0 +1,173 @@
+#ifndef DECAF_INPUT_ACTIONMAP_HH_
+#define DECAF_INPUT_ACTIONMAP_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "decaf/input/gamepad.hh"
+
+namespace decaf
+{
+
+	/// <summary>One way of triggering an action: a button chord, optionally with an axis past a threshold and modifiers held or excluded.</summary>
+	struct ActionBinding
+	{
+		/// <summary>Buttons that must all be down.</summary>
+		uint16_t buttons;
+		/// <summary>Buttons that must be down as well; kept apart from <c>buttons</c> so a layer can list its modifiers.</summary>
+		uint16_t modifiers;
+		/// <summary>Buttons that must all be up, e.g. a modifier that selects a different action.</summary>
+		uint16_t excluded;
+		/// <summary>Whether <c>axis</c> and <c>threshold</c> take part.</summary>
+		bool useAxis;
+		Gamepad::Axis axis;
+		/// <summary>The axis must reach this value: at or above it when positive, at or below it when negative.</summary>
+		float threshold;
+
+		static ActionBinding Button(Gamepad::Button button)
+		{
+			return { static_cast<uint16_t>(button), 0, 0, false, Gamepad::Axis::LSTICK_X, 0.0f };
+		}
+
+		static ActionBinding Chord(uint16_t buttons)
+		{
+			return { buttons, 0, 0, false, Gamepad::Axis::LSTICK_X, 0.0f };
+		}
+
+		static ActionBinding Axis(Gamepad::Axis axis, float threshold)
+		{
+			return { 0, 0, 0, true, axis, threshold };
+		}
+
+		ActionBinding& With(Gamepad::Button modifier) { modifiers |= static_cast<uint16_t>(modifier); return *this; }
+		ActionBinding& Without(Gamepad::Button modifier) { excluded |= static_cast<uint16_t>(modifier); return *this; }
+	};
+
+	/// <summary>The actions that are down, were pressed and were released in one evaluation, as bitsets indexed by action.</summary>
+	class ActionFrame
+	{
+
+	public:
+
+		inline bool IsDown(uint16_t action) const { return Test(m_down, action); }
+		inline bool WasPressed(uint16_t action) const { return Test(m_pressed, action); }
+		inline bool WasReleased(uint16_t action) const { return Test(m_released, action); }
+
+	private:
+
+		friend class ActionMap;
+
+		static inline bool Test(const std::vector<uint64_t>& bits, uint16_t action)
+		{
+			size_t word = action >> 6;
+			return word < bits.size() && ((bits[word] >> (action & 63)) & 1) != 0;
+		}
+
+		std::vector<uint64_t> m_down;
+		std::vector<uint64_t> m_was;
+		std::vector<uint64_t> m_pressed;
+		std::vector<uint64_t> m_released;
+		std::vector<uint64_t> m_shadow;
+
+	};
+
+	/// <summary>Maps named actions to bindings grouped in prioritised context layers, compiled into flat tables.</summary>
+	/// <remarks>Every enabled layer is walked from the highest priority down. A layer that binds an action shadows that action's
+	/// bindings in every layer below it, and an opaque layer hides all lower layers. Each layer compiles its bindings into
+	/// structure-of-arrays masks once, and only again after its own bindings change, so <c>Evaluate</c> resolves every action of a
+	/// pad in one branch-free pass over the current and previous states. Not thread-safe.</remarks>
+	class ActionMap
+	{
+
+	public:
+
+		using ActionId = uint16_t;
+		using LayerId = uint16_t;
+
+		static constexpr ActionId NoAction = std::numeric_limits<ActionId>::max();
+
+	public:
+
+		ActionMap();
+
+		/// <summary>Defines an action, or returns the existing one with the same name.</summary>
+		ActionId DefineAction(const std::string& name);
+
+		/// <summary>Gets an action by name, or <c>NoAction</c>.</summary>
+		ActionId FindAction(const std::string& name) const;
+
+		const std::string& ActionName(ActionId action) const { return m_actions[action]; }
+		size_t ActionCount() const { return m_actions.size(); }
+
+		/// <summary>Adds a disabled layer. Higher priorities are evaluated first; equal priorities go in order of creation.</summary>
+		/// <param name='opaque'>Whether the layer hides every layer below it while enabled, e.g. a pause menu over gameplay.</param>
+		LayerId AddLayer(const std::string& name, int32_t priority, bool opaque = false);
+
+		void EnableLayer(LayerId layer, bool enabled);
+		bool IsLayerEnabled(LayerId layer) const { return m_layers[layer].enabled; }
+
+		/// <summary>Adds a binding for an action to a layer. Only that layer's table is recompiled.</summary>
+		void Bind(LayerId layer, ActionId action, const ActionBinding& binding);
+
+		/// <summary>Removes every binding of an action from a layer. Only that layer's table is recompiled.</summary>
+		void Unbind(LayerId layer, ActionId action);
+
+		/// <summary>Replaces the bindings of an action in a layer with a single one.</summary>
+		void Rebind(LayerId layer, ActionId action, const ActionBinding& binding);
+
+		/// <summary>Resolves every action for one pad.</summary>
+		void Evaluate(const Gamepad::State& current, const Gamepad::State& previous, ActionFrame& frame);
+
+		inline void Evaluate(const Gamepad& pad, ActionFrame& frame)
+		{
+			Evaluate(pad.CurrentState(), pad.PreviousState(), frame);
+		}
+
+		/// <summary>Gets how many times layer tables have been compiled, to check that rebinding stays local.</summary>
+		inline uint64_t CompileCount() const { return m_compiles; }
+
+	private:
+
+		/// <summary>A layer's bindings laid out as parallel arrays, one entry per binding.</summary>
+		struct Table
+		{
+			std::vector<uint16_t> required;
+			std::vector<uint16_t> excluded;
+			std::vector<uint8_t> axis;
+			std::vector<float> scale;
+			std::vector<float> threshold;
+			std::vector<uint16_t> word;
+			std::vector<uint64_t> bit;
+			std::vector<uint64_t> bound;
+		};
+
+		struct Layer
+		{
+			std::string name;
+			int32_t priority;
+			bool opaque;
+			bool enabled;
+			bool dirty;
+			std::vector<std::pair<ActionId, ActionBinding>> bindings;
+			Table table;
+		};
+
+		void Compile(Layer& layer);
+		void SortLayers();
+
+		std::vector<std::string> m_actions;
+		std::unordered_map<std::string, ActionId> m_names;
+		std::vector<Layer> m_layers;
+		std::vector<LayerId> m_order;
+		uint64_t m_compiles;
+
+	};
+
+}
+
+#endif
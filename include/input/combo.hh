@@ -0,0 +1,160 @@
+#ifndef DECAF_INPUT_COMBO_HH_
+#define DECAF_INPUT_COMBO_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "decaf/input/gamepad.hh"
+
+namespace decaf
+{
+
+	/// <summary>One step of a combo: a stick direction or a press of one or more buttons. Times are in nanoseconds.</summary>
+	struct ComboStep
+	{
+		/// <summary>A direction in numpad notation, 1 to 9 with 5 neutral and 8 up, or 0 for a button step.</summary>
+		uint8_t direction;
+		/// <summary>The buttons pressed together by a button step. Chords of up to <c>ComboRecognizer::MaxChord</c> buttons may be pressed in any order.</summary>
+		/// <remarks>The D-pad only ever produces directions, so its buttons are ignored here; a step of nothing but D-pad buttons never matches.</remarks>
+		uint16_t buttons;
+		/// <summary>How long after the previous step started this one must start, or <c>0</c> for no limit. Ignored on the first step.</summary>
+		/// <remarks>The previous step lasts until this one starts, so after a step with a <c>hold</c> the window must be at least that long.</remarks>
+		uint64_t window;
+		/// <summary>How long this step must be held before the next one starts, e.g. for charge motions. Ignored on the last step.</summary>
+		uint64_t hold;
+
+		static ComboStep Direction(uint8_t direction, uint64_t window = 0, uint64_t hold = 0)
+		{
+			return { direction, 0, window, hold };
+		}
+
+		static ComboStep Press(Gamepad::Button button, uint64_t window = 0)
+		{
+			return { 0, static_cast<uint16_t>(button), window, 0 };
+		}
+
+		static ComboStep Chord(uint16_t buttons, uint64_t window = 0)
+		{
+			return { 0, buttons, window, 0 };
+		}
+	};
+
+	/// <summary>Recognizes combos, e.g. quarter-circles, charge motions, double-taps and chords, in a stream of pad states.</summary>
+	/// <remarks>Every sample is reduced to tokens: a direction token when the stick or D-pad changes direction, and one token per newly pressed button.
+	/// All patterns are compiled together into one Aho-Corasick automaton over those tokens, so advancing costs one table lookup per token
+	/// however many patterns are registered; only the patterns whose tokens just matched have their timing windows checked.
+	/// The recognizer itself is read-only once compiled and can be shared, while each stream keeps its own <c>Cursor</c>.</remarks>
+	class ComboRecognizer
+	{
+
+	public:
+
+		using PatternId = uint32_t;
+
+		/// <summary>The most buttons a chord step may have. Chords are compiled as every order of their buttons.</summary>
+		static constexpr size_t MaxChord = 4;
+
+		/// <summary>The most tokens one pattern may compile to.</summary>
+		static constexpr size_t MaxLength = 32;
+
+		/// <summary>A recognized combo: the pattern and the timestamp of the sample that completed it.</summary>
+		struct Match
+		{
+			PatternId pattern;
+			uint64_t timestamp;
+		};
+
+		/// <summary>The progress of one stream of states through the automaton.</summary>
+		struct Cursor
+		{
+			uint32_t node;
+			uint8_t direction;
+			uint16_t buttons;
+			/// <summary>The number of tokens seen so far.</summary>
+			uint64_t tokens;
+			/// <summary>The timestamps of the last <c>MaxLength</c> tokens, indexed by token number.</summary>
+			uint64_t times[MaxLength];
+		};
+
+	public:
+
+		/// <param name='chordWindow'>How close together the presses of a chord must be, in nanoseconds.</param>
+		explicit ComboRecognizer(uint64_t chordWindow = 50000000);
+
+		/// <summary>Registers a pattern. The automaton is rebuilt by the next <c>Compile</c> or <c>Advance</c>.</summary>
+		/// <returns>The pattern's ID, numbered from zero in registration order.</returns>
+		PatternId AddPattern(const std::string& name, const std::vector<ComboStep>& steps);
+
+		const std::string& PatternName(PatternId pattern) const { return m_names[pattern]; }
+		size_t PatternCount() const { return m_names.size(); }
+
+		/// <summary>Gets the number of automaton nodes, for sizing.</summary>
+		size_t NodeCount() const { return m_outputs.size(); }
+
+		/// <summary>Builds the automaton from every registered pattern, if any changed since the last build.</summary>
+		void Compile();
+
+		/// <summary>Starts a cursor at the root, treating the first sample as changes from a neutral, released pad.</summary>
+		static void Reset(Cursor& cursor);
+
+		/// <summary>Feeds one sample to a cursor and writes the combos it completes.</summary>
+		/// <returns>The number of matches, which may exceed <paramref name='capacity'/>; only the first <paramref name='capacity'/> are written.</returns>
+		size_t Advance(Cursor& cursor, const Gamepad::State& state, Match* matches, size_t capacity);
+
+		/// <summary>Feeds the pad's latest polled state to a cursor.</summary>
+		inline size_t Advance(Cursor& cursor, const Gamepad& pad, Match* matches, size_t capacity)
+		{
+			return Advance(cursor, pad.CurrentState(), matches, capacity);
+		}
+
+		/// <summary>Gets the numpad direction of a state: the D-pad if any of it is held, otherwise the left stick.</summary>
+		static uint8_t DirectionOf(const Gamepad::State& state);
+
+	private:
+
+		/// <summary>9 direction tokens followed by one press token per button bit.</summary>
+		static constexpr size_t Symbols = 9 + 16;
+
+		/// <summary>One way a pattern can be spelled in tokens, e.g. one order of a chord.</summary>
+		struct Spelling
+		{
+			PatternId pattern;
+			uint32_t first;
+			uint32_t length;
+		};
+
+		/// <summary>The patterns ending at a node, and the next node down its suffix chain that has some.</summary>
+		struct Output
+		{
+			uint32_t first;
+			uint32_t count;
+			uint32_t next;
+		};
+
+		void Spell(PatternId pattern, const std::vector<ComboStep>& steps, size_t step, std::vector<uint8_t>& symbols, std::vector<uint64_t>& windows, std::vector<uint64_t>& holds);
+		bool Timed(const Spelling& spelling, const Cursor& cursor) const;
+		void Feed(Cursor& cursor, uint8_t symbol, uint64_t timestamp, Match* matches, size_t capacity, size_t& count) const;
+
+		uint64_t m_chordWindow;
+		uint64_t m_maxWindow;
+		bool m_dirty;
+
+		std::vector<std::string> m_names;
+		std::vector<std::vector<ComboStep>> m_patterns;
+
+		std::vector<Spelling> m_spellings;
+		std::vector<uint8_t> m_symbols;
+		std::vector<uint64_t> m_windows;
+		std::vector<uint64_t> m_holds;
+
+		std::vector<uint32_t> m_next;
+		std::vector<Output> m_outputs;
+		std::vector<uint32_t> m_ends;
+
+	};
+
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef DECAF_INPUT_DEADZONE_HH_
+#define DECAF_INPUT_DEADZONE_HH_
+
+#include <cstddef>
+
+#include "decaf/math/vector.hh"
+
+namespace decaf
+{
+
+	/// <summary>Selects how a stick's dead region is shaped and how the live region is rescaled.</summary>
+	struct DeadzoneSettings
+	{
+		enum class Mode
+		{
+			/// <summary>Leave the stick to the pad's response curve (per-axis XInput deadzone by default).</summary>
+			XINPUT,
+			/// <summary>Per-axis deadzone on linear input; the dead region is a cross.</summary>
+			AXIAL,
+			/// <summary>Circular dead region; live values pass through unscaled, and past <c>outer</c> the magnitude is clamped to <c>outer</c>.</summary>
+			/// <remarks>Live magnitudes therefore lie in <c>[inner, outer]</c>; use <c>SCALED_RADIAL</c> for output that reaches full deflection at <c>outer</c>.</remarks>
+			RADIAL,
+			/// <summary>Circular dead region; the magnitude is rescaled from <c>[inner, outer]</c> onto <c>[0, 1]</c>.</summary>
+			SCALED_RADIAL,
+			/// <summary>Scaled radial, with each axis additionally snapped to zero while it is within a slope of <c>inner</c> times the other axis.</summary>
+			HYBRID
+		};
+
+		Mode mode;
+		float inner;
+		float outer;
+	};
+
+	/// <summary>Per-pad input processing applied on top of the backend's response curves.</summary>
+	struct GamepadSettings
+	{
+		DeadzoneSettings leftStick;
+		DeadzoneSettings rightStick;
+	};
+
+	namespace Deadzone
+	{
+
+		/// <summary>Applies a deadzone to a stick value read through a linear response.</summary>
+		/// <remarks>Values inside the dead region are rejected on the squared length, so they never pay for a square root.</remarks>
+		/// <param name='stick'>The linear stick value, each axis in <c>[-1, 1]</c>.</param>
+		/// <param name='settings'>The deadzone to apply. <c>XINPUT</c> returns <paramref name='stick'/> unchanged.</param>
+		/// <returns>The processed stick value.</returns>
+		Vector2f Apply(const Vector2f& stick, const DeadzoneSettings& settings);
+
+		/// <summary>Applies the same deadzone to <paramref name='count'/> stick values in place.</summary>
+		void Apply(Vector2f* sticks, size_t count, const DeadzoneSettings& settings);
+
+		/// <summary>Applies <c>settings[i]</c> to <c>sticks[i]</c> for <paramref name='count'/> stick values in place.</summary>
+		void Apply(Vector2f* sticks, const DeadzoneSettings* settings, size_t count);
+
+	}
+
+}
+
+#endif
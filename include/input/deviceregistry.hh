@@ -0,0 +1,208 @@
+#ifndef DECAF_INPUT_DEVICEREGISTRY_HH_
+#define DECAF_INPUT_DEVICEREGISTRY_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "decaf/input/gamepad.hh"
+
+namespace decaf
+{
+
+	/// <summary>Tracks a runtime-sized set of devices in dense arrays: one <c>Gamepad::RawState</c>, its stamps and one backend record <c>T</c> per active device.</summary>
+	/// <remarks>Devices are addressed either by their dense position, which changes when another device is removed, or by their
+	/// <c>Gamepad::DeviceId</c>, which never does. A device that goes away and comes back with the same hardware key gets its old ID back.
+	/// The first <c>Gamepad::IndexCount</c> devices are also bound to the <c>Gamepad::Index</c> slots; when a bound device is removed,
+	/// the longest-registered unbound device takes its slot.</remarks>
+	template <typename T>
+	class DeviceRegistry
+	{
+
+	public:
+
+		static constexpr size_t NotFound = SIZE_MAX;
+
+	public:
+
+		DeviceRegistry()
+			: m_slots{}, m_nextId{ 1 } { }
+
+		inline size_t Count() const { return m_ids.size(); }
+
+		inline Gamepad::DeviceId Id(size_t i) const { return m_ids[i]; }
+		inline Gamepad::RawState& Raw(size_t i) { return m_raws[i]; }
+		inline const Gamepad::RawState& Raw(size_t i) const { return m_raws[i]; }
+		/// <summary>The packet number of a device's newest reading. See <c>Gamepad::State::packet</c>.</summary>
+		inline uint32_t& Packet(size_t i) { return m_packets[i]; }
+		inline uint32_t Packet(size_t i) const { return m_packets[i]; }
+		/// <summary>When a device's newest reading was acquired. See <c>Gamepad::State::timestamp</c>.</summary>
+		inline uint64_t& Timestamp(size_t i) { return m_timestamps[i]; }
+		inline uint64_t Timestamp(size_t i) const { return m_timestamps[i]; }
+		inline T& Data(size_t i) { return m_data[i]; }
+		inline const T& Data(size_t i) const { return m_data[i]; }
+
+		/// <summary>Gets the IDs of every active device, densely packed.</summary>
+		inline const Gamepad::DeviceId* Ids() const { return m_ids.data(); }
+
+		/// <summary>Gets the newest raw readings of every active device, densely packed in the same order as <c>Ids</c>.</summary>
+		inline const Gamepad::RawState* Raws() const { return m_raws.data(); }
+
+		/// <summary>Gets the dense position of a device, or <c>NotFound</c>.</summary>
+		inline size_t Find(Gamepad::DeviceId id) const
+		{
+			return (id != Gamepad::NoDevice && id < m_dense.size()) ? m_dense[id] : NotFound;
+		}
+
+		/// <summary>Gets the device bound to a slot, or <c>Gamepad::NoDevice</c>.</summary>
+		inline Gamepad::DeviceId Slot(Gamepad::Index index) const { return m_slots[static_cast<size_t>(index)]; }
+
+		/// <summary>Gets the slot a device is bound to, or <c>Gamepad::IndexCount</c> if it has none.</summary>
+		inline size_t SlotOf(Gamepad::DeviceId id) const
+		{
+			for (size_t i = 0; i < Gamepad::IndexCount; ++i)
+			{
+				if (m_slots[i] == id)
+					return i;
+			}
+
+			return Gamepad::IndexCount;
+		}
+
+		/// <summary>Gets a mask of the occupied slots, one bit per <c>Gamepad::Index</c>.</summary>
+		inline uint32_t SlotMask() const
+		{
+			uint32_t mask = 0;
+
+			for (size_t i = 0; i < Gamepad::IndexCount; ++i)
+				mask |= (m_slots[i] != Gamepad::NoDevice ? 1u : 0u) << i;
+
+			return mask;
+		}
+
+		/// <summary>Registers a device, reusing the ID last given to <paramref name='key'/>, and binds it to a free slot if there is one.</summary>
+		/// <param name='key'>Identifies the hardware across reconnections, e.g. its device number. Zero never matches.</param>
+		/// <param name='slot'>The slot to bind to, or <c>Gamepad::IndexCount</c> for the first free one. Must be free if given.</param>
+		/// <returns>The device's ID, or <c>Gamepad::NoDevice</c> if a device with the same key is already active.</returns>
+		Gamepad::DeviceId Add(uint64_t key, T data, size_t slot = Gamepad::IndexCount)
+		{
+			Gamepad::DeviceId id = Gamepad::NoDevice;
+
+			if (key != 0)
+			{
+				auto known = m_known.find(key);
+
+				if (known != m_known.end())
+				{
+					if (Find(known->second) != NotFound)
+						return Gamepad::NoDevice;
+
+					id = known->second;
+				}
+			}
+
+			if (id == Gamepad::NoDevice)
+			{
+				id = m_nextId++;
+
+				if (key != 0)
+					m_known[key] = id;
+			}
+
+			if (m_dense.size() <= id)
+				m_dense.resize(id + 1, NotFound);
+
+			m_dense[id] = m_ids.size();
+			m_ids.push_back(id);
+			m_raws.push_back(Gamepad::RawState());
+			m_packets.push_back(0);
+			m_timestamps.push_back(0);
+			m_data.push_back(std::move(data));
+
+			if (slot == Gamepad::IndexCount)
+			{
+				slot = 0;
+				while (slot < Gamepad::IndexCount && m_slots[slot] != Gamepad::NoDevice)
+					++slot;
+			}
+
+			if (slot < Gamepad::IndexCount)
+				m_slots[slot] = id;
+
+			return id;
+		}
+
+		/// <summary>Unregisters a device. The last device moves into its dense position.</summary>
+		/// <returns>The device promoted into the freed slot, or <c>Gamepad::NoDevice</c>.</returns>
+		Gamepad::DeviceId Remove(Gamepad::DeviceId id)
+		{
+			size_t i = Find(id);
+
+			if (i == NotFound)
+				return Gamepad::NoDevice;
+
+			size_t last = m_ids.size() - 1;
+
+			if (i != last)
+			{
+				m_ids[i] = m_ids[last];
+				m_raws[i] = m_raws[last];
+				m_packets[i] = m_packets[last];
+				m_timestamps[i] = m_timestamps[last];
+				m_data[i] = std::move(m_data[last]);
+				m_dense[m_ids[i]] = i;
+			}
+
+			m_ids.pop_back();
+			m_raws.pop_back();
+			m_packets.pop_back();
+			m_timestamps.pop_back();
+			m_data.pop_back();
+			m_dense[id] = NotFound;
+
+			size_t slot = SlotOf(id);
+
+			if (slot == Gamepad::IndexCount)
+				return Gamepad::NoDevice;
+
+			// IDs are handed out in registration order, so the smallest unbound one has usually waited longest.
+			Gamepad::DeviceId promoted = Gamepad::NoDevice;
+
+			for (Gamepad::DeviceId candidate : m_ids)
+			{
+				if ((promoted == Gamepad::NoDevice || candidate < promoted) && SlotOf(candidate) == Gamepad::IndexCount)
+					promoted = candidate;
+			}
+
+			m_slots[slot] = promoted;
+			return promoted;
+		}
+
+		/// <summary>Clears a slot without removing the device it viewed, which stays reachable by ID.</summary>
+		/// <returns>The device the slot viewed, or <c>Gamepad::NoDevice</c>.</returns>
+		Gamepad::DeviceId Unbind(Gamepad::Index index)
+		{
+			Gamepad::DeviceId id = m_slots[static_cast<size_t>(index)];
+			m_slots[static_cast<size_t>(index)] = Gamepad::NoDevice;
+			return id;
+		}
+
+	private:
+
+		std::vector<Gamepad::DeviceId> m_ids;
+		std::vector<Gamepad::RawState> m_raws;
+		std::vector<uint32_t> m_packets;
+		std::vector<uint64_t> m_timestamps;
+		std::vector<T> m_data;
+		std::vector<size_t> m_dense;
+		std::unordered_map<uint64_t, Gamepad::DeviceId> m_known;
+		Gamepad::DeviceId m_slots[Gamepad::IndexCount];
+		Gamepad::DeviceId m_nextId;
+
+	};
+
+}
+
+#endif
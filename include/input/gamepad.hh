@@ -1,11 +1,23 @@
 #ifndef DECAF_INPUT_GAMEPAD_HH_
 #define DECAF_INPUT_GAMEPAD_HH_
 
-#include "decaf\math\vector.hh"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "decaf/math/vector.hh"
 
 namespace decaf
 {
 
+	struct DeadzoneSettings;
+	struct LatencyStats;
+	struct RumbleEffect;
+	struct GamepadResponse;
+	struct GamepadSettings;
+	struct StickFilterSettings;
+
 	class Gamepad
 	{
 
@@ -19,6 +31,13 @@ namespace decaf
 			FOUR
 		};
 
+		static constexpr size_t IndexCount = 4;
+
+		/// <summary>Identifies a device for the lifetime of the process, across reconnections where the backend can tell. Never <c>NoDevice</c>.</summary>
+		using DeviceId = uint32_t;
+
+		static constexpr DeviceId NoDevice = 0;
+
 		enum class Axis
 		{
 			LSTICK_X,
@@ -47,6 +66,21 @@ namespace decaf
 			Y = 0x8000
 		};
 
+		enum class EventType : uint8_t
+		{
+			BUTTON_DOWN,
+			BUTTON_UP,
+			AXIS_CROSSED
+		};
+
+		struct Event
+		{
+			uint64_t timestamp;
+			uint16_t code;
+			EventType type;
+			int8_t zone;
+		};
+
 		struct State
 		{
 			Vector2f leftStick;
@@ -55,42 +89,216 @@ namespace decaf
 			float rightTrigger;
 			uint16_t buttons;
 			bool connected;
+			/// <summary>The device's packet or report sequence number. Advances whenever the device delivers a new report.</summary>
+			uint32_t packet;
+			/// <summary>When the backend acquired the sample, in nanoseconds on the <c>GamepadEventQueue::Now</c> clock.</summary>
+			uint64_t timestamp;
 		};
 
+		/// <summary>A pad's readings in XInput's native units, the packed form states are stored in: 12 bytes against the 40 of a <c>State</c>.</summary>
+		/// <remarks>Backends keep the newest report of every device in this form and decode it through the pad's <c>GamepadResponse</c>
+		/// only when it is read. Whether the pad is connected, and when the report arrived, are kept alongside it.</remarks>
+		struct RawState
+		{
+			int16_t thumbLX;
+			int16_t thumbLY;
+			int16_t thumbRX;
+			int16_t thumbRY;
+			uint8_t leftTrigger;
+			uint8_t rightTrigger;
+			uint16_t buttons;
+		};
+
+		enum class Latency
+		{
+			/// <summary>From the backend acquiring a sample to the first <c>Poll</c> that returns it. Later polls of the same sample are not counted.</summary>
+			SAMPLE_TO_POLL,
+			/// <summary>From <c>Poll</c> to the matching <c>MarkConsumed</c> call.</summary>
+			POLL_TO_CONSUME
+		};
+
+		/// <summary>Bits of <c>ChangedFields</c>, one per group of inputs.</summary>
+		enum class Field : uint8_t
+		{
+			BUTTONS = 0x01,
+			LEFT_STICK = 0x02,
+			RIGHT_STICK = 0x04,
+			LEFT_TRIGGER = 0x08,
+			RIGHT_TRIGGER = 0x10,
+			CONNECTED = 0x20
+		};
+
+		/// <summary>Derives the value of a late-latched slot from a pad's state and writes it to <paramref name='slot'/>. See <c>Latch</c>.</summary>
+		using LatchFunction = void (*)(Index index, const State& state, void* slot, void* context);
+
 	public:
 
 		static State GetState(Index index);
+
+		/// <summary>Gets a pad's state converted through curves of the caller's own instead of the pad's settings.</summary>
+		/// <remarks>While sampling they convert the sampler's newest reading, which it starts publishing on the first such call, so that call waits up to a
+		/// sampling period. Call them from the game thread, like <c>Poll</c>.</remarks>
 		static State GetState(Index index, float deadzone);
+		static State GetState(Index index, const DeadzoneSettings& deadzone);
+		static uint32_t GetStates(State* states, size_t count);
+		/// <summary>Sets the constant rumble level of a pad under any playing effects. Only a changed mix is submitted, by the next <c>Update</c>, or by the sampler thread while sampling.</summary>
 		static void SetRumble(Index index, float left, float right);
 
+		/// <summary>Starts an enveloped rumble effect on a pad.</summary>
+		/// <returns>A handle for <c>StopRumble</c>, or <c>0</c> if the effect was dropped in favour of higher-priority ones.</returns>
+		static uint32_t PlayRumble(Index index, const RumbleEffect& effect);
+		static void StopRumble(uint32_t handle);
+
+		/// <summary>Submits every pending rumble change to the backend, or waits for the sampler thread to while sampling, e.g. before replacing the backend with <c>IGamepadImpl::SetInstance</c>.</summary>
+		static void FlushRumble();
+		static void SetResponse(Index index, const GamepadResponse& response);
+
+		/// <summary>Sets a pad's deadzones and the response they imply. Like <c>Poll</c>, call it from the game thread.</summary>
+		/// <remarks>It also publishes a copy of the settings for <c>Latch</c>, which takes the newest copy published and so may run concurrently on the render thread.</remarks>
+		static void SetSettings(Index index, const GamepadSettings& settings);
+
+		/// <summary>Gets a pad's settings as last set. Call it from the game thread, like <c>SetSettings</c>.</summary>
+		static const GamepadSettings& GetSettings(Index index);
+
+		/// <summary>Sets the temporal filters and prediction of a pad's sticks, applied after its deadzones. Like <c>Poll</c>, call it from the game thread.</summary>
+		static void SetStickFilter(Index index, const StickFilterSettings& left, const StickFilterSettings& right);
+		static void Update();
+
+		/// <summary>Gets whether a pad is connected from the backend's cached connection state, without querying the device.</summary>
+		static bool IsConnected(Index index);
+
+		/// <summary>Gets the number of connected devices, which may exceed <c>IndexCount</c> on backends with a device registry.</summary>
+		static size_t DeviceCount();
+
+		/// <summary>Copies the ID and state of up to <paramref name='capacity'/> connected devices, in no particular order. Costs O(connected devices).</summary>
+		/// <remarks>States are converted through the pad's response but get no deadzones. While sampling, this and <c>DeviceCount</c> read a snapshot the
+		/// sampler thread publishes, which it starts doing on the first such call, so that call waits up to a sampling period. Call them from the game thread.</remarks>
+		/// <returns>The number of devices copied.</returns>
+		static size_t GetDevices(DeviceId* ids, State* states, size_t capacity);
+
+		/// <summary>Gets the device an index currently views, or <c>NoDevice</c>.</summary>
+		static DeviceId GetDeviceId(Index index);
+
+		static bool StartSampling(std::chrono::microseconds period);
+		static void StopSampling();
+		static bool IsSampling();
+		static void SetAxisEventThreshold(float threshold);
+
+		/// <summary>Registers a slot for <c>Latch</c> to fill from a pad's newest sampled state, e.g. the camera's yaw and pitch delta derived from its right stick.</summary>
+		/// <returns>A handle for <c>UnregisterLatch</c>, or <c>0</c> if <c>LateLatch::MaxSlots</c> slots are already registered.</returns>
+		static uint32_t RegisterLatch(Index index, LatchFunction function, void* slot, void* context = nullptr);
+		static void UnregisterLatch(uint32_t handle);
+
+		/// <summary>Fills every registered slot from the newest state the sampler has published. Call it right before submitting a frame.</summary>
+		/// <remarks>Call it, <c>RegisterLatch</c> and <c>UnregisterLatch</c> from one thread, normally the render thread. It never calls into the backend, so it fills
+		/// nothing unless sampling. States carry the timestamp of their sample and get the deadzones most recently published by <c>SetSettings</c>, but not the stick
+		/// filters, whose state belongs to the polls. Slots are filled in registration order.</remarks>
+		/// <returns>The number of slots filled.</returns>
+		static size_t Latch();
+
+		/// <summary>Gets the latencies recorded for a pad. All zero when the library is built with <c>DECAF_INPUT_NO_LATENCY</c>.</summary>
+		static LatencyStats GetLatency(Index index, Latency latency);
+		static void ResetLatency(Index index);
+
+		/// <summary>Gets a mask of the <c>Field</c> bits whose inputs differ between two states.</summary>
+		static uint8_t Diff(const State& previous, const State& current);
+
 	public:
 
+		/// <summary>Views a pad. Like <c>Poll</c> and <c>Clear</c>, construct it on the polling thread.</summary>
 		Gamepad(Index index);
 
+		static uint32_t Poll(Gamepad* gamepads, size_t count);
+
 		bool Poll();
 		bool IsConnected() const;
 		bool StateChanged() const;
 		void Clear();
 
-		const Vector2f& LeftStick() const;
-		const Vector2f& RightStick() const;
-		const float& LeftTrigger() const;
-		const float& RightTrigger() const;
+		/// <summary>Gets a mask of the <c>Field</c> bits that changed in the last poll. Zero when the pad delivered no new packet.</summary>
+		uint8_t ChangedFields() const;
+		bool FieldChanged(Field field) const;
+
+		/// <summary>Gets the state read by the last <c>Poll</c>, decoded from its packed form.</summary>
+		State CurrentState() const;
+		/// <summary>Gets the state read by the <c>Poll</c> before that. Only its inputs are kept, so its <c>packet</c> and <c>timestamp</c> are zero.</summary>
+		State PreviousState() const;
+
+		/// <summary>Gets the state read by the last <c>Poll</c> in the form it is stored in: after deadzones and filters, packed at the resolution of a linear pad.</summary>
+		const RawState& PackedState() const;
+		/// <summary>Gets when the state read by the last <c>Poll</c> was acquired, in nanoseconds on the <c>GamepadEventQueue::Now</c> clock.</summary>
+		uint64_t Timestamp() const;
+
+		Vector2f LeftStick() const;
+		Vector2f RightStick() const;
+		float LeftTrigger() const;
+		float RightTrigger() const;
 
 		bool IsButtonDown(Button button) const;
 		bool WasButtonPressed(Button button) const;
 		bool WasButtonReleased(Button button) const;
 
+		/// <summary>Gets the number of events the last <c>Poll</c> collected: every button edge and axis crossing since the poll before it, or since the object was created or cleared.</summary>
+		/// <remarks>Every <c>Gamepad</c> object reads the events of its index through a cursor of its own, so several objects may view one pad. Events are computed
+		/// from the states the backend converts, before deadzones and filters, whether or not the sampler is running.</remarks>
+		size_t EventCount() const;
+		const Event& GetEvent(size_t i) const;
+		/// <summary>Gets the number of events this object missed since it was created or cleared, either because the pad's queue was full or because it fell more than <c>GamepadEventQueue::Capacity</c> events behind.</summary>
+		uint64_t DroppedEvents() const;
+
 		void SetRumble(float left, float right);
 
+		/// <summary>Records the time since the last <c>Poll</c> as poll-to-consume latency. Only the first call after each poll counts.</summary>
+		void MarkConsumed();
+
 	private:
 
+		void CollectEvents();
+		void SkipEvents();
+		bool IsNewSample(const State& state) const;
+		bool IsNewStamp(const State& state) const;
+		void Accept(const State& state, uint32_t responseEpoch, uint64_t now);
+		void Store(const State& state);
+
 		Index m_index;
-		State m_lastState;
-		State m_currState;
+		// Both states are stored after their deadzones and filters, packed at the resolution of a linear pad; the accessors decode them through GamepadResponse::Linear.
+		RawState m_lastState;
+		RawState m_currState;
+		uint32_t m_packet;
+		uint64_t m_timestamp;
+		uint64_t m_pollTime;
+		// This object's window into the pad's event log: the sequence of its first event since the last poll, and how many there are.
+		uint64_t m_eventFirst;
+		size_t m_eventCount;
+		uint64_t m_droppedBase;
+		uint64_t m_eventsLost;
+		uint32_t m_settingsVersion;
+		uint16_t m_pressed;
+		uint16_t m_released;
+		uint8_t m_changed;
+		bool m_lastConnected;
+		bool m_connected;
 
 	};
 
+	static_assert(std::is_trivially_copyable<Gamepad::State>::value, "Gamepad::State is copied in bulk through ring and triple buffers.");
+	static_assert(std::is_standard_layout<Gamepad::State>::value, "Gamepad::State must keep a C-compatible layout.");
+	static_assert(sizeof(Gamepad::RawState) == 12, "Gamepad::RawState must stay packed.");
+	static_assert(sizeof(Gamepad::State) == 40 && alignof(Gamepad::State) == alignof(uint64_t), "Gamepad::State layout changed.");
+
+	/// <summary>Compares the inputs of two states field by field. The <c>packet</c> and <c>timestamp</c> stamps and padding bytes are ignored, and <c>0.0f</c> equals <c>-0.0f</c>.</summary>
+	inline bool operator == (const Gamepad::State& lhs, const Gamepad::State& rhs)
+	{
+		return lhs.leftStick == rhs.leftStick && lhs.rightStick == rhs.rightStick
+			&& lhs.leftTrigger == rhs.leftTrigger && lhs.rightTrigger == rhs.rightTrigger
+			&& lhs.buttons == rhs.buttons && lhs.connected == rhs.connected;
+	}
+
+	inline bool operator != (const Gamepad::State& lhs, const Gamepad::State& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
 }
 
 #endif
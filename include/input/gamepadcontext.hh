@@ -0,0 +1,145 @@
+#ifndef DECAF_INPUT_GAMEPADCONTEXT_HH_
+#define DECAF_INPUT_GAMEPADCONTEXT_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "decaf/input/deadzone.hh"
+#include "decaf/input/gamepad.hh"
+#include "decaf/input/gamepadimpl.hh"
+
+namespace decaf
+{
+
+	/// <summary>The per-pad settings shared by <c>GamepadContext</c> and <c>AnyGamepadContext</c>, and the deadzone stage that applies them.</summary>
+	class GamepadContextBase
+	{
+
+	public:
+
+		GamepadContextBase();
+
+		const GamepadSettings& GetSettings(Gamepad::Index index) const { return m_settings[static_cast<size_t>(index)]; }
+
+		/// <summary>Gets the response a backend should use under <paramref name='settings'/>: every deadzone mode but <c>XINPUT</c> needs linear sticks.</summary>
+		/// <remarks>Only the built-in XInput and linear stick curves are swapped. Custom curves set with <c>SetResponse</c> are kept as they are, so
+		/// they should already be linear near the centre when combined with a mode other than <c>XINPUT</c>.</remarks>
+		static GamepadResponse ResponseFor(const GamepadResponse& response, const GamepadSettings& settings);
+
+		/// <summary>Applies <c>settings[i]</c> to the sticks of <c>states[i]</c> for <paramref name='count'/> states, in one batched pass.</summary>
+		static void ApplySettings(const GamepadSettings* settings, Gamepad::State* states, size_t count);
+
+	protected:
+
+		friend class AnyGamepadContext;
+
+		void ApplySettings(Gamepad::Index index, Gamepad::State& state) const;
+
+		GamepadSettings m_settings[Gamepad::IndexCount];
+
+	};
+
+	/// <summary>A set of pads read from a backend chosen at compile time, with its own settings. Any number of contexts may coexist.</summary>
+	/// <remarks>Calls name the backend's own overrides, so they bind statically instead of going through the vtable and
+	/// <c>IGamepadImpl::Instance</c>. The context owns its backend, constructed from the constructor's arguments.
+	/// Like the backends themselves, a context is not thread-safe.</remarks>
+	template <typename Backend>
+	class GamepadContext : public GamepadContextBase
+	{
+
+		static_assert(std::is_base_of<IGamepadImpl, Backend>::value, "GamepadContext needs an IGamepadImpl backend.");
+
+	public:
+
+		template <typename... Args>
+		explicit GamepadContext(Args&&... args)
+			: m_backend(std::forward<Args>(args)...) { }
+
+		GamepadContext(const GamepadContext&) = delete;
+		GamepadContext& operator=(const GamepadContext&) = delete;
+
+		inline Backend& GetBackend() { return m_backend; }
+		inline const Backend& GetBackend() const { return m_backend; }
+
+		inline void Update()
+		{
+			m_backend.Backend::Update();
+		}
+
+		inline Gamepad::State GetState(Gamepad::Index index)
+		{
+			Gamepad::State state = m_backend.Backend::GetState(index);
+			ApplySettings(index, state);
+			return state;
+		}
+
+		inline uint32_t GetStates(Gamepad::State* states, size_t count)
+		{
+			uint32_t connected = m_backend.Backend::GetStates(states, count);
+			ApplySettings(m_settings, states, count < Gamepad::IndexCount ? count : Gamepad::IndexCount);
+			return connected;
+		}
+
+		inline bool IsConnected(Gamepad::Index index) const
+		{
+			return m_backend.IsConnected(index);
+		}
+
+		inline size_t GetDevices(Gamepad::DeviceId* ids, Gamepad::State* states, size_t capacity)
+		{
+			return m_backend.Backend::GetDevices(ids, states, capacity);
+		}
+
+		/// <summary>Sends rumble straight to the backend. Unlike <c>Gamepad::SetRumble</c>, this is synchronous and not mixed.</summary>
+		inline void SetRumble(Gamepad::Index index, float left, float right)
+		{
+			m_backend.Backend::SetRumble(index, left, right);
+		}
+
+		inline void SetSettings(Gamepad::Index index, const GamepadSettings& settings)
+		{
+			m_backend.Backend::SetResponse(index, ResponseFor(m_backend.GetResponse(index), settings));
+			m_settings[static_cast<size_t>(index)] = settings;
+		}
+
+	private:
+
+		Backend m_backend;
+
+	};
+
+	/// <summary>A runtime-selected view of a context: the same calls as <c>GamepadContext</c>, dispatched through the vtable.</summary>
+	/// <remarks>Shares the settings and backend of the context it was made from, which must outlive it. Only use it where
+	/// the backend really is picked at run time; everything else should take the typed context.</remarks>
+	class AnyGamepadContext
+	{
+
+	public:
+
+		template <typename Backend>
+		AnyGamepadContext(GamepadContext<Backend>& context)
+			: m_context{ &context }, m_backend{ &context.GetBackend() } { }
+
+		void Update();
+		Gamepad::State GetState(Gamepad::Index index);
+		uint32_t GetStates(Gamepad::State* states, size_t count);
+		bool IsConnected(Gamepad::Index index) const;
+		size_t GetDevices(Gamepad::DeviceId* ids, Gamepad::State* states, size_t capacity);
+		void SetRumble(Gamepad::Index index, float left, float right);
+		void SetSettings(Gamepad::Index index, const GamepadSettings& settings);
+		const GamepadSettings& GetSettings(Gamepad::Index index) const;
+
+		inline IGamepadImpl& GetBackend() { return *m_backend; }
+
+	private:
+
+		GamepadContextBase* m_context;
+		IGamepadImpl* m_backend;
+
+	};
+
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef DECAF_INPUT_GAMEPADEVENTS_HH_
+#define DECAF_INPUT_GAMEPADEVENTS_HH_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "decaf/concurrent/spscring.hh"
+#include "decaf/input/gamepad.hh"
+
+namespace decaf
+{
+
+	/// <summary>Turns a stream of sampled gamepad states into timestamped button and axis events, one lock-free ring per pad.</summary>
+	/// <remarks><c>Sample</c> is the producer side and must only be called from the sampling thread.
+	/// <c>Collect</c> and <c>Get</c> are the consumer side and must only be called from the polling thread. <c>Collect</c> moves a pad's events
+	/// out of its ring into a log numbered by sequence, which any number of consumers read with cursors of their own, so one never takes events from another.</remarks>
+	class GamepadEventQueue
+	{
+
+	public:
+
+		static constexpr size_t Capacity = 4096;
+
+		/// <summary>Gets the current time on the clock used for event timestamps, in nanoseconds.</summary>
+		static uint64_t Now();
+
+	public:
+
+		GamepadEventQueue();
+
+		GamepadEventQueue(const GamepadEventQueue&) = delete;
+		GamepadEventQueue& operator=(const GamepadEventQueue&) = delete;
+
+		/// <summary>Sets how far an axis has to move from rest before it emits an <c>AXIS_CROSSED</c> event.</summary>
+		void SetAxisThreshold(float threshold);
+
+		/// <summary>Emits an event for every button and axis zone that differs from the previous sample of the pad.</summary>
+		void Sample(Gamepad::Index index, const Gamepad::State& state, uint64_t timestamp);
+
+		/// <summary>Moves every event sampled so far into the pad's log.</summary>
+		/// <returns>The sequence number one past the newest logged event.</returns>
+		uint64_t Collect(Gamepad::Index index);
+
+		/// <summary>Gets a logged event by sequence number. The log keeps the newest <c>Capacity</c> events, so valid sequences lie in
+		/// <c>[Collect() - Capacity, Collect())</c>, and the returned reference stays valid until the pad logs another <c>Capacity</c> events.</summary>
+		const Gamepad::Event& Get(Gamepad::Index index, uint64_t sequence) const;
+
+		/// <summary>Gets the number of events discarded because the pad's ring was full.</summary>
+		uint64_t Dropped(Gamepad::Index index) const;
+
+	private:
+
+		struct Channel
+		{
+			SpscRing<Gamepad::Event, Capacity> ring;
+			std::atomic<uint64_t> dropped;
+			uint16_t buttons;
+			int8_t zones[6];
+			// Consumer side.
+			Gamepad::Event log[Capacity];
+			uint64_t logged;
+		};
+
+		void Push(Channel& channel, const Gamepad::Event& event);
+
+		std::atomic<float> m_threshold;
+		Channel m_channels[Gamepad::IndexCount];
+
+	};
+
+}
+
+#endif
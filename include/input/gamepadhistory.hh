@@ -0,0 +1,97 @@
+#ifndef DECAF_INPUT_GAMEPADHISTORY_HH_
+#define DECAF_INPUT_GAMEPADHISTORY_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "decaf/input/gamepad.hh"
+
+namespace decaf
+{
+
+	/// <summary>Remembers the recent states and button edges of one pad, to answer e.g. "was A pressed in the last 120 ms". Times are in nanoseconds.</summary>
+	/// <remarks>States are kept as packed snapshots in a ring sized once at construction, one snapshot per change; nothing allocates afterwards.
+	/// Button edges are kept apart from them, as the last <c>PressDepth</c> press times and the last release time of every button, so the
+	/// button queries take constant time and <c>StateAt</c> a binary search however long the history is. When recording a <c>Gamepad</c>,
+	/// edges come from its events, which catch taps shorter than a poll; otherwise they come from the changes between snapshots.</remarks>
+	class GamepadHistory
+	{
+
+	public:
+
+		/// <summary>How many presses of each button are remembered, and so the most <c>PressCount</c> returns.</summary>
+		static constexpr size_t PressDepth = 8;
+
+		/// <summary>One snapshot: a state packed like <c>Gamepad::PackedState</c>, and when it was acquired.</summary>
+		struct Entry
+		{
+			uint64_t timestamp;
+			Gamepad::RawState state;
+			bool connected;
+		};
+
+	public:
+
+		/// <summary>Allocates room for <paramref name='capacity'/> snapshots, rounded up to a power of two.</summary>
+		explicit GamepadHistory(size_t capacity = 256);
+
+		/// <summary>Appends a snapshot unless it equals the newest, and records the button edges since the newest as happening at <paramref name='timestamp'/>.</summary>
+		/// <remarks>Snapshot times must not go backwards; an older one is treated as the time of the newest snapshot.</remarks>
+		void Push(const Gamepad::RawState& state, bool connected, uint64_t timestamp);
+
+		/// <summary>Records the button events of the pad's last poll at their own times, then its state. Call it once after every poll.</summary>
+		void Record(const Gamepad& pad);
+
+		/// <summary>Forgets every snapshot and edge.</summary>
+		void Clear();
+
+		/// <summary>Gets the number of snapshots held, at most <c>Capacity</c>.</summary>
+		inline size_t Count() const { return m_count < m_entries.size() ? static_cast<size_t>(m_count) : m_entries.size(); }
+
+		inline size_t Capacity() const { return m_entries.size(); }
+
+		/// <summary>Gets a snapshot by age: <c>0</c> is the newest and <c>Count() - 1</c> the oldest.</summary>
+		inline const Entry& Get(size_t age) const { return m_entries[(m_count - 1 - age) & m_mask]; }
+
+		/// <summary>Gets whether a button is held, as of the newest edge.</summary>
+		bool IsDown(Gamepad::Button button) const;
+
+		/// <summary>Gets whether a button was pressed no more than <paramref name='window'/> before <paramref name='now'/>, e.g. to buffer an input.</summary>
+		bool WasPressedWithin(Gamepad::Button button, uint64_t window, uint64_t now) const;
+
+		/// <summary>Gets whether a button was released no more than <paramref name='window'/> before <paramref name='now'/>.</summary>
+		bool WasReleasedWithin(Gamepad::Button button, uint64_t window, uint64_t now) const;
+
+		/// <summary>Gets how long a button has been held at <paramref name='now'/>, or <c>0</c> if it is up.</summary>
+		uint64_t HeldDuration(Gamepad::Button button, uint64_t now) const;
+
+		/// <summary>Counts the presses of a button no more than <paramref name='window'/> before <paramref name='now'/>, up to <c>PressDepth</c>.</summary>
+		/// <remarks>A double-tap is two presses within the tap window.</remarks>
+		size_t PressCount(Gamepad::Button button, uint64_t window, uint64_t now) const;
+
+		/// <summary>Decodes the snapshot in effect at <paramref name='timestamp'/>, through <c>GamepadResponse::Linear</c>.</summary>
+		/// <returns><c>false</c> if <paramref name='timestamp'/> is older than every snapshot held.</returns>
+		bool StateAt(uint64_t timestamp, Gamepad::State& state) const;
+
+	private:
+
+		static constexpr size_t Buttons = 16;
+
+		void Press(size_t bit, uint64_t timestamp);
+		void Release(size_t bit, uint64_t timestamp);
+
+		std::vector<Entry> m_entries;
+		uint64_t m_mask;
+		uint64_t m_count;
+
+		uint64_t m_presses[Buttons][PressDepth];
+		uint32_t m_pressCount[Buttons];
+		uint64_t m_released[Buttons];
+		uint16_t m_down;
+
+	};
+
+}
+
+#endif
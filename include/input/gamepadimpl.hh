@@ -1,31 +1,176 @@
 #ifndef DECAF_INPUT_GAMEPADIMPL_HH_
 #define DECAF_INPUT_GAMEPADIMPL_HH_
 
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
 #include "decaf/input/gamepad.hh"
+#include "decaf/input/response.hh"
 
 namespace decaf
 {
 
+	class GamepadEventQueue;
+
 	class IGamepadImpl
 	{
 
 	public:
 
+		/// <summary>Gets the backend behind the static <c>Gamepad</c> API: the one set with <c>SetInstance</c>, or else the platform backend. Thread-safe.</summary>
+		/// <remarks>Code that knows its backend at compile time should use a <c>GamepadContext</c> instead, which avoids this lookup and the virtual calls.</remarks>
 		static IGamepadImpl* Instance();
 
+		/// <summary>Replaces the backend returned by <c>Instance</c>. The caller keeps ownership of <paramref name='impl'/>; passing null restores the platform backend.</summary>
+		static void SetInstance(IGamepadImpl* impl);
+
+		virtual ~IGamepadImpl() { }
+
 		virtual Gamepad::State GetState(Gamepad::Index index) = 0;
 
-		virtual Gamepad::State GetState(Gamepad::Index index, float deadzone) = 0;
+		virtual Gamepad::State GetState(Gamepad::Index index, float deadzone) { return GetState(index, GamepadResponse::XInput(deadzone)); }
+
+		/// <summary>Gets the state of a pad converted with <paramref name='response'/> instead of the pad's configured curves.</summary>
+		virtual Gamepad::State GetState(Gamepad::Index index, const GamepadResponse& response) = 0;
+
+		virtual uint32_t GetStates(Gamepad::State* states, size_t count);
 
 		virtual void SetRumble(Gamepad::Index index, float left, float right) = 0;
 
+		virtual void Update() { }
+
+		/// <summary>Sets the curves used to convert raw readings of a pad for <c>GetState(index)</c> and <c>GetStates</c>. Safe to call while another thread, e.g. the sampler, reads the backend.</summary>
+		/// <remarks>The curves are handed over through a mailbox and take effect at the start of the next read, on the reading thread, so a read in progress
+		/// keeps decoding through the tables it started with and the old tables are released by the thread that used them.</remarks>
+		virtual void SetResponse(Gamepad::Index index, const GamepadResponse& response);
+
+		/// <summary>Gets the curves last set for a pad, which may not have reached the reading thread yet. Call it from the thread that sets responses.</summary>
+		const GamepadResponse& GetResponse(Gamepad::Index index) const { return m_requested[static_cast<size_t>(index)]; }
+
+		/// <summary>Gets how many times reads have picked up new curves. Loaded on the reading thread right after a read, it identifies the curves that read decoded with.</summary>
+		uint32_t ResponseEpoch() const { return m_responseEpoch.load(std::memory_order_acquire); }
+
+		/// <summary>Gets the cached connection state of a pad as of the backend's last read or hotplug notification. Never touches the device.</summary>
+		bool IsConnected(Gamepad::Index index) const { return ((m_connected.load(std::memory_order_acquire) >> static_cast<size_t>(index)) & 1) != 0; }
+
+		/// <summary>Gets the cached connection state of every pad, one bit per <c>Gamepad::Index</c>.</summary>
+		uint32_t ConnectedMask() const { return m_connected.load(std::memory_order_acquire); }
+
+		/// <summary>Gets the number of connected devices. Backends limited to the <c>Gamepad::Index</c> slots count the connected ones.</summary>
+		virtual size_t DeviceCount() const;
+
+		/// <summary>Copies the ID and state of up to <paramref name='capacity'/> connected devices and returns how many were copied.</summary>
+		/// <remarks>Backends limited to the <c>Gamepad::Index</c> slots report slot <c>i</c> as device <c>i + 1</c>.</remarks>
+		virtual size_t GetDevices(Gamepad::DeviceId* ids, Gamepad::State* states, size_t capacity);
+
+		/// <summary>Gets the device a slot currently views, or <c>Gamepad::NoDevice</c>.</summary>
+		virtual Gamepad::DeviceId GetDeviceId(Gamepad::Index index) const;
+
+		/// <summary>Sets the queue that backends reading several reports of a pad in one update feed every report to, so edges shorter than a read still
+		/// become events. Null stops it.</summary>
+		/// <remarks>Reports are fed from the reading thread, which must be the queue's producer: the sampler thread while sampling, otherwise the thread
+		/// calling <c>Update</c>.</remarks>
+		virtual void SetEventQueue(GamepadEventQueue* events) { m_events.store(events, std::memory_order_release); }
+
+		/// <summary>Hints that a device may have been plugged in, so every empty slot is probed on the next read regardless of its backoff. Safe to call from any thread.</summary>
+		virtual void NotifyHotplug();
+
 	protected:
 
-		IGamepadImpl() { }
-		IGamepadImpl(const IGamepadImpl&) { }
-		IGamepadImpl& operator=(const IGamepadImpl&) { }
+		/// <summary>The delay before re-probing a slot that was just found empty. Doubles with each failed probe up to <c>ProbeBackoffMax</c>.</summary>
+		static constexpr uint64_t ProbeBackoffMin = 100000000;
+		static constexpr uint64_t ProbeBackoffMax = 2000000000;
+
+		IGamepadImpl()
+			: m_connected{ 0 }, m_events{ nullptr }, m_pendingResponses{ 0 }, m_responseEpoch{ 0 }
+		{
+			for (GamepadResponse& response : m_responses)
+				response = GamepadResponse::XInput();
+
+			for (GamepadResponse& response : m_requested)
+				response = GamepadResponse::XInput();
+
+			for (size_t i = 0; i < Gamepad::IndexCount; ++i)
+			{
+				m_nextProbe[i].store(0, std::memory_order_relaxed);
+				m_backoff[i].store(ProbeBackoffMin, std::memory_order_relaxed);
+				m_packets[i] = 0;
+				m_stamps[i] = 0;
+				m_cache[i] = {};
+				m_cached[i] = false;
+			}
+		}
+
+		IGamepadImpl(const IGamepadImpl&) : IGamepadImpl() { }
+		IGamepadImpl& operator=(const IGamepadImpl&) { return *this; }
+
+		/// <summary>Moves the curves set since the last read into <c>m_responses</c>. Backends call it at the start of every read, on the reading thread.</summary>
+		void ApplyResponses()
+		{
+			if (m_pendingResponses.load(std::memory_order_acquire) != 0)
+				ApplyPendingResponses();
+		}
+
+		/// <summary>Updates the cached connection state of a pad. A newly connected pad restarts its probe backoff.</summary>
+		void SetConnected(Gamepad::Index index, bool connected);
+
+		/// <summary>Replaces the whole cached connection mask, e.g. to mirror a wrapped backend.</summary>
+		void SetConnectedMask(uint32_t mask) { m_connected.store(mask, std::memory_order_release); }
+
+		/// <summary>Whether a read of a pad should go to the device: always for connected pads, and for empty slots once their backoff has elapsed.</summary>
+		bool ShouldProbe(Gamepad::Index index);
+
+		/// <summary>Records that probing an empty slot found nothing, pushing its next probe back exponentially.</summary>
+		void ProbeFailed(Gamepad::Index index);
+
+		/// <summary>Gets when a pad's report <paramref name='packet'/> was first read, for backends whose devices number their reports but do not time them.</summary>
+		uint64_t StampPacket(Gamepad::Index index, uint32_t packet);
+
+		/// <summary>Gets the state last converted for a pad with its own response, if it was converted from <paramref name='packet'/>. Otherwise null.</summary>
+		/// <remarks>Lets backends skip the conversion of a pad that has not delivered a new report since the last read. Only the reading thread uses the cache.</remarks>
+		const Gamepad::State* CachedState(Gamepad::Index index, uint32_t packet) const
+		{
+			size_t slot = static_cast<size_t>(index);
+			return (m_cached[slot] && m_cache[slot].packet == packet) ? &m_cache[slot] : nullptr;
+		}
+
+		void CacheState(Gamepad::Index index, const Gamepad::State& state)
+		{
+			m_cache[static_cast<size_t>(index)] = state;
+			m_cached[static_cast<size_t>(index)] = true;
+		}
+
+		void InvalidateState(Gamepad::Index index) { m_cached[static_cast<size_t>(index)] = false; }
+
+		/// <summary>Whether <c>EmitReport</c> goes anywhere, so backends only convert intermediate reports when they are wanted.</summary>
+		bool EmitsReports() const { return m_events.load(std::memory_order_relaxed) != nullptr; }
+
+		/// <summary>Feeds one report of a pad, converted through the pad's own response, to the event queue. Call it on the reading thread as each report is read.</summary>
+		void EmitReport(Gamepad::Index index, const Gamepad::State& state);
+
+		/// <summary>The curves reads decode with. Only the reading thread touches them.</summary>
+		GamepadResponse m_responses[Gamepad::IndexCount];
+		std::atomic<uint32_t> m_connected;
+		// NotifyHotplug may reset the probe schedule from any thread, while the reading thread advances it.
+		std::atomic<uint64_t> m_nextProbe[Gamepad::IndexCount];
+		std::atomic<uint64_t> m_backoff[Gamepad::IndexCount];
+		uint32_t m_packets[Gamepad::IndexCount];
+		uint64_t m_stamps[Gamepad::IndexCount];
+		Gamepad::State m_cache[Gamepad::IndexCount];
+		bool m_cached[Gamepad::IndexCount];
+		std::atomic<GamepadEventQueue*> m_events;
+
+		static std::atomic<IGamepadImpl*> m_instance;
+
+	private:
+
+		void ApplyPendingResponses();
 
-		static IGamepadImpl* m_instance;
+		GamepadResponse m_requested[Gamepad::IndexCount];
+		std::mutex m_responseMutex;
+		std::atomic<uint32_t> m_pendingResponses;
+		std::atomic<uint32_t> m_responseEpoch;
 
 	};
 
@@ -0,0 +1,121 @@
+#ifndef DECAF_INPUT_GAMEPADSAMPLER_HH_
+#define DECAF_INPUT_GAMEPADSAMPLER_HH_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "decaf/concurrent/triplebuffer.hh"
+#include "decaf/input/gamepad.hh"
+
+namespace decaf
+{
+
+	class IGamepadImpl;
+	class GamepadEventQueue;
+	class RumbleMixer;
+
+	/// <summary>Polls a gamepad backend on a background thread and publishes every pad's state through a triple buffer.</summary>
+	/// <remarks>While running, the sampler thread is the only caller of the backend's reads, <c>Update</c> and <c>SetRumble</c>.
+	/// <c>Read</c>, <c>ReadRaw</c> and <c>ReadDevices</c> must only be called from one consumer thread, and <c>ReadLatest</c> from one other, e.g. the render thread.</remarks>
+	class GamepadSampler
+	{
+
+	public:
+
+		GamepadSampler();
+		~GamepadSampler();
+
+		GamepadSampler(const GamepadSampler&) = delete;
+		GamepadSampler& operator=(const GamepadSampler&) = delete;
+
+		/// <summary>Starts sampling <paramref name='impl'/> once every <paramref name='period'/>.</summary>
+		/// <param name='events'>If not null, every sample is also fed to this queue from the sampler thread.</param>
+		/// <param name='rumble'>If not null, its mixes are submitted to the backend from the sampler thread on every update.</param>
+		/// <returns><c>false</c> if the sampler is already running.</returns>
+		bool Start(IGamepadImpl* impl, std::chrono::microseconds period, GamepadEventQueue* events = nullptr, RumbleMixer* rumble = nullptr);
+
+		/// <summary>Stops the sampler thread and waits for it to exit.</summary>
+		void Stop();
+
+		bool IsRunning() const;
+
+		/// <summary>Copies the newest published state of a pad. Never blocks and never calls into the backend.</summary>
+		/// <returns><c>true</c> if the state was sampled after the previous <c>Read</c> of the same pad.</returns>
+		bool Read(Gamepad::Index index, Gamepad::State& state);
+
+		/// <summary>Like <c>Read</c>, also giving the backend's <c>IGamepadImpl::ResponseEpoch</c> as of the sample, which identifies the curves it was converted with.</summary>
+		bool Read(Gamepad::Index index, Gamepad::State& state, uint32_t& responseEpoch);
+
+		/// <summary>Like <c>Read</c>, through a second set of buffers, so a late reader such as the render thread never steals a sample from the game thread.</summary>
+		bool ReadLatest(Gamepad::Index index, Gamepad::State& state);
+
+		/// <summary>Copies the newest reading of a pad packed at the resolution <c>GamepadResponse::Linear</c> decodes, for callers that convert it through curves of their own.</summary>
+		/// <remarks><paramref name='state'/> gets the reading's connection, packet and timestamp, and its inputs through the linear curves. The sampler only
+		/// starts publishing raw readings once asked, so the first call waits up to a period for one.</remarks>
+		/// <returns><c>false</c> if the sampler stopped before publishing a reading.</returns>
+		bool ReadRaw(Gamepad::Index index, Gamepad::RawState& raw, Gamepad::State& state);
+
+		/// <summary>Copies the IDs and states of up to <paramref name='capacity'/> devices from the newest snapshot of the backend's devices.</summary>
+		/// <remarks>The sampler only starts snapshotting devices once asked, so the first call waits up to a period for one. From then on every sample
+		/// converts every connected device.</remarks>
+		/// <returns><c>false</c> if the sampler stopped before publishing a snapshot.</returns>
+		bool ReadDevices(Gamepad::DeviceId* ids, Gamepad::State* states, size_t capacity, size_t& count);
+
+		/// <summary>Gets the number of devices in the newest snapshot, which <c>ReadDevices</c> reads.</summary>
+		bool ReadDeviceCount(size_t& count);
+
+	private:
+
+		/// <summary>Bits of <c>m_wanted</c> and <c>m_published</c>: the publications the sampler only makes once a consumer has asked for them.</summary>
+		static constexpr uint32_t WantRaw = 0x1;
+		static constexpr uint32_t WantDevices = 0x2;
+
+		struct RawSample
+		{
+			Gamepad::RawState raw;
+			Gamepad::State state;
+		};
+
+		struct Devices
+		{
+			std::vector<Gamepad::DeviceId> ids;
+			std::vector<Gamepad::State> states;
+		};
+
+		struct Sample
+		{
+			Gamepad::State state;
+			uint32_t responseEpoch;
+		};
+
+		void Run();
+		void Publish(const Gamepad::State* states, uint32_t responseEpoch);
+		void PublishExtras();
+
+		/// <summary>Asks for the publications in <paramref name='extras'/> and waits until the sampler has made them at least once.</summary>
+		/// <returns><c>false</c> if the sampler stopped first.</returns>
+		bool Want(uint32_t extras);
+
+		IGamepadImpl* m_impl;
+		GamepadEventQueue* m_events;
+		RumbleMixer* m_rumble;
+		std::chrono::microseconds m_period;
+		std::atomic<bool> m_running;
+		std::thread m_thread;
+
+		TripleBuffer<Sample> m_states[Gamepad::IndexCount];
+		TripleBuffer<Gamepad::State> m_latest[Gamepad::IndexCount];
+		TripleBuffer<RawSample> m_raw[Gamepad::IndexCount];
+		TripleBuffer<Devices> m_devices;
+
+		std::atomic<uint32_t> m_wanted;
+		std::atomic<uint32_t> m_published;
+
+	};
+
+}
+
+#endif
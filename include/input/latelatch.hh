@@ -0,0 +1,67 @@
+#ifndef DECAF_INPUT_LATELATCH_HH_
+#define DECAF_INPUT_LATELATCH_HH_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "decaf/input/gamepad.hh"
+
+namespace decaf
+{
+
+	/// <summary>Slots of memory the renderer owns, e.g. a camera's yaw and pitch delta, each filled from the newest state of a pad right before a frame is submitted.</summary>
+	/// <remarks>Every slot has a function that derives its value from a state; <c>Fill</c> calls the functions in registration order.
+	/// Nothing is allocated and no lock is taken, so <c>Register</c>, <c>Unregister</c> and <c>Fill</c> must all be called from one thread, normally the render thread.</remarks>
+	class LateLatch
+	{
+
+	public:
+
+		/// <summary>The number of slots that can be registered at once.</summary>
+		static constexpr size_t MaxSlots = 16;
+
+	public:
+
+		LateLatch();
+
+		LateLatch(const LateLatch&) = delete;
+		LateLatch& operator=(const LateLatch&) = delete;
+
+		/// <summary>Registers a slot filled from a pad's state by <paramref name='function'/>.</summary>
+		/// <returns>A handle for <c>Unregister</c>, or <c>0</c> if <c>MaxSlots</c> slots are already registered.</returns>
+		uint32_t Register(Gamepad::Index index, Gamepad::LatchFunction function, void* slot, void* context = nullptr);
+
+		/// <summary>Unregisters a slot. Stale handles are ignored.</summary>
+		void Unregister(uint32_t handle);
+
+		/// <summary>Gets a mask with bit <c>i</c> set when a slot reads pad <c>i</c>, so only those pads need reading before <c>Fill</c>.</summary>
+		inline uint32_t Pads() const { return m_pads; }
+
+		inline size_t Count() const { return m_count; }
+
+		/// <summary>Fills every slot from <c>states[index]</c> of its pad.</summary>
+		/// <param name='states'>The states of all <c>Gamepad::IndexCount</c> pads.</param>
+		/// <returns>The number of slots filled.</returns>
+		size_t Fill(const Gamepad::State* states) const;
+
+	private:
+
+		struct Slot
+		{
+			Gamepad::LatchFunction function;
+			void* slot;
+			void* context;
+			Gamepad::Index index;
+			uint32_t handle;
+		};
+
+		Slot m_slots[MaxSlots];
+		size_t m_count;
+		uint32_t m_pads;
+		uint32_t m_serial;
+
+	};
+
+}
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef DECAF_INPUT_LATENCY_HH_
+#define DECAF_INPUT_LATENCY_HH_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#if defined (_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace decaf
+{
+
+	/// <summary>A summary of recorded latencies, in nanoseconds. Percentiles are reported as the upper edge of their bucket.</summary>
+	struct LatencyStats
+	{
+		uint64_t count;
+		uint64_t p50;
+		uint64_t p99;
+		uint64_t max;
+	};
+
+	/// <summary>A lock-free log-linear histogram of nanosecond durations with a relative error below 12.5%.</summary>
+	/// <remarks><c>Record</c> is wait-free and may run concurrently with <c>Stats</c> from any thread.
+	/// <c>Reset</c> races with concurrent <c>Record</c> calls only in that those samples may survive the reset.</remarks>
+	class LatencyHistogram
+	{
+
+	public:
+
+		static constexpr size_t SubBucketBits = 3;
+		static constexpr size_t SubBuckets = size_t(1) << SubBucketBits;
+		static constexpr size_t BucketCount = (64 - SubBucketBits + 1) * SubBuckets;
+
+	public:
+
+		LatencyHistogram();
+
+		LatencyHistogram(const LatencyHistogram&) = delete;
+		LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+		inline void Record(uint64_t nanoseconds)
+		{
+			m_counts[BucketOf(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+
+			uint64_t max = m_max.load(std::memory_order_relaxed);
+			while (nanoseconds > max && !m_max.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed));
+		}
+
+		/// <summary>Gets the smallest bucket edge at or below which <paramref name='fraction'/> of the samples fall.</summary>
+		uint64_t Percentile(double fraction) const;
+
+		LatencyStats Stats() const;
+
+		void Reset();
+
+		/// <summary>Gets the bucket a duration falls in: exact below <c>2 * SubBuckets</c>, then <c>SubBuckets</c> buckets per power of two.</summary>
+		static inline size_t BucketOf(uint64_t nanoseconds)
+		{
+			if (nanoseconds < SubBuckets * 2)
+				return static_cast<size_t>(nanoseconds);
+
+			size_t msb = HighestBit(nanoseconds);
+			size_t sub = static_cast<size_t>(nanoseconds >> (msb - SubBucketBits)) & (SubBuckets - 1);
+
+			return (msb - SubBucketBits + 1) * SubBuckets + sub;
+		}
+
+		/// <summary>Gets the largest duration that falls in <paramref name='bucket'/>.</summary>
+		static uint64_t UpperBound(size_t bucket);
+
+	private:
+
+		static inline size_t HighestBit(uint64_t value)
+		{
+#if defined (_MSC_VER)
+			unsigned long index;
+			_BitScanReverse64(&index, value);
+			return index;
+#else
+			return 63 - static_cast<size_t>(__builtin_clzll(value));
+#endif
+		}
+
+		std::atomic<uint64_t> m_counts[BucketCount];
+		std::atomic<uint64_t> m_max;
+
+	};
+
+}
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef DECAF_INPUT_LINUX_GAMEPADIMPLLINUX_HH_
+#define DECAF_INPUT_LINUX_GAMEPADIMPLLINUX_HH_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "decaf/input/deviceregistry.hh"
+#include "decaf/input/gamepadimpl.hh"
+
+namespace decaf
+{
+
+	/// <summary>Reads any number of evdev gamepads. The first four are viewed through <c>Gamepad::Index</c>; the rest are reachable by <c>Gamepad::DeviceId</c>.</summary>
+	class GamepadImpl_Linux : public IGamepadImpl
+	{
+
+	public:
+
+		static constexpr size_t MaxPads = Gamepad::IndexCount;
+
+	public:
+
+		GamepadImpl_Linux();
+		explicit GamepadImpl_Linux(bool scanDevices);
+		virtual ~GamepadImpl_Linux();
+
+		GamepadImpl_Linux(const GamepadImpl_Linux&) = delete;
+		GamepadImpl_Linux& operator=(const GamepadImpl_Linux&) = delete;
+
+		using IGamepadImpl::GetState;
+
+		virtual Gamepad::State GetState(Gamepad::Index index);
+
+		virtual Gamepad::State GetState(Gamepad::Index index, const GamepadResponse& response);
+
+		virtual uint32_t GetStates(Gamepad::State* states, size_t count);
+
+		virtual void SetRumble(Gamepad::Index index, float left, float right);
+
+		virtual void Update();
+
+		virtual size_t DeviceCount() const;
+
+		virtual size_t GetDevices(Gamepad::DeviceId* ids, Gamepad::State* states, size_t capacity);
+
+		virtual Gamepad::DeviceId GetDeviceId(Gamepad::Index index) const;
+
+		/// <summary>Rescans <c>/dev/input</c> on the next <c>Update</c>.</summary>
+		virtual void NotifyHotplug();
+
+		/// <summary>Opens every gamepad under <c>/dev/input</c> that is not attached yet.</summary>
+		void Scan();
+
+		/// <summary>Attaches an evdev stream to a pad slot, replacing whatever the slot viewed. The backend takes ownership of <paramref name='fd'/>.</summary>
+		/// <remarks>Any readable descriptor carrying <c>input_event</c> records works, which lets pipes and socketpairs stand in for hardware.</remarks>
+		/// <returns><c>true</c> if the descriptor was attached.</returns>
+		bool Attach(Gamepad::Index index, int fd);
+
+		/// <summary>Attaches an evdev stream as a new device, bound to the first free pad slot if there is one. The backend takes ownership of <paramref name='fd'/>.</summary>
+		/// <returns>The new device's ID, or <c>Gamepad::NoDevice</c> if the descriptor was not attached.</returns>
+		Gamepad::DeviceId AttachDevice(int fd);
+
+		/// <summary>Closes the stream viewed by a pad slot and marks it disconnected.</summary>
+		void Detach(Gamepad::Index index);
+
+		/// <summary>Closes a device's stream. If a pad slot viewed it, the longest-attached unbound device takes over the slot.</summary>
+		void DetachDevice(Gamepad::DeviceId id);
+
+	private:
+
+		struct AxisRange
+		{
+			int32_t minimum;
+			int32_t maximum;
+		};
+
+		struct Device
+		{
+			int fd;
+			int rumbleId;
+			uint16_t rumble[2];
+			bool rumblePlaying;
+			uint64_t hardwareKey;
+			bool syncDropped;
+			bool monotonic;
+			size_t partialBytes;
+			unsigned char partial[32];
+			AxisRange ranges[6];
+			/// <summary>The report being assembled; each <c>SYN_REPORT</c> publishes it to the registry.</summary>
+			Gamepad::RawState pending;
+		};
+
+		Gamepad::DeviceId Open(int fd, size_t slot);
+		void ReadDevice(Gamepad::DeviceId id);
+		bool HandleEvent(Device& device, uint16_t type, uint16_t code, int32_t value);
+		void Resync(Device& device);
+		void Decode(size_t i, const GamepadResponse& response, Gamepad::State& state) const;
+		/// <summary>Decodes device <paramref name='i'/> through the response of the slot viewing it, reusing the slot's cached conversion for a repeated packet.</summary>
+		void DecodeSlot(Gamepad::Index index, size_t i, Gamepad::State& state);
+		void SyncSlots();
+		void HandleHotplug();
+
+		/// <summary>Gets the curves for a device: its slot's response, or XInput's defaults for devices no slot views.</summary>
+		const GamepadResponse& ResponseOf(Gamepad::DeviceId id) const;
+
+		int m_epoll;
+		int m_inotify;
+		bool m_scanDevices;
+		std::atomic<bool> m_rescan;
+		DeviceRegistry<Device> m_devices;
+		GamepadResponse m_unboundResponse;
+
+	};
+
+}
+
+#endif
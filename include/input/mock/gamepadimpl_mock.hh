@@ -0,0 +1,74 @@
+#ifndef DECAF_INPUT_MOCK_GAMEPADIMPLMOCK_HH_
+#define DECAF_INPUT_MOCK_GAMEPADIMPLMOCK_HH_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "decaf/input/gamepadimpl.hh"
+
+namespace decaf
+{
+
+	/// <summary>A backend fed from code instead of hardware, for benchmarks and headless builds.</summary>
+	/// <remarks>Raw readings use XInput's units and are converted through the pad's response exactly like the hardware backends do.</remarks>
+	class GamepadImpl_Mock : public IGamepadImpl
+	{
+
+	public:
+
+		struct RawState : Gamepad::RawState
+		{
+			bool connected;
+		};
+
+		/// <summary>Produces the raw reading of a pad for a given update. Must be safe to call from the sampler thread.</summary>
+		using Generator = RawState (*)(Gamepad::Index index, uint64_t update, void* context);
+
+	public:
+
+		GamepadImpl_Mock();
+
+		using IGamepadImpl::GetState;
+
+		virtual Gamepad::State GetState(Gamepad::Index index);
+
+		virtual Gamepad::State GetState(Gamepad::Index index, const GamepadResponse& response);
+
+		virtual uint32_t GetStates(Gamepad::State* states, size_t count);
+
+		virtual void SetRumble(Gamepad::Index index, float left, float right);
+
+		/// <summary>Advances the update counter and, if a generator is set, refreshes every pad from it.</summary>
+		virtual void Update();
+
+		/// <summary>Replaces the raw reading of a pad, stamping it as a new packet acquired now.</summary>
+		void SetRawState(Gamepad::Index index, const RawState& raw);
+
+		const RawState& GetRawState(Gamepad::Index index) const;
+
+		/// <summary>Sets a function that scripts the raw readings on every <c>Update</c>. Null stops scripting.</summary>
+		void SetGenerator(Generator generator, void* context = nullptr);
+
+		/// <summary>Gets the last rumble request of a pad.</summary>
+		void GetRumble(Gamepad::Index index, float& left, float& right) const;
+
+		inline uint64_t UpdateCount() const { return m_updates; }
+
+	private:
+
+		/// <summary>Converts a pad's raw reading through its own response. Returns whether it is connected.</summary>
+		bool Convert(Gamepad::Index index, Gamepad::State& gps);
+
+		RawState m_raw[Gamepad::IndexCount];
+		uint32_t m_packet[Gamepad::IndexCount];
+		uint64_t m_timestamp[Gamepad::IndexCount];
+		float m_rumble[Gamepad::IndexCount][2];
+		Generator m_generator;
+		void* m_context;
+		uint64_t m_updates;
+
+	};
+
+}
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef DECAF_INPUT_REMOTE_REMOTESTREAM_HH_
+#define DECAF_INPUT_REMOTE_REMOTESTREAM_HH_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "decaf/input/gamepad.hh"
+#include "decaf/input/remote/statecodec.hh"
+#include "decaf/io/udpsocket.hh"
+
+namespace decaf
+{
+
+	namespace Remote
+	{
+
+		constexpr uint32_t Version = 1;
+
+		/// <summary>The largest datagram either side sends, small enough to avoid fragmentation on any common path.</summary>
+		constexpr size_t MaxDatagram = 1200;
+
+		/// <summary>How many frames each side remembers, and so how stale an acknowledged baseline may get.</summary>
+		constexpr size_t History = 64;
+
+		/// <summary>The most frames one datagram carries.</summary>
+		constexpr size_t MaxFrames = 32;
+
+	}
+
+	/// <summary>Streams pad states to a <c>RemoteReceiver</c> as frames, one per <c>Send</c>.</summary>
+	/// <remarks>Every datagram carries all the frames the receiver has not acknowledged, up to <c>Remote::MaxFrames</c> and
+	/// <c>Remote::MaxDatagram</c>, so a lost datagram is repaired by the next one without retransmission. The first frame is
+	/// delta-encoded against the newest acknowledged frame and each later one against the frame before it; until anything is
+	/// acknowledged, or once the acknowledged frame has left the history, frames are encoded against an all-zero state instead.</remarks>
+	class RemoteSender
+	{
+
+	public:
+
+		RemoteSender();
+
+		/// <summary>Opens a socket and aims it at a receiver.</summary>
+		bool Open(const char* host, uint16_t port, uint16_t localPort = 0);
+
+		void Close();
+
+		/// <summary>Records the states as the next frame, sends the pending frames and reads any acknowledgements.</summary>
+		/// <returns>The number of the new frame, or <c>0</c> if the datagram could not be sent.</returns>
+		uint32_t Send(const Gamepad::State* states, size_t count);
+
+		/// <summary>Records the states of up to <c>Gamepad::IndexCount</c> pads as the next frame. A change in the pad count restarts the stream.</summary>
+		/// <returns>The frame's number. Frames are numbered from 1.</returns>
+		uint32_t Push(const Gamepad::State* states, size_t count);
+
+		/// <summary>Writes the datagram <c>Send</c> would send now.</summary>
+		/// <returns>Its size in bytes, or <c>0</c> if there is no frame yet or <paramref name='capacity'/> is too small for one.</returns>
+		size_t Encode(uint8_t* buffer, size_t capacity) const;
+
+		/// <summary>Notes that the receiver has every frame up to <paramref name='frame'/>. Older and unknown frames are ignored.</summary>
+		void Acknowledge(uint32_t frame);
+
+		/// <summary>Reads acknowledgements from the socket. <c>Send</c> calls this itself.</summary>
+		void ReceiveAcks();
+
+		inline uint32_t CurrentFrame() const { return m_frame; }
+		inline uint32_t AckedFrame() const { return m_acked; }
+		inline size_t LastDatagramSize() const { return m_lastSize; }
+		inline uint64_t BytesSent() const { return m_bytesSent; }
+
+	private:
+
+		size_t EncodeFrom(uint32_t first, uint32_t baseline, uint8_t* buffer, size_t capacity) const;
+
+		UdpSocket m_socket;
+		StateCodec::Quantized m_history[Remote::History][Gamepad::IndexCount];
+		uint32_t m_frame;
+		uint32_t m_acked;
+		uint32_t m_pads;
+		size_t m_lastSize;
+		uint64_t m_bytesSent;
+
+	};
+
+	/// <summary>Receives the frames of a <c>RemoteSender</c> and acknowledges them.</summary>
+	/// <remarks>A datagram whose baseline frame is not in the history is rejected; the sender falls back to an all-zero
+	/// baseline once its acknowledged frame grows too old, so the stream always recovers.</remarks>
+	class RemoteReceiver
+	{
+
+	public:
+
+		RemoteReceiver();
+
+		/// <summary>Binds the socket the sender sends to. The sender's address is learned from its first datagram.</summary>
+		bool Open(const char* address, uint16_t port);
+
+		void Close();
+
+		inline uint16_t LocalPort() const { return m_socket.LocalPort(); }
+
+		/// <summary>Decodes every pending datagram and acknowledges the newest frame.</summary>
+		/// <returns>Whether a newer frame arrived.</returns>
+		bool Update();
+
+		/// <summary>Decodes one datagram written by <c>RemoteSender::Encode</c>.</summary>
+		/// <returns><c>false</c> if it is malformed or its baseline is unknown.</returns>
+		bool Decode(const uint8_t* data, size_t size);
+
+		/// <summary>Gets a pad's state in the newest frame.</summary>
+		inline const Gamepad::State& GetState(Gamepad::Index index) const { return m_states[static_cast<size_t>(index)]; }
+
+		/// <summary>Copies the states of an earlier frame still in the history, e.g. to replay frames a datagram skipped over.</summary>
+		/// <returns><c>false</c> if the frame was never received or has left the history.</returns>
+		bool GetFrame(uint32_t frame, Gamepad::State* states, size_t count) const;
+
+		inline uint32_t LatestFrame() const { return m_latest; }
+		inline size_t PadCount() const { return m_pads; }
+		inline uint64_t RejectedCount() const { return m_rejected; }
+
+	private:
+
+		UdpSocket m_socket;
+		StateCodec::Quantized m_history[Remote::History][Gamepad::IndexCount];
+		uint32_t m_numbers[Remote::History];
+		Gamepad::State m_states[Gamepad::IndexCount];
+		uint32_t m_latest;
+		uint32_t m_pads;
+		uint64_t m_rejected;
+
+	};
+
+}
+
+#endif
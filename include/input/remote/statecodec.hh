@@ -0,0 +1,152 @@
+#ifndef DECAF_INPUT_REMOTE_STATECODEC_HH_
+#define DECAF_INPUT_REMOTE_STATECODEC_HH_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "decaf/input/gamepad.hh"
+
+namespace decaf
+{
+
+	/// <summary>Appends values of any width up to 32 bits to a byte buffer, least significant bit first.</summary>
+	class BitWriter
+	{
+
+	public:
+
+		BitWriter(uint8_t* buffer, size_t capacity)
+			: m_buffer{ buffer }, m_capacity{ capacity }, m_size{ 0 }, m_bits{ 0 }, m_count{ 0 }, m_overflow{ false } { }
+
+		inline void Write(uint32_t value, unsigned bits)
+		{
+			m_bits |= static_cast<uint64_t>(value & (bits < 32 ? (1u << bits) - 1 : 0xffffffffu)) << m_count;
+			m_count += bits;
+
+			while (m_count >= 8)
+			{
+				Put(static_cast<uint8_t>(m_bits));
+				m_bits >>= 8;
+				m_count -= 8;
+			}
+		}
+
+		/// <summary>Writes out the last partial byte. Returns the number of bytes written, or <c>0</c> if the buffer overflowed.</summary>
+		inline size_t Finish()
+		{
+			if (m_count != 0)
+			{
+				Put(static_cast<uint8_t>(m_bits));
+				m_bits = 0;
+				m_count = 0;
+			}
+
+			return m_overflow ? 0 : m_size;
+		}
+
+		/// <summary>Gets the number of bits written so far.</summary>
+		inline size_t BitCount() const { return m_size * 8 + m_count; }
+
+		inline bool Overflowed() const { return m_overflow; }
+
+	private:
+
+		inline void Put(uint8_t byte)
+		{
+			if (m_size < m_capacity)
+				m_buffer[m_size++] = byte;
+			else
+				m_overflow = true;
+		}
+
+		uint8_t* m_buffer;
+		size_t m_capacity;
+		size_t m_size;
+		uint64_t m_bits;
+		unsigned m_count;
+		bool m_overflow;
+
+	};
+
+	/// <summary>Reads back what a <c>BitWriter</c> wrote. Reading past the end yields zeros and sets <c>Overflowed</c>.</summary>
+	class BitReader
+	{
+
+	public:
+
+		BitReader(const uint8_t* buffer, size_t size)
+			: m_buffer{ buffer }, m_size{ size }, m_offset{ 0 }, m_bits{ 0 }, m_count{ 0 }, m_overflow{ false } { }
+
+		inline uint32_t Read(unsigned bits)
+		{
+			while (m_count < bits)
+			{
+				uint64_t byte = 0;
+
+				if (m_offset < m_size)
+					byte = m_buffer[m_offset++];
+				else
+					m_overflow = true;
+
+				m_bits |= byte << m_count;
+				m_count += 8;
+			}
+
+			uint32_t value = static_cast<uint32_t>(m_bits & (bits < 32 ? (uint64_t(1) << bits) - 1 : 0xffffffffu));
+			m_bits >>= bits;
+			m_count -= bits;
+
+			return value;
+		}
+
+		inline bool Overflowed() const { return m_overflow; }
+
+	private:
+
+		const uint8_t* m_buffer;
+		size_t m_size;
+		size_t m_offset;
+		uint64_t m_bits;
+		unsigned m_count;
+		bool m_overflow;
+
+	};
+
+	/// <summary>Packs pad states for the network: quantized back to the precision of the raw readings and delta-encoded against a reference.</summary>
+	/// <remarks>Sticks keep XInput's 16 bits per axis and triggers 8 bits; the 14 defined buttons take 14 bits. A pad that did not change
+	/// costs 1 bit, and a changed field is sent as a zigzag difference in the smallest of a few fixed widths that holds it.</remarks>
+	namespace StateCodec
+	{
+
+		/// <summary>A pad state at wire precision.</summary>
+		struct Quantized
+		{
+			uint16_t buttons;
+			int16_t sticks[4];
+			uint8_t triggers[2];
+			uint8_t connected;
+		};
+
+		/// <summary>The largest encoding of one pad, in bits: a full change of every field.</summary>
+		constexpr size_t MaxPadBits = 1 + 8 + 14 + 4 * (2 + 17) + 2 * (1 + 9);
+
+		void Quantize(const Gamepad::State& state, Quantized& quantized);
+		void Dequantize(const Quantized& quantized, Gamepad::State& state);
+
+		inline bool Equal(const Quantized& a, const Quantized& b)
+		{
+			return a.buttons == b.buttons && a.sticks[0] == b.sticks[0] && a.sticks[1] == b.sticks[1] && a.sticks[2] == b.sticks[2] &&
+				a.sticks[3] == b.sticks[3] && a.triggers[0] == b.triggers[0] && a.triggers[1] == b.triggers[1] && a.connected == b.connected;
+		}
+
+		/// <summary>Writes <paramref name='state'/> as a difference from <paramref name='reference'/>.</summary>
+		void Encode(const Quantized& reference, const Quantized& state, BitWriter& writer);
+
+		/// <summary>Reads a state written by <c>Encode</c> against the same <paramref name='reference'/>.</summary>
+		void Decode(const Quantized& reference, Quantized& state, BitReader& reader);
+
+	}
+
+}
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef DECAF_INPUT_REPLAY_GAMEPADIMPLREPLAY_HH_
+#define DECAF_INPUT_REPLAY_GAMEPADIMPLREPLAY_HH_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "decaf/input/gamepadimpl.hh"
+#include "decaf/input/replay/replayformat.hh"
+#include "decaf/io/mappedfile.hh"
+
+namespace decaf
+{
+
+	/// <summary>A deterministic backend that plays back a file written by <c>GamepadRecorder</c>.</summary>
+	/// <remarks>Each <c>Update</c> advances playback; <c>GetState</c> decodes directly from the mapped file. States are stamped with their recorded
+	/// time after the moment playback started, in either mode, so timing-dependent consumers see the session as it was recorded.
+	/// The recorded states already went through a response curve, so the overloads of <c>GetState</c> taking a deadzone or response return them unchanged.</remarks>
+	class GamepadImpl_Replay : public IGamepadImpl
+	{
+
+	public:
+
+		enum class Mode
+		{
+			REALTIME,
+			UNTHROTTLED
+		};
+
+	public:
+
+		GamepadImpl_Replay();
+		explicit GamepadImpl_Replay(const char* path, Mode mode = Mode::REALTIME);
+
+		/// <summary>Maps a replay file and rewinds playback to its start.</summary>
+		/// <returns><c>false</c> if the file is missing or not a replay.</returns>
+		bool Open(const char* path, Mode mode = Mode::REALTIME);
+
+		/// <summary>Restarts playback from the first record, stamping its states from now on.</summary>
+		void Rewind();
+
+		/// <summary>Gets whether every record has been played back.</summary>
+		bool Finished() const;
+
+		/// <summary>Gets the number of records in the file.</summary>
+		size_t RecordCount() const;
+
+		using IGamepadImpl::GetState;
+
+		virtual Gamepad::State GetState(Gamepad::Index index);
+
+		virtual Gamepad::State GetState(Gamepad::Index index, const GamepadResponse& response);
+
+		virtual uint32_t GetStates(Gamepad::State* states, size_t count);
+
+		virtual void SetRumble(Gamepad::Index index, float left, float right);
+
+		/// <summary>In <c>REALTIME</c> mode applies every record due by now; in <c>UNTHROTTLED</c> mode applies the next timestamp's records.</summary>
+		virtual void Update();
+
+	private:
+
+		void Apply(uint64_t until);
+
+		MappedFile m_file;
+		Mode m_mode;
+		const Replay::Record* m_records;
+		size_t m_count;
+		size_t m_cursor;
+		/// <summary>When playback started on the <c>GamepadEventQueue::Now</c> clock. Record timestamps are offsets from it.</summary>
+		uint64_t m_base;
+		const Replay::Record* m_current[Gamepad::IndexCount];
+
+	};
+
+}
+
+#endif
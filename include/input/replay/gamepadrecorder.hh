@@ -0,0 +1,74 @@
+#ifndef DECAF_INPUT_REPLAY_GAMEPADRECORDER_HH_
+#define DECAF_INPUT_REPLAY_GAMEPADRECORDER_HH_
+
+#include <cstdint>
+#include <cstdio>
+
+#include "decaf/input/gamepadimpl.hh"
+#include "decaf/input/replay/replayformat.hh"
+
+namespace decaf
+{
+
+	/// <summary>A backend decorator that forwards to another backend and appends every state change it sees to a replay file.</summary>
+	/// <remarks>Only the default-deadzone queries (<c>GetState(index)</c> and <c>GetStates</c>) are recorded. Records are stamped with when the source
+	/// acquired each state, relative to the first state recorded, so the file keeps the input's timing rather than the rate it was polled at.</remarks>
+	class GamepadRecorder : public IGamepadImpl
+	{
+
+	public:
+
+		GamepadRecorder(IGamepadImpl* source, const char* path);
+		virtual ~GamepadRecorder();
+
+		GamepadRecorder(const GamepadRecorder&) = delete;
+		GamepadRecorder& operator=(const GamepadRecorder&) = delete;
+
+		bool IsOpen() const;
+
+		void Flush();
+
+		using IGamepadImpl::GetState;
+
+		virtual Gamepad::State GetState(Gamepad::Index index);
+
+		virtual Gamepad::State GetState(Gamepad::Index index, const GamepadResponse& response);
+
+		virtual uint32_t GetStates(Gamepad::State* states, size_t count);
+
+		virtual void SetRumble(Gamepad::Index index, float left, float right);
+
+		virtual void SetResponse(Gamepad::Index index, const GamepadResponse& response);
+
+		virtual void Update();
+
+		virtual void NotifyHotplug();
+
+		/// <summary>Forwarded to the source, which reads the reports.</summary>
+		virtual void SetEventQueue(GamepadEventQueue* events);
+
+		/// <summary>Forwarded to the source. Only the <c>Gamepad::Index</c> slots are recorded.</summary>
+		virtual size_t DeviceCount() const;
+
+		virtual size_t GetDevices(Gamepad::DeviceId* ids, Gamepad::State* states, size_t capacity);
+
+		virtual Gamepad::DeviceId GetDeviceId(Gamepad::Index index) const;
+
+	private:
+
+		void Record(Gamepad::Index index, const Gamepad::State& state);
+
+		IGamepadImpl* m_source;
+		FILE* m_file;
+		/// <summary>The acquisition time of the first state recorded, or <c>0</c> before one.</summary>
+		uint64_t m_origin;
+		/// <summary>The timestamp of the last record written, which later records never go below.</summary>
+		uint64_t m_elapsed;
+		Replay::Record m_last[Gamepad::IndexCount];
+		bool m_written[Gamepad::IndexCount];
+
+	};
+
+}
+
+#endif
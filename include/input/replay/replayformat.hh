@@ -0,0 +1,62 @@
+#ifndef DECAF_INPUT_REPLAY_REPLAYFORMAT_HH_
+#define DECAF_INPUT_REPLAY_REPLAYFORMAT_HH_
+
+#include <cstdint>
+
+#include "decaf/input/gamepad.hh"
+#include "decaf/input/response.hh"
+
+namespace decaf
+{
+
+	namespace Replay
+	{
+
+		constexpr char Magic[4] = { 'D', 'G', 'P', 'R' };
+		/// <summary>Version 2 stores packed <c>Gamepad::RawState</c>s in 24-byte records; version 1 files, with 40-byte float records, are no longer read.</summary>
+		constexpr uint32_t Version = 2;
+
+		/// <summary>The header at the start of every replay file. Records follow immediately after it.</summary>
+		struct Header
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t recordSize;
+			uint32_t reserved;
+		};
+
+		/// <summary>One pad state, stamped with the nanoseconds between its acquisition and that of the first state recorded.</summary>
+		/// <remarks>Records are only written when a pad's state changes and are read straight out of the mapped file. The inputs are
+		/// packed with <c>GamepadResponse::Pack</c> after the recorded pad's curves were applied, and decode through <c>GamepadResponse::Linear</c>.</remarks>
+		struct Record
+		{
+			uint64_t timestamp;
+			Gamepad::RawState state;
+			uint8_t index;
+			uint8_t connected;
+			uint16_t reserved;
+		};
+
+		static_assert(sizeof(Header) == 16, "Replay::Header layout is part of the file format");
+		static_assert(sizeof(Record) == 24, "Replay::Record layout is part of the file format");
+
+		inline void Encode(const Gamepad::State& state, Gamepad::Index index, uint64_t timestamp, Record& record)
+		{
+			record.timestamp = timestamp;
+			GamepadResponse::Pack(state, record.state);
+			record.index = static_cast<uint8_t>(index);
+			record.connected = state.connected ? 1 : 0;
+			record.reserved = 0;
+		}
+
+		inline void Decode(const Record& record, Gamepad::State& state)
+		{
+			GamepadResponse::Linear().Decode(record.state, state);
+			state.connected = (record.connected != 0);
+		}
+
+	}
+
+}
+
+#endif
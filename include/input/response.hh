@@ -0,0 +1,182 @@
+#ifndef DECAF_INPUT_RESPONSE_HH_
+#define DECAF_INPUT_RESPONSE_HH_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "decaf/input/gamepad.hh"
+#include "decaf/math/vector.hh"
+
+namespace decaf
+{
+
+	/// <summary>Describes how the magnitude of a raw axis reading maps onto a normalized value.</summary>
+	struct AxisCurve
+	{
+		enum class Shape
+		{
+			/// <summary>The original XInput mapping: <c>(|n| - deadzone) * n * |n| / (1 - deadzone)</c>. Ignores <c>outerDeadzone</c> and <c>exponent</c>.</summary>
+			XINPUT,
+			/// <summary>Rescales <c>[deadzone, outerDeadzone]</c> onto <c>[0, 1]</c> and raises the result to <c>exponent</c>.</summary>
+			POWER
+		};
+
+		Shape shape;
+		float deadzone;
+		float outerDeadzone;
+		float exponent;
+	};
+
+	/// <summary>A stick response curve compiled into a table indexed by the magnitude of the raw int16 reading.</summary>
+	class StickResponse
+	{
+
+	public:
+
+		static constexpr size_t TableSize = 32769;
+
+		/// <summary>The curve of XInput's default left stick deadzone, built at compile time.</summary>
+		static const StickResponse& XInputLeft();
+
+		/// <summary>The curve of XInput's default right stick deadzone, built at compile time.</summary>
+		static const StickResponse& XInputRight();
+
+		/// <summary>The plain <c>raw / 32767</c> mapping with no deadzone, built at compile time.</summary>
+		static const StickResponse& Linear();
+
+	public:
+
+		StickResponse();
+		explicit StickResponse(const AxisCurve& curve, bool invertX = false, bool invertY = false);
+
+		/// <summary>Gets the compiled table; entry <c>i</c> is the response to a raw reading of magnitude <c>i</c>.</summary>
+		inline const float* Table() const { return m_table; }
+
+		inline bool InvertX() const { return m_invertX; }
+
+		inline bool InvertY() const { return m_invertY; }
+
+		inline float X(int16_t raw) const { return Lookup(raw, m_invertX); }
+
+		inline float Y(int16_t raw) const { return Lookup(raw, m_invertY); }
+
+		inline Vector2f operator () (int16_t x, int16_t y) const
+		{
+			return Vector2f(Lookup(x, m_invertX), Lookup(y, m_invertY));
+		}
+
+	private:
+
+		StickResponse(const float* table);
+
+		inline float Lookup(int16_t raw, bool invert) const
+		{
+			bool negative = (raw < 0);
+			float magnitude = m_table[negative ? -static_cast<int32_t>(raw) : raw];
+
+			// Adding +0 folds the -0 produced by negating a zero entry back to +0, so equal inputs stay bytewise equal.
+			return ((negative != invert) ? -magnitude : magnitude) + 0.0f;
+		}
+
+		const float* m_table;
+		std::shared_ptr<const std::vector<float>> m_storage;
+		bool m_invertX;
+		bool m_invertY;
+
+	};
+
+	/// <summary>A trigger response curve compiled into a table indexed by the raw uint8 reading.</summary>
+	class TriggerResponse
+	{
+
+	public:
+
+		static constexpr size_t TableSize = 256;
+
+		/// <summary>The plain <c>raw / 255</c> mapping XInput triggers have always used.</summary>
+		static const TriggerResponse& Linear();
+
+	public:
+
+		TriggerResponse();
+		explicit TriggerResponse(const AxisCurve& curve);
+
+		inline const float* Table() const { return m_table.data(); }
+
+		inline float operator () (uint8_t raw) const
+		{
+			return m_table[raw];
+		}
+
+	private:
+
+		std::array<float, TableSize> m_table;
+
+	};
+
+	/// <summary>The complete set of response curves used to turn a raw pad report into a <c>Gamepad::State</c>.</summary>
+	struct GamepadResponse
+	{
+		StickResponse leftStick;
+		StickResponse rightStick;
+		TriggerResponse leftTrigger;
+		TriggerResponse rightTrigger;
+
+		/// <summary>Converts the inputs of a raw reading. Leaves <c>connected</c>, <c>packet</c> and <c>timestamp</c> alone.</summary>
+		inline void Decode(const Gamepad::RawState& raw, Gamepad::State& state) const
+		{
+			state.leftStick = leftStick(raw.thumbLX, raw.thumbLY);
+			state.rightStick = rightStick(raw.thumbRX, raw.thumbRY);
+			state.leftTrigger = leftTrigger(raw.leftTrigger);
+			state.rightTrigger = rightTrigger(raw.rightTrigger);
+			state.buttons = raw.buttons;
+		}
+
+		/// <summary>XInput's default deadzones, matching what the backends have always reported.</summary>
+		static const GamepadResponse& XInput();
+
+		/// <summary>The number of deadzones <c>XInput(float)</c> keeps tables for on each thread.</summary>
+		static constexpr size_t XInputCacheSize = 8;
+
+		/// <summary>The XInput curve with the same <paramref name='deadzone'/> on both sticks.</summary>
+		/// <remarks>Tables are cached per thread for the last <c>XInputCacheSize</c> distinct deadzones, so callers cycling through a few values build each
+		/// table once. The reference stays valid until that many other deadzones have been requested on the thread.</remarks>
+		static const GamepadResponse& XInput(float deadzone);
+
+		/// <summary>Linear sticks and triggers with no deadzone, the input expected by the radial deadzone modes.</summary>
+		static const GamepadResponse& Linear();
+
+		/// <summary>Packs converted inputs at the resolution <c>Linear</c> decodes, the inverse of <c>Linear().Decode</c>: a linear pad's readings come back unchanged.</summary>
+		/// <remarks>This is how <c>Gamepad</c> stores its states and how replays record them. Out-of-range values are clamped.</remarks>
+		static inline void Pack(const Gamepad::State& state, Gamepad::RawState& raw)
+		{
+			raw.thumbLX = PackStick(state.leftStick[0]);
+			raw.thumbLY = PackStick(state.leftStick[1]);
+			raw.thumbRX = PackStick(state.rightStick[0]);
+			raw.thumbRY = PackStick(state.rightStick[1]);
+			raw.leftTrigger = PackTrigger(state.leftTrigger);
+			raw.rightTrigger = PackTrigger(state.rightTrigger);
+			raw.buttons = state.buttons;
+		}
+
+	private:
+
+		static inline int16_t PackStick(float value)
+		{
+			value = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+			return static_cast<int16_t>(value * 32767.0f + (value < 0.0f ? -0.5f : 0.5f));
+		}
+
+		static inline uint8_t PackTrigger(float value)
+		{
+			value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+			return static_cast<uint8_t>(value * 255.0f + 0.5f);
+		}
+	};
+
+}
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef DECAF_INPUT_RESPONSEBATCH_HH_
+#define DECAF_INPUT_RESPONSEBATCH_HH_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "decaf/input/response.hh"
+
+namespace decaf
+{
+
+	namespace Response
+	{
+
+		enum class Kernel
+		{
+			SCALAR,
+			SSE2,
+			AVX2
+		};
+
+		/// <summary>Gets the kernel the batch conversions currently dispatch to.</summary>
+		Kernel ActiveKernel();
+
+		/// <summary>Forces a kernel, e.g. to compare them. Kernels the CPU does not support fall back to the best one it does.</summary>
+		/// <returns>The kernel actually selected.</returns>
+		Kernel SelectKernel(Kernel kernel);
+
+		/// <summary>Converts one axis of <paramref name='count'/> raw stick samples. The results are bitwise identical to <c>StickResponse::X</c> / <c>Y</c>.</summary>
+		/// <param name='invert'>Whether to apply the response's inversion for this axis.</param>
+		void ConvertAxis(const StickResponse& response, bool invert, const int16_t* raw, float* out, size_t count);
+
+		/// <summary>Converts <paramref name='count'/> raw stick samples stored as separate X and Y arrays.</summary>
+		void ConvertStick(const StickResponse& response, const int16_t* rawX, const int16_t* rawY, float* outX, float* outY, size_t count);
+
+		/// <summary>Converts <paramref name='count'/> raw trigger samples. The results are bitwise identical to <c>TriggerResponse::operator()</c>.</summary>
+		void ConvertTrigger(const TriggerResponse& response, const uint8_t* raw, float* out, size_t count);
+
+	}
+
+}
+
+#endif
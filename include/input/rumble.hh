@@ -0,0 +1,138 @@
+#ifndef DECAF_INPUT_RUMBLE_HH_
+#define DECAF_INPUT_RUMBLE_HH_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "decaf/input/gamepad.hh"
+
+namespace decaf
+{
+
+	class IGamepadImpl;
+
+	/// <summary>A rumble effect with an attack/sustain/decay envelope. Durations are in nanoseconds.</summary>
+	struct RumbleEffect
+	{
+		/// <summary>A sustain that lasts until the effect is stopped.</summary>
+		static constexpr uint64_t Forever = UINT64_MAX;
+
+		/// <summary>The peak strength of the low-frequency (left) motor, from 0 to 1.</summary>
+		float left;
+		/// <summary>The peak strength of the high-frequency (right) motor, from 0 to 1.</summary>
+		float right;
+		/// <summary>How long the effect ramps up from zero to its peak.</summary>
+		uint64_t attack;
+		/// <summary>How long the effect holds its peak, or <c>Forever</c>.</summary>
+		uint64_t sustain;
+		/// <summary>How long the effect ramps down from its peak to zero.</summary>
+		uint64_t decay;
+		/// <summary>Only the effects sharing the highest priority playing on a pad are heard. Levels set through <c>SetLevel</c> have priority 0.</summary>
+		int32_t priority;
+	};
+
+	/// <summary>Mixes rumble effects per pad and publishes the resulting motor speeds for the thread that owns the backend to submit.</summary>
+	/// <remarks>Every method but <c>Submit</c> may be called from any thread. <c>Submit</c> must only be called by the thread that owns the backend,
+	/// i.e. the one calling its <c>Update</c> and reads, since backends may reorganise their devices while reading.
+	/// The mix of a pad is recomputed whenever its effects change and on every <c>Tick</c>, and is only published when its 16-bit motor speeds differ from the last ones published.
+	/// Submission is latest-value-wins: a pad whose mix changes several times between two <c>Submit</c> calls is written at most once, and not at all
+	/// if it ends up where the last write to the same backend left it. Without the sampler, <c>Gamepad::Update</c> submits on the game thread, so a
+	/// driver that blocks in <c>XInputSetState</c> or an evdev <c>write</c> stalls the frame, at most once per changed pad per update. Sampling moves
+	/// submission, and any stall, to the sampler thread; a dedicated rumble thread would instead call into the backend while another thread reads it.</remarks>
+	class RumbleMixer
+	{
+
+	public:
+
+		/// <summary>The number of effects that can play on one pad at once.</summary>
+		static constexpr size_t MaxEffects = 16;
+
+	public:
+
+		RumbleMixer();
+
+		RumbleMixer(const RumbleMixer&) = delete;
+		RumbleMixer& operator=(const RumbleMixer&) = delete;
+
+		/// <summary>Starts an effect on a pad.</summary>
+		/// <returns>A handle for <c>Stop</c>, or <c>0</c> if the pad already plays <c>MaxEffects</c> effects of at least the same priority.</returns>
+		uint32_t Play(Gamepad::Index index, const RumbleEffect& effect, uint64_t now);
+
+		/// <summary>Stops an effect before its envelope ends. Stale handles are ignored.</summary>
+		void Stop(uint32_t handle, uint64_t now);
+
+		/// <summary>Stops every effect playing on a pad and zeroes its level.</summary>
+		void StopAll(Gamepad::Index index, uint64_t now);
+
+		/// <summary>Sets a constant priority-0 level under a pad's effects, which is what <c>Gamepad::SetRumble</c> drives.</summary>
+		void SetLevel(Gamepad::Index index, float left, float right, uint64_t now);
+
+		/// <summary>Advances every envelope to <paramref name='now'/>, retires finished effects and publishes any pad whose mix changed.</summary>
+		void Tick(uint64_t now);
+
+		/// <summary>Hands every mix published since the last call to <paramref name='impl'/>, skipping pads whose motors already run at it. Only call it from the thread that owns the backend.</summary>
+		void Submit(IGamepadImpl& impl);
+
+		/// <summary>Waits for the thread owning the backend to submit every published mix.</summary>
+		/// <returns><c>false</c> if mixes were still pending after <paramref name='timeout'/>.</returns>
+		bool Flush(std::chrono::microseconds timeout);
+
+		/// <summary>Checks whether any published mix has not been submitted yet.</summary>
+		bool IsPending() const;
+
+		/// <summary>Gets the mix last published for a pad.</summary>
+		void GetMix(Gamepad::Index index, float& left, float& right) const;
+
+		/// <summary>Gets the number of backend <c>SetRumble</c> calls made so far.</summary>
+		uint64_t SubmitCount() const;
+
+		/// <summary>Gets the envelope level of an effect, from 0 to 1, <paramref name='elapsed'/> nanoseconds after it started. Negative once it has finished.</summary>
+		static float Envelope(const RumbleEffect& effect, uint64_t elapsed);
+
+	private:
+
+		struct Voice
+		{
+			RumbleEffect effect;
+			uint64_t start;
+			uint32_t handle;
+		};
+
+		struct Pad
+		{
+			Voice voices[MaxEffects];
+			size_t count;
+			float level[2];
+			uint16_t mixed[2];
+		};
+
+		/// <summary>Set in a pending mix until it is submitted. The low 32 bits hold the left and right motor speeds.</summary>
+		static constexpr uint64_t Dirty = uint64_t(1) << 32;
+
+		/// <summary>Marks a pad whose motor speeds on the current backend are unknown; never equal to a mix.</summary>
+		static constexpr uint64_t Unwritten = ~uint64_t(0);
+
+		void Mix(size_t slot, uint64_t now);
+
+		mutable std::mutex m_mutex;
+		Pad m_pads[Gamepad::IndexCount];
+		uint32_t m_serial;
+
+		// Held across backend calls, so Flush knows a cleared mix has also reached the driver. Mixing never takes it.
+		std::mutex m_submitMutex;
+		std::condition_variable m_submitted;
+		std::atomic<uint64_t> m_pending[Gamepad::IndexCount];
+		std::atomic<uint64_t> m_submits;
+		// The speeds last written to each pad of m_target. Only touched under m_submitMutex.
+		IGamepadImpl* m_target;
+		uint64_t m_written[Gamepad::IndexCount];
+
+	};
+
+}
+
+#endif
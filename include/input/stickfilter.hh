@@ -0,0 +1,117 @@
+#ifndef DECAF_INPUT_STICKFILTER_HH_
+#define DECAF_INPUT_STICKFILTER_HH_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "decaf/input/gamepad.hh"
+
+namespace decaf
+{
+
+	/// <summary>Selects how a stick is smoothed over time, and how far ahead it is extrapolated.</summary>
+	struct StickFilterSettings
+	{
+		enum class Mode
+		{
+			/// <summary>Pass samples through unfiltered.</summary>
+			NONE,
+			/// <summary>The One Euro filter: a low-pass whose cutoff rises with speed, so a resting stick is steady and a moving one barely lags.</summary>
+			ONE_EURO,
+			/// <summary>A critically damped spring chasing the samples: settles in about <c>smoothTime</c> without overshooting.</summary>
+			CRITICALLY_DAMPED
+		};
+
+		Mode mode;
+		/// <summary>One Euro: the cutoff at rest, in Hz. Lower removes more jitter from a resting stick.</summary>
+		float minCutoff;
+		/// <summary>One Euro: how much the cutoff rises per unit per second of speed. Higher lags less during fast moves.</summary>
+		float beta;
+		/// <summary>Critically damped: roughly how long the spring takes to settle, in seconds.</summary>
+		float smoothTime;
+		/// <summary>How far past the sample to extrapolate along the filtered velocity, in seconds, e.g. the expected time until display. <c>0</c> disables prediction.</summary>
+		float lead;
+
+		static StickFilterSettings None()
+		{
+			return { Mode::NONE, 0.0f, 0.0f, 0.0f, 0.0f };
+		}
+
+		static StickFilterSettings OneEuro(float minCutoff = 1.0f, float beta = 20.0f, float lead = 0.0f)
+		{
+			return { Mode::ONE_EURO, minCutoff, beta, 0.0f, lead };
+		}
+
+		static StickFilterSettings CriticallyDamped(float smoothTime = 0.02f, float lead = 0.0f)
+		{
+			return { Mode::CRITICALLY_DAMPED, 0.0f, 0.0f, smoothTime, lead };
+		}
+	};
+
+	/// <summary>Filters both sticks of every pad, keeping each axis's filter state in flat per-lane arrays.</summary>
+	/// <remarks>A lane is one axis of one stick of one pad. All lanes run the same branch-free arithmetic, and their modes are blended
+	/// with per-lane weights, so a batch of pads is filtered in one pass the compiler vectorizes. Filters advance by the time between
+	/// the <c>now</c> of successive calls for a pad, not by the samples' timestamps, so a held stick keeps converging on its sample
+	/// however long the device stays silent; a call no later than the previous one for its pad returns the last output again.
+	/// While every lane is <c>NONE</c> without prediction, <c>Apply</c> returns at once. Not thread-safe.</remarks>
+	class StickFilter
+	{
+
+	public:
+
+		/// <summary>Two sticks of two axes for every pad.</summary>
+		static constexpr size_t Lanes = Gamepad::IndexCount * 4;
+
+	public:
+
+		StickFilter();
+
+		/// <summary>Sets the filters of a pad's sticks and restarts them from the next sample.</summary>
+		void SetSettings(Gamepad::Index index, const StickFilterSettings& left, const StickFilterSettings& right);
+
+		const StickFilterSettings& GetSettings(Gamepad::Index index, bool right) const { return m_settings[static_cast<size_t>(index) * 2 + (right ? 1 : 0)]; }
+
+		/// <summary>Gets whether any pad has a filter or prediction.</summary>
+		inline bool IsActive() const { return m_active != 0; }
+
+		/// <summary>Gets whether a pad's filtered sticks have caught up with its last sample and stopped moving.</summary>
+		/// <remarks>Until then, filtering the same sample again still changes the output, so callers must not skip it.</remarks>
+		inline bool IsSettled(Gamepad::Index index) const { return ((m_active & ~m_settled) & (1u << static_cast<size_t>(index))) == 0; }
+
+		/// <summary>Restarts a pad's filters from the next sample, e.g. after it reconnects.</summary>
+		void Reset(Gamepad::Index index);
+
+		/// <summary>Filters the sticks of <c>states[i]</c> as pad <c>i</c>, for up to <c>Gamepad::IndexCount</c> states, in one pass.</summary>
+		/// <param name='now'>The time of the poll, in nanoseconds on the <c>GamepadEventQueue::Now</c> clock.</param>
+		void Apply(Gamepad::State* states, size_t count, uint64_t now);
+
+		/// <summary>Filters the sticks of one pad's state.</summary>
+		/// <param name='now'>The time of the poll, in nanoseconds on the <c>GamepadEventQueue::Now</c> clock.</param>
+		void Apply(Gamepad::Index index, Gamepad::State& state, uint64_t now);
+
+	private:
+
+		void Run(size_t first, size_t pads, Gamepad::State* states, uint64_t now);
+
+		alignas(16) float m_value[Lanes];
+		alignas(16) float m_velocity[Lanes];
+		alignas(16) float m_raw[Lanes];
+
+		alignas(16) float m_minCutoff[Lanes];
+		alignas(16) float m_beta[Lanes];
+		alignas(16) float m_omega[Lanes];
+		alignas(16) float m_lead[Lanes];
+		alignas(16) float m_oneEuro[Lanes];
+		alignas(16) float m_damped[Lanes];
+
+		StickFilterSettings m_settings[Gamepad::IndexCount * 2];
+		uint64_t m_time[Gamepad::IndexCount];
+		bool m_primed[Gamepad::IndexCount];
+		uint32_t m_active;
+		uint32_t m_settled;
+
+	};
+
+}
+
+#endif
@@ -3,6 +3,8 @@
 
 #include "decaf/input/gamepadimpl.hh"
 
+struct _XINPUT_STATE;
+
 namespace decaf
 {
 
@@ -11,12 +13,24 @@ namespace decaf
 
 	public:
 
+		using IGamepadImpl::GetState;
+
 		virtual Gamepad::State GetState(Gamepad::Index index);
 
-		virtual Gamepad::State GetState(Gamepad::Index index, float deadzone);
+		virtual Gamepad::State GetState(Gamepad::Index index, const GamepadResponse& response);
+
+		virtual uint32_t GetStates(Gamepad::State* states, size_t count);
 
 		virtual void SetRumble(Gamepad::Index index, float left, float right);
 
+	private:
+
+		/// <summary>Reads a pad unless it is an empty slot still in backoff, and updates the connection cache.</summary>
+		bool Probe(Gamepad::Index index, _XINPUT_STATE& xis);
+
+		/// <summary>Converts a read through the pad's own response, stamped with the time its packet number first appeared. A repeated packet returns the cached conversion.</summary>
+		void Convert(Gamepad::Index index, const _XINPUT_STATE& xis, Gamepad::State& gps);
+
 	};
 
 }
@@ -0,0 +1,47 @@
+#ifndef DECAF_IO_MAPPEDFILE_HH_
+#define DECAF_IO_MAPPEDFILE_HH_
+
+#include <cstddef>
+
+namespace decaf
+{
+
+	/// <summary>A read-only view of a whole file mapped into memory.</summary>
+	class MappedFile
+	{
+
+	public:
+
+		MappedFile();
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/// <summary>Maps <paramref name='path'/>, replacing any file mapped before.</summary>
+		/// <returns><c>true</c> if the file could be opened and mapped.</returns>
+		bool Open(const char* path);
+
+		void Close();
+
+		bool IsOpen() const;
+
+		const unsigned char* Data() const;
+
+		size_t Size() const;
+
+	private:
+
+		const unsigned char* m_data;
+		size_t m_size;
+
+#if defined (_WIN32)
+		void* m_file;
+		void* m_mapping;
+#endif
+
+	};
+
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef DECAF_IO_UDPSOCKET_HH_
+#define DECAF_IO_UDPSOCKET_HH_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace decaf
+{
+
+	/// <summary>A non-blocking IPv4 UDP socket that talks to one peer at a time.</summary>
+	class UdpSocket
+	{
+
+	public:
+
+		UdpSocket();
+		~UdpSocket();
+
+		UdpSocket(const UdpSocket&) = delete;
+		UdpSocket& operator=(const UdpSocket&) = delete;
+
+		/// <summary>Binds a socket, replacing any opened before.</summary>
+		/// <param name='address'>The numeric address to bind, e.g. <c>"127.0.0.1"</c>, or null for every interface.</param>
+		/// <param name='port'>The port to bind, or <c>0</c> to let the system pick one.</param>
+		/// <returns><c>true</c> if the socket could be created and bound.</returns>
+		bool Open(const char* address = nullptr, uint16_t port = 0);
+
+		void Close();
+
+		bool IsOpen() const;
+
+		/// <summary>Gets the port the socket is bound to, or <c>0</c>.</summary>
+		uint16_t LocalPort() const;
+
+		/// <summary>Sets where <c>Send</c> goes. Until a peer is set, the first datagram received sets it.</summary>
+		/// <returns><c>false</c> if <paramref name='host'/> cannot be resolved.</returns>
+		bool SetPeer(const char* host, uint16_t port);
+
+		bool HasPeer() const;
+
+		/// <summary>Sends one datagram to the peer.</summary>
+		/// <returns><c>false</c> if there is no peer or the datagram could not be queued.</returns>
+		bool Send(const void* data, size_t size);
+
+		/// <summary>Takes one pending datagram, truncated to <paramref name='capacity'/>, without blocking.</summary>
+		/// <returns>The datagram's size, or <c>-1</c> if none is pending.</returns>
+		int Receive(void* data, size_t capacity);
+
+	private:
+
+#if defined (_WIN32)
+		uintptr_t m_socket;
+#else
+		int m_socket;
+#endif
+		uint32_t m_peerAddress;
+		uint16_t m_peerPort;
+		bool m_hasPeer;
+
+	};
+
+}
+
+#endif
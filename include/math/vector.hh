@@ -5,62 +5,287 @@
 #include <array>
 #include <string>
 #include <cmath>
+#include <type_traits>
+
+#if !defined (DECAF_MATH_NO_SIMD) && (defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+#define DECAF_MATH_SSE 1
+#include <emmintrin.h>
+#endif
 
 namespace decaf
 {
 
-	/// <summary>A templated class representing an n-dimensional geometric vector.</summary>
+	/// <summary>Describes how a <c>VectorN</c> of a given type and size is laid out in memory.</summary>
+	/// <remarks><c>Vector3f</c> is padded to four lanes and <c>Vector3f</c>/<c>Vector4f</c> are 16-byte aligned on every platform,
+	/// so their layout does not depend on whether the SSE paths are compiled in. The padding lane is kept at zero.</remarks>
 	template <typename T, size_t S>
-	class VectorN
+	struct VectorStorage
+	{
+		static constexpr size_t Lanes = S;
+		static constexpr size_t Alignment = alignof(T);
+		static constexpr bool Simd = false;
+	};
+
+	template <>
+	struct VectorStorage<float, 3>
+	{
+		static constexpr size_t Lanes = 4;
+		static constexpr size_t Alignment = 16;
+#if defined (DECAF_MATH_SSE)
+		static constexpr bool Simd = true;
+#else
+		static constexpr bool Simd = false;
+#endif
+	};
+
+	template <>
+	struct VectorStorage<float, 4>
+	{
+		static constexpr size_t Lanes = 4;
+		static constexpr size_t Alignment = 16;
+#if defined (DECAF_MATH_SSE)
+		static constexpr bool Simd = true;
+#else
+		static constexpr bool Simd = false;
+#endif
+	};
+
+	/// <summary>The base of every vector-valued expression node, evaluated lane by lane in a single pass into a <c>VectorN</c>.</summary>
+	/// <remarks>Nodes may hold references to the vectors they were built from, so they are an implementation detail: the public operators return
+	/// evaluated <c>VectorN</c> values, which are safe to keep in <c>auto</c> and to call members on, e.g. <c>(a + b).Length()</c>.</remarks>
+	template <typename E, typename T, size_t S>
+	class VectorExpression
 	{
 
 	public:
 
-		VectorN() 
-		{ 
-			std::fill(m_data.begin(), m_data.end(), T(0));
+		constexpr inline const E& Self() const
+		{
+			return static_cast<const E&>(*this);
 		}
 
-		VectorN(const VectorN<T, S>& other)
+	};
+
+	template <typename T, size_t S>
+	class VectorN;
+
+	/// <summary>Selects how an expression node stores an operand: vectors by reference, intermediate nodes by value.</summary>
+	template <typename E>
+	struct VectorOperand
+	{
+		using Type = const E;
+	};
+
+	template <typename T, size_t S>
+	struct VectorOperand<VectorN<T, S>>
+	{
+		using Type = const VectorN<T, S>&;
+	};
+
+	namespace VectorOps
+	{
+
+		struct Add
+		{
+			template <typename T> static constexpr inline T Apply(T lhs, T rhs) { return lhs + rhs; }
+#if defined (DECAF_MATH_SSE)
+			static inline __m128 Apply(__m128 lhs, __m128 rhs) { return _mm_add_ps(lhs, rhs); }
+#endif
+		};
+
+		struct Subtract
+		{
+			template <typename T> static constexpr inline T Apply(T lhs, T rhs) { return lhs - rhs; }
+#if defined (DECAF_MATH_SSE)
+			static inline __m128 Apply(__m128 lhs, __m128 rhs) { return _mm_sub_ps(lhs, rhs); }
+#endif
+		};
+
+		struct Multiply
+		{
+			template <typename T> static constexpr inline T Apply(T lhs, T rhs) { return lhs * rhs; }
+#if defined (DECAF_MATH_SSE)
+			static inline __m128 Apply(__m128 lhs, __m128 rhs) { return _mm_mul_ps(lhs, rhs); }
+#endif
+		};
+
+		struct Divide
+		{
+			template <typename T> static constexpr inline T Apply(T lhs, T rhs) { return lhs / rhs; }
+#if defined (DECAF_MATH_SSE)
+			static inline __m128 Apply(__m128 lhs, __m128 rhs) { return _mm_div_ps(lhs, rhs); }
+#endif
+		};
+
+		struct Minimum
+		{
+			template <typename T> static constexpr inline T Apply(T lhs, T rhs) { return std::min(lhs, rhs); }
+#if defined (DECAF_MATH_SSE)
+			static inline __m128 Apply(__m128 lhs, __m128 rhs) { return _mm_min_ps(lhs, rhs); }
+#endif
+		};
+
+		struct Maximum
+		{
+			template <typename T> static constexpr inline T Apply(T lhs, T rhs) { return std::max(lhs, rhs); }
+#if defined (DECAF_MATH_SSE)
+			static inline __m128 Apply(__m128 lhs, __m128 rhs) { return _mm_max_ps(lhs, rhs); }
+#endif
+		};
+
+		struct Negate
 		{
-			Assign(other);
+			template <typename T> static constexpr inline T Apply(T value) { return -value; }
+#if defined (DECAF_MATH_SSE)
+			static inline __m128 Apply(__m128 value) { return _mm_xor_ps(value, _mm_set1_ps(-0.0f)); }
+#endif
+		};
+
+#if defined (DECAF_MATH_SSE)
+		inline float HorizontalSum(__m128 value)
+		{
+			__m128 shuffled = _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1));
+			__m128 sums = _mm_add_ps(value, shuffled);
+			shuffled = _mm_movehl_ps(shuffled, sums);
+			return _mm_cvtss_f32(_mm_add_ss(sums, shuffled));
 		}
+#endif
+
+	}
+
+	/// <summary>An expression node broadcasting a scalar to every lane.</summary>
+	template <typename T, size_t S>
+	class VectorScalar : public VectorExpression<VectorScalar<T, S>, T, S>
+	{
+
+	public:
+
+		constexpr explicit VectorScalar(T value) : m_value(value) { }
+
+		constexpr inline T operator [] (size_t) const { return m_value; }
+
+#if defined (DECAF_MATH_SSE)
+		inline __m128 Packet() const { return _mm_set1_ps(m_value); }
+#endif
+
+	private:
+
+		T m_value;
+
+	};
+
+	/// <summary>An expression node applying <c>Op</c> lane by lane to one operand.</summary>
+	template <typename Op, typename E, typename T, size_t S>
+	class VectorUnary : public VectorExpression<VectorUnary<Op, E, T, S>, T, S>
+	{
+
+	public:
+
+		constexpr explicit VectorUnary(const E& operand) : m_operand(operand) { }
+
+		constexpr inline T operator [] (size_t i) const { return Op::Apply(m_operand[i]); }
+
+#if defined (DECAF_MATH_SSE)
+		inline __m128 Packet() const { return Op::Apply(m_operand.Packet()); }
+#endif
+
+	private:
+
+		typename VectorOperand<E>::Type m_operand;
+
+	};
+
+	/// <summary>An expression node applying <c>Op</c> lane by lane to two operands.</summary>
+	template <typename Op, typename L, typename R, typename T, size_t S>
+	class VectorBinary : public VectorExpression<VectorBinary<Op, L, R, T, S>, T, S>
+	{
+
+	public:
+
+		constexpr VectorBinary(const L& lhs, const R& rhs) : m_lhs(lhs), m_rhs(rhs) { }
 
-		VectorN(T fill)
+		constexpr inline T operator [] (size_t i) const { return Op::Apply(m_lhs[i], m_rhs[i]); }
+
+#if defined (DECAF_MATH_SSE)
+		inline __m128 Packet() const { return Op::Apply(m_lhs.Packet(), m_rhs.Packet()); }
+#endif
+
+	private:
+
+		typename VectorOperand<L>::Type m_lhs;
+		typename VectorOperand<R>::Type m_rhs;
+
+	};
+
+	/// <summary>A templated class representing an n-dimensional geometric vector.</summary>
+	template <typename T, size_t S>
+	class VectorN : public VectorExpression<VectorN<T, S>, T, S>
+	{
+
+	public:
+
+		using Storage = VectorStorage<T, S>;
+
+		constexpr VectorN() : m_data{} { }
+
+		VectorN(const VectorN<T, S>& other) = default;
+
+		constexpr VectorN(T fill) : m_data{}
 		{
 			Assign(fill);
 		}
 
-		inline VectorN<T, S>& operator = (const VectorN<T, S>& other)
+		template <typename E>
+		constexpr VectorN(const VectorExpression<E, T, S>& expression) : m_data{}
 		{
-			Assign(other);
-			return *this;
+			Evaluate(expression.Self());
 		}
 
-		inline VectorN<T, S>& operator = (T fill)
+		VectorN<T, S>& operator = (const VectorN<T, S>& other) = default;
+
+		constexpr inline VectorN<T, S>& operator = (T fill)
 		{
 			Assign(fill);
 			return *this;
 		}
 
-		inline T& operator [] (size_t i)
+		template <typename E>
+		constexpr inline VectorN<T, S>& operator = (const VectorExpression<E, T, S>& expression)
+		{
+			Evaluate(expression.Self());
+			return *this;
+		}
+
+		constexpr inline T& operator [] (size_t i)
 		{
 			return m_data[i];
 		}
 
-		inline const T& operator [] (size_t i) const
+		constexpr inline const T& operator [] (size_t i) const
 		{
 			return m_data[i];
 		}
 
+#if defined (DECAF_MATH_SSE)
+		inline __m128 Packet() const
+		{
+			return _mm_load_ps(m_data.data());
+		}
+#endif
+
 		/// <summary>Calculates the squared length of the <c>VectorN</c>.</summary>
 		/// <returns>The squared length of the <c>VectorN</c>.</summary>
 		inline T LengthSquared() const
 		{
+#if defined (DECAF_MATH_SSE)
+			if constexpr (Storage::Simd)
+				return VectorOps::HorizontalSum(_mm_mul_ps(Packet(), Packet()));
+#endif
+
 			T result = 0;
 
-			for (auto elem : m_data)
-				result += (elem * elem);
+			for (size_t i = 0; i < S; ++i)
+				result += (m_data[i] * m_data[i]);
 
 			return result;
 		}
@@ -72,6 +297,20 @@ namespace decaf
 			return static_cast<T>(sqrt(LengthSquared()));
 		}
 
+		/// <summary>Calculates the length of the <c>VectorN</c> from an approximate reciprocal square root.</summary>
+		/// <remarks>For <c>float</c> vectors the estimate is refined with one Newton-Raphson step (about 22 bits of precision); other types fall back to <c>Length</c>.</remarks>
+		/// <returns>The approximate length of the <c>VectorN</c>.</returns>
+		inline T LengthFast() const
+		{
+			T lengthSquared = LengthSquared();
+
+			// The reciprocal square root of zero is infinite, which would make a zero vector's length NaN.
+			if (lengthSquared <= T(0))
+				return T(0);
+
+			return lengthSquared * ReciprocalSqrt(lengthSquared);
+		}
+
 		/// <summary>Normalizes the <c>VectorN</c>.</summary>
 		/// <returns>A reference to the normalized <c>VectorN</c>.</summary>
 		inline VectorN<T, S>& Normalize()
@@ -84,20 +323,76 @@ namespace decaf
 			return *this;
 		}
 
+		/// <summary>Normalizes the <c>VectorN</c> using an approximate reciprocal square root, trading precision for speed.</summary>
+		/// <returns>A reference to the normalized <c>VectorN</c>.</returns>
+		inline VectorN<T, S>& NormalizeFast()
+		{
+			T scale = ReciprocalSqrt(LengthSquared());
+
+#if defined (DECAF_MATH_SSE)
+			if constexpr (Storage::Simd)
+			{
+				_mm_store_ps(m_data.data(), _mm_mul_ps(Packet(), _mm_set1_ps(scale)));
+				return *this;
+			}
+#endif
+
+			for (size_t i = 0; i < S; ++i)
+				m_data[i] *= scale;
+
+			return *this;
+		}
+
 	protected:
 
-		std::array<T, S> m_data;
+		alignas(Storage::Alignment) std::array<T, Storage::Lanes> m_data;
 
 	private:
 
-		inline void Assign(const VectorN<T, S>& other)
+		constexpr inline void Assign(T fill)
 		{
-			std::copy(other.m_data.begin(), other.m_data.end(), m_data.begin());
+			for (size_t i = 0; i < S; ++i)
+				m_data[i] = fill;
 		}
 
-		inline void Assign(T fill)
+		template <typename E>
+		constexpr inline void Evaluate(const E& expression)
 		{
-			std::fill(m_data.begin(), m_data.end(), fill);
+#if defined (DECAF_MATH_SSE)
+			if constexpr (Storage::Simd)
+			{
+				__m128 packet = expression.Packet();
+
+				// Keep the padding lane of Vector3f at zero whatever the expression did to it.
+				if constexpr (S == 3)
+					packet = _mm_and_ps(packet, _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1)));
+
+				_mm_store_ps(m_data.data(), packet);
+				return;
+			}
+#endif
+
+			for (size_t i = 0; i < S; ++i)
+				m_data[i] = expression[i];
+		}
+
+		static inline T ReciprocalSqrt(T value)
+		{
+#if defined (DECAF_MATH_SSE)
+			if constexpr (std::is_same<T, float>::value)
+			{
+				__m128 x = _mm_set_ss(value);
+				__m128 y = _mm_rsqrt_ss(x);
+
+				// y' = y * (1.5 - 0.5 * x * y * y)
+				__m128 half = _mm_mul_ss(_mm_set_ss(0.5f), x);
+				y = _mm_mul_ss(y, _mm_sub_ss(_mm_set_ss(1.5f), _mm_mul_ss(half, _mm_mul_ss(y, y))));
+
+				return _mm_cvtss_f32(y);
+			}
+#endif
+
+			return static_cast<T>(1 / sqrt(value));
 		}
 
 	};
@@ -109,25 +404,28 @@ namespace decaf
 
 	public:
 
-		Vector2() : VectorN<T, 2>() { }
+		constexpr Vector2() : VectorN<T, 2>() { }
+
+		constexpr Vector2(const VectorN<T, 2>& other) : VectorN<T, 2>(other) { }
 
-		Vector2(const VectorN<T, 2>& other) : VectorN<T, 2>(other) { }
+		template <typename E>
+		constexpr Vector2(const VectorExpression<E, T, 2>& expression) : VectorN<T, 2>(expression) { }
 
-		Vector2(T fill) : VectorN<T, 2>(fill) { }
+		constexpr Vector2(T fill) : VectorN<T, 2>(fill) { }
 
-		Vector2(T x, T y)
+		constexpr Vector2(T x, T y)
 		{
-			m_data[0] = x;
-			m_data[1] = y;
+			this->m_data[0] = x;
+			this->m_data[1] = y;
 		}
 
-		inline T& X() { return m_data[0]; }
+		constexpr inline T& X() { return this->m_data[0]; }
 
-		inline const T& X() const { return m_data[0]; }
+		constexpr inline const T& X() const { return this->m_data[0]; }
 
-		inline T& Y() { return m_data[1]; }
+		constexpr inline T& Y() { return this->m_data[1]; }
 
-		inline const T& Y() const { return m_data[1]; }
+		constexpr inline const T& Y() const { return this->m_data[1]; }
 
 	};
 
@@ -143,33 +441,36 @@ namespace decaf
 
 	public:
 
-		Vector3() : VectorN<T, 3>() { }
+		constexpr Vector3() : VectorN<T, 3>() { }
 
-		Vector3(const VectorN<T, 3>& other) : VectorN<T, 3>(other) { }
+		constexpr Vector3(const VectorN<T, 3>& other) : VectorN<T, 3>(other) { }
 
-		Vector3(T fill) : VectorN<T, 3>(fill) { }
+		template <typename E>
+		constexpr Vector3(const VectorExpression<E, T, 3>& expression) : VectorN<T, 3>(expression) { }
 
-		Vector3(T x, T y, T z)
+		constexpr Vector3(T fill) : VectorN<T, 3>(fill) { }
+
+		constexpr Vector3(T x, T y, T z)
 		{
-			m_data[0] = x;
-			m_data[1] = y;
-			m_data[2] = z;
+			this->m_data[0] = x;
+			this->m_data[1] = y;
+			this->m_data[2] = z;
 		}
 
-		Vector3(const VectorN<T, 2>& vector, T z)
+		constexpr Vector3(const VectorN<T, 2>& vector, T z)
 			: Vector3(vector[0], vector[1], z) { }
 
-		inline T& X() { return m_data[0]; }
+		constexpr inline T& X() { return this->m_data[0]; }
 
-		inline const T& X() const { return m_data[0]; }
+		constexpr inline const T& X() const { return this->m_data[0]; }
 
-		inline T& Y() { return m_data[1]; }
+		constexpr inline T& Y() { return this->m_data[1]; }
 
-		inline const T& Y() const { return m_data[1]; }
+		constexpr inline const T& Y() const { return this->m_data[1]; }
 
-		inline T& Z() { return m_data[2]; }
+		constexpr inline T& Z() { return this->m_data[2]; }
 
-		inline const T& Z() const { return m_data[2]; }
+		constexpr inline const T& Z() const { return this->m_data[2]; }
 
 	};
 
@@ -185,41 +486,44 @@ namespace decaf
 
 	public:
 
-		Vector4() : VectorN<T, 4>() { }
+		constexpr Vector4() : VectorN<T, 4>() { }
+
+		constexpr Vector4(const VectorN<T, 4>& other) : VectorN<T, 4>(other) { }
 
-		Vector4(const VectorN<T, 4>& other) : VectorN<T, 4>(other) { }
+		template <typename E>
+		constexpr Vector4(const VectorExpression<E, T, 4>& expression) : VectorN<T, 4>(expression) { }
 
-		Vector4(T fill) : VectorN<T, 4>(fill) { }
+		constexpr Vector4(T fill) : VectorN<T, 4>(fill) { }
 
-		Vector4(T x, T y, T z, T w)
+		constexpr Vector4(T x, T y, T z, T w)
 		{
-			m_data[0] = x;
-			m_data[1] = y;
-			m_data[2] = z;
-			m_data[3] = w;
+			this->m_data[0] = x;
+			this->m_data[1] = y;
+			this->m_data[2] = z;
+			this->m_data[3] = w;
 		}
 
-		Vector4(const VectorN<T, 3>& vector, T w)
+		constexpr Vector4(const VectorN<T, 3>& vector, T w)
 			: Vector4(vector[0], vector[1], vector[2], w) { }
 
-		Vector4(const VectorN<T, 2>& vectorA, const VectorN<T, 2>& vectorB)
+		constexpr Vector4(const VectorN<T, 2>& vectorA, const VectorN<T, 2>& vectorB)
 			: Vector4(vectorA[0], vectorA[1], vectorB[0], vectorB[1]) { }
 
-		inline T& X() { return m_data[0]; }
+		constexpr inline T& X() { return this->m_data[0]; }
 
-		inline const T& X() const { return m_data[0]; }
+		constexpr inline const T& X() const { return this->m_data[0]; }
 
-		inline T& Y() { return m_data[1]; }
+		constexpr inline T& Y() { return this->m_data[1]; }
 
-		inline const T& Y() const { return m_data[1]; }
+		constexpr inline const T& Y() const { return this->m_data[1]; }
 
-		inline T& Z() { return m_data[2]; }
+		constexpr inline T& Z() { return this->m_data[2]; }
 
-		inline const T& Z() const { return m_data[2]; }
+		constexpr inline const T& Z() const { return this->m_data[2]; }
 
-		inline T& W() { return m_data[3]; }
+		constexpr inline T& W() { return this->m_data[3]; }
 
-		inline const T& W() const { return m_data[3]; }
+		constexpr inline const T& W() const { return this->m_data[3]; }
 
 	};
 
@@ -228,135 +532,122 @@ namespace decaf
 	using Vector4f = Vector4<float>;
 	using Vector4d = Vector4<double>;
 
+	static_assert(std::is_trivially_copyable<Vector2f>::value && std::is_trivially_copyable<Vector3f>::value && std::is_trivially_copyable<Vector4f>::value,
+		"Vectors must stay trivially copyable so that arrays of them can be bulk-copied.");
+	static_assert(sizeof(Vector2f) == 2 * sizeof(float) && alignof(Vector2f) == alignof(float), "Vector2f must not be padded.");
+	static_assert(sizeof(Vector3f) == 4 * sizeof(float) && sizeof(Vector4f) == 4 * sizeof(float), "Vector3f and Vector4f occupy one 128-bit lane.");
+
 	template <typename T, size_t S>
-	inline bool operator == (const VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
+	constexpr inline bool operator == (const VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
 	{
-		return std::equal(&lhs[0], &lhs[S - 1], &rhs[0], &rhs[S - 1]);
+		for (size_t i = 0; i < S; ++i)
+		{
+			if (lhs[i] != rhs[i])
+				return false;
+		}
+
+		return true;
 	}
 
 	template <typename T, size_t S>
-	inline bool operator != (const VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
+	constexpr inline bool operator != (const VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
 	{
 		return !(lhs == rhs);
 	}
 
 	template <typename T, size_t S>
-	inline VectorN<T, S> operator - (const VectorN<T, S>& that)
+	constexpr inline VectorN<T, S> operator - (const VectorN<T, S>& that)
 	{
-		VectorN<T, S> result;
-
-		for (size_t i = 0; i < S; ++i)
-			result[i] = -that[i];
-
-		return result;
+		return VectorUnary<VectorOps::Negate, VectorN<T, S>, T, S>(that);
 	}
 
 	template <typename T, size_t S>
-	inline VectorN<T, S>& operator += (VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
+	constexpr inline VectorN<T, S> operator + (const VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
 	{
-		for (size_t i = 0; i < S; ++i)
-			lhs[i] += rhs[i];
-
-		return lhs;
+		return VectorBinary<VectorOps::Add, VectorN<T, S>, VectorN<T, S>, T, S>(lhs, rhs);
 	}
 
 	template <typename T, size_t S>
-	inline VectorN<T, S> operator + (const VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
+	constexpr inline VectorN<T, S> operator - (const VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
 	{
-		VectorN<T, S> result(lhs);
-		return (result += rhs);
+		return VectorBinary<VectorOps::Subtract, VectorN<T, S>, VectorN<T, S>, T, S>(lhs, rhs);
 	}
 
 	template <typename T, size_t S>
-	inline VectorN<T, S>& operator -= (VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
+	constexpr inline VectorN<T, S> operator * (const VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
 	{
-		for (size_t i = 0; i < S; ++i)
-			lhs[i] -= rhs[i];
-		
-		return lhs;
+		return VectorBinary<VectorOps::Multiply, VectorN<T, S>, VectorN<T, S>, T, S>(lhs, rhs);
 	}
 
 	template <typename T, size_t S>
-	inline VectorN<T, S> operator - (const VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
+	constexpr inline VectorN<T, S> operator * (const VectorN<T, S>& lhs, const T rhs)
 	{
-		VectorN<T, S> result(lhs);
-		return (result -= rhs);
+		return VectorBinary<VectorOps::Multiply, VectorN<T, S>, VectorScalar<T, S>, T, S>(lhs, VectorScalar<T, S>(rhs));
 	}
 
 	template <typename T, size_t S>
-	inline VectorN<T, S>& operator *= (VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
+	constexpr inline VectorN<T, S> operator / (const VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
 	{
-		for (size_t i = 0; i < S; ++i)
-			lhs[i] *= rhs[i];
-
-		return lhs;
+		return VectorBinary<VectorOps::Divide, VectorN<T, S>, VectorN<T, S>, T, S>(lhs, rhs);
 	}
 
 	template <typename T, size_t S>
-	inline VectorN<T, S> operator * (const VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
+	constexpr inline VectorN<T, S> operator / (const VectorN<T, S>& lhs, const T rhs)
 	{
-		VectorN<T, S> result(lhs);
-		return (result *= rhs);
+		return VectorBinary<VectorOps::Divide, VectorN<T, S>, VectorScalar<T, S>, T, S>(lhs, VectorScalar<T, S>(rhs));
 	}
 
 	template <typename T, size_t S>
-	inline VectorN<T, S>& operator *= (VectorN<T, S>& lhs, const T rhs)
+	constexpr inline VectorN<T, S>& operator += (VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
 	{
-		for (size_t i = 0; i < S; ++i)
-			lhs[i] *= rhs;
-
-		return lhs;
+		return (lhs = lhs + rhs);
 	}
 
 	template <typename T, size_t S>
-	inline VectorN<T, S> operator * (const VectorN<T, S>& lhs, const T rhs)
+	constexpr inline VectorN<T, S>& operator -= (VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
 	{
-		VectorN<T, S> result(lhs);
-		return (result *= rhs);
+		return (lhs = lhs - rhs);
 	}
 
 	template <typename T, size_t S>
-	inline VectorN<T, S>& operator /= (VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
+	constexpr inline VectorN<T, S>& operator *= (VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
 	{
-		for (size_t i = 0; i < S; ++i)
-			lhs[i] /= rhs[i];
-
-		return lhs;
+		return (lhs = lhs * rhs);
 	}
 
 	template <typename T, size_t S>
-	inline VectorN<T, S> operator / (const VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
+	constexpr inline VectorN<T, S>& operator *= (VectorN<T, S>& lhs, const T rhs)
 	{
-		VectorN<T, S> result(lhs);
-		return (result /= rhs);
+		return (lhs = lhs * rhs);
 	}
 
 	template <typename T, size_t S>
-	inline VectorN<T, S>& operator /= (VectorN<T, S>& lhs, const T rhs)
+	constexpr inline VectorN<T, S>& operator /= (VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
 	{
-		for (size_t i = 0; i < S; ++i)
-			lhs[i] /= rhs;
-		
-		return lhs;
+		return (lhs = lhs / rhs);
 	}
 
 	template <typename T, size_t S>
-	inline VectorN<T, S> operator / (const VectorN<T, S>& lhs, const T rhs)
+	constexpr inline VectorN<T, S>& operator /= (VectorN<T, S>& lhs, const T rhs)
 	{
-		VectorN<T, S> result(lhs);
-		return (result /= rhs);
+		return (lhs = lhs / rhs);
 	}
 
 	namespace Vector
 	{
-		
+
 		/// <summary>Calculates the dot product of two n-dimensional <c>Vector</c>s.</summary>
 		/// <param name='lhs'>The left-hand operand.</param>
 		/// <param name='rhs'>The right-hand operand.</param>
 		/// <returns>The dot product of two n-dimensional <c>Vector</c>s.</returns>
 		template <typename T, size_t S>
-		inline T Dot(const VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
+		constexpr inline T Dot(const VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
 		{
+#if defined (DECAF_MATH_SSE)
+			if constexpr (VectorStorage<T, S>::Simd)
+				return VectorOps::HorizontalSum(_mm_mul_ps(lhs.Packet(), rhs.Packet()));
+#endif
+
 			T result = T(0);
 
 			for (size_t i = 0; i < S; ++i)
@@ -370,7 +661,7 @@ namespace decaf
 		/// <param name='rhs'>The right-hand operand.</param>
 		/// <returns>A 3-dimensional <c>Vector</c> representing the cross product of <paramref name='lhs'/> and <paramref name='rhs'/>.</returns>
 		template <typename T>
-		inline VectorN<T, 3> Cross(const VectorN<T, 3>& lhs, const VectorN<T, 3>& rhs)
+		constexpr inline VectorN<T, 3> Cross(const VectorN<T, 3>& lhs, const VectorN<T, 3>& rhs)
 		{
 			VectorN<T, 3> result;
 
@@ -388,7 +679,7 @@ namespace decaf
 		template <typename T, size_t S>
 		inline VectorN<T, S> Reflect(const VectorN<T, S>& vector, const VectorN<T, S>& normal)
 		{
-			return (vector - (normal * Dot(vector, normal) * T(2)));
+			return (vector - (normal * (Dot(vector, normal) * T(2))));
 		}
 
 		/// <summary>Refracts a <c>Vector</c> around a normal.</summary>
@@ -399,12 +690,12 @@ namespace decaf
 		template <typename T, size_t S>
 		inline VectorN<T, S> Refract(const VectorN<T, S>& vector, const VectorN<T, S>& normal, const T amount)
 		{
-			float NdotV = Dot(normal, vector);
-			float k = T(1) - (amount * amount * (T(1) - NdotV * NdotV));
+			T NdotV = Dot(normal, vector);
+			T k = T(1) - (amount * amount * (T(1) - NdotV * NdotV));
 			if (k < T(0))
 				return VectorN<T, S>(T(0));
 			else
-				return (vector * amount) - (normal * (amount * NdotV + sqrtf(k)));
+				return (vector * amount) - (normal * (amount * NdotV + static_cast<T>(sqrt(k))));
 		}
 
 		/// <summary>Compares two <c>VectorN</c> objects and returns a new <c>VectorN</c> with each member set to the lower value of each corresponding pair of members.</summary>
@@ -414,12 +705,7 @@ namespace decaf
 		template <typename T, size_t S>
 		inline VectorN<T, S> Min(const VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
 		{
-			VectorN<T, S> result;
-
-			for (size_t i = 0; i < S; ++i)
-				result[i] = std::min(lhs[i], rhs[i]);
-
-			return result;
+			return VectorBinary<VectorOps::Minimum, VectorN<T, S>, VectorN<T, S>, T, S>(lhs, rhs);
 		}
 
 		/// <summary>Compares two <c>VectorN</c> objects and returns a new <c>VectorN</c> with each member set to the greater value of each corresponding pair of members.</summary>
@@ -429,12 +715,7 @@ namespace decaf
 		template <typename T, size_t S>
 		inline VectorN<T, S> Max(const VectorN<T, S>& lhs, const VectorN<T, S>& rhs)
 		{
-			VectorN<T, S> result;
-
-			for (size_t i = 0; i < S; ++i)
-				result[i] = std::max(lhs[i], rhs[i]);
-
-			return result;
+			return VectorBinary<VectorOps::Maximum, VectorN<T, S>, VectorN<T, S>, T, S>(lhs, rhs);
 		}
 
 	};
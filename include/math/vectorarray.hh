@@ -0,0 +1,339 @@
+#ifndef DECAF_MATH_VECTORARRAY_HH_
+#define DECAF_MATH_VECTORARRAY_HH_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "decaf/concurrent/parallelfor.hh"
+#include "decaf/math/vector.hh"
+
+namespace decaf
+{
+
+	/// <summary>A resizable array of n-dimensional vectors stored as structure-of-arrays: one contiguous run per component.</summary>
+	/// <remarks>Element <c>i</c> is <c>(Component(0)[i], ..., Component(S - 1)[i])</c>. The bulk functions in <c>namespace Vector</c>
+	/// walk the components with unit stride, so the compiler can vectorize them.</remarks>
+	template <typename T, size_t S>
+	class VectorArray
+	{
+
+	public:
+
+		/// <summary>The number of elements below which the bulk functions do not split work across threads.</summary>
+		static constexpr size_t ParallelChunk = 16384;
+
+		VectorArray() = default;
+
+		explicit VectorArray(size_t count)
+		{
+			Resize(count);
+		}
+
+		inline size_t Size() const
+		{
+			return m_components[0].size();
+		}
+
+		inline bool Empty() const
+		{
+			return m_components[0].empty();
+		}
+
+		inline void Resize(size_t count)
+		{
+			for (auto& component : m_components)
+				component.resize(count, T(0));
+		}
+
+		inline void Reserve(size_t count)
+		{
+			for (auto& component : m_components)
+				component.reserve(count);
+		}
+
+		inline void Clear()
+		{
+			for (auto& component : m_components)
+				component.clear();
+		}
+
+		inline void PushBack(const VectorN<T, S>& vector)
+		{
+			for (size_t c = 0; c < S; ++c)
+				m_components[c].push_back(vector[c]);
+		}
+
+		/// <summary>Gathers element <paramref name='i'/> into a <c>VectorN</c>.</summary>
+		inline VectorN<T, S> Get(size_t i) const
+		{
+			VectorN<T, S> result;
+
+			for (size_t c = 0; c < S; ++c)
+				result[c] = m_components[c][i];
+
+			return result;
+		}
+
+		/// <summary>Scatters <paramref name='vector'/> into element <paramref name='i'/>.</summary>
+		inline void Set(size_t i, const VectorN<T, S>& vector)
+		{
+			for (size_t c = 0; c < S; ++c)
+				m_components[c][i] = vector[c];
+		}
+
+		inline T* Component(size_t c)
+		{
+			return m_components[c].data();
+		}
+
+		inline const T* Component(size_t c) const
+		{
+			return m_components[c].data();
+		}
+
+	private:
+
+		std::array<std::vector<T>, S> m_components;
+
+	};
+
+	using VectorArray2f = VectorArray<float, 2>;
+	using VectorArray3f = VectorArray<float, 3>;
+	using VectorArray4f = VectorArray<float, 4>;
+	using VectorArray2d = VectorArray<double, 2>;
+
+	namespace Vector
+	{
+
+		/// <summary>Calculates the squared length of every element of <paramref name='vectors'/>.</summary>
+		/// <param name='out'>Receives <c>vectors.Size()</c> values.</param>
+		/// <param name='threads'>The number of threads to split the work across; <c>0</c> uses every hardware thread.</param>
+		template <typename T, size_t S>
+		inline void LengthSquared(const VectorArray<T, S>& vectors, T* out, size_t threads = 1)
+		{
+			ParallelFor(vectors.Size(), threads, VectorArray<T, S>::ParallelChunk, [&](size_t begin, size_t end)
+			{
+				const T* x = vectors.Component(0);
+
+				for (size_t i = begin; i < end; ++i)
+					out[i] = x[i] * x[i];
+
+				for (size_t c = 1; c < S; ++c)
+				{
+					const T* v = vectors.Component(c);
+
+					for (size_t i = begin; i < end; ++i)
+						out[i] += v[i] * v[i];
+				}
+			});
+		}
+
+		/// <summary>Calculates the length of every element of <paramref name='vectors'/>.</summary>
+		/// <param name='out'>Receives <c>vectors.Size()</c> values.</param>
+		/// <param name='threads'>The number of threads to split the work across; <c>0</c> uses every hardware thread.</param>
+		template <typename T, size_t S>
+		inline void Length(const VectorArray<T, S>& vectors, T* out, size_t threads = 1)
+		{
+			ParallelFor(vectors.Size(), threads, VectorArray<T, S>::ParallelChunk, [&](size_t begin, size_t end)
+			{
+				size_t i = begin;
+
+#if defined (DECAF_MATH_SSE)
+				if constexpr (std::is_same<T, float>::value)
+				{
+					// std::sqrt sets errno, which keeps the compiler from vectorizing it; do the square roots by hand.
+					for (; i + 4 <= end; i += 4)
+					{
+						__m128 sum = _mm_setzero_ps();
+
+						for (size_t c = 0; c < S; ++c)
+						{
+							__m128 v = _mm_loadu_ps(vectors.Component(c) + i);
+							sum = _mm_add_ps(sum, _mm_mul_ps(v, v));
+						}
+
+						_mm_storeu_ps(out + i, _mm_sqrt_ps(sum));
+					}
+				}
+#endif
+
+				for (; i < end; ++i)
+				{
+					T sum = T(0);
+
+					for (size_t c = 0; c < S; ++c)
+						sum += vectors.Component(c)[i] * vectors.Component(c)[i];
+
+					out[i] = static_cast<T>(sqrt(sum));
+				}
+			});
+		}
+
+		/// <summary>Normalizes every element of <paramref name='vectors'/> in place.</summary>
+		/// <remarks>Matches <c>VectorN::Normalize</c> element for element, including the result for zero-length vectors.</remarks>
+		/// <param name='threads'>The number of threads to split the work across; <c>0</c> uses every hardware thread.</param>
+		template <typename T, size_t S>
+		inline void Normalize(VectorArray<T, S>& vectors, size_t threads = 1)
+		{
+			ParallelFor(vectors.Size(), threads, VectorArray<T, S>::ParallelChunk, [&](size_t begin, size_t end)
+			{
+				size_t i = begin;
+
+#if defined (DECAF_MATH_SSE)
+				if constexpr (std::is_same<T, float>::value)
+				{
+					for (; i + 4 <= end; i += 4)
+					{
+						__m128 sum = _mm_setzero_ps();
+
+						for (size_t c = 0; c < S; ++c)
+						{
+							__m128 v = _mm_loadu_ps(vectors.Component(c) + i);
+							sum = _mm_add_ps(sum, _mm_mul_ps(v, v));
+						}
+
+						__m128 length = _mm_sqrt_ps(sum);
+
+						for (size_t c = 0; c < S; ++c)
+							_mm_storeu_ps(vectors.Component(c) + i, _mm_div_ps(_mm_loadu_ps(vectors.Component(c) + i), length));
+					}
+				}
+#endif
+
+				for (; i < end; ++i)
+				{
+					T sum = T(0);
+
+					for (size_t c = 0; c < S; ++c)
+						sum += vectors.Component(c)[i] * vectors.Component(c)[i];
+
+					T length = static_cast<T>(sqrt(sum));
+
+					for (size_t c = 0; c < S; ++c)
+						vectors.Component(c)[i] /= length;
+				}
+			});
+		}
+
+		/// <summary>Calculates the dot product of each pair of corresponding elements.</summary>
+		/// <param name='out'>Receives <c>min(lhs.Size(), rhs.Size())</c> values.</param>
+		/// <param name='threads'>The number of threads to split the work across; <c>0</c> uses every hardware thread.</param>
+		template <typename T, size_t S>
+		inline void Dot(const VectorArray<T, S>& lhs, const VectorArray<T, S>& rhs, T* out, size_t threads = 1)
+		{
+			ParallelFor(std::min(lhs.Size(), rhs.Size()), threads, VectorArray<T, S>::ParallelChunk, [&](size_t begin, size_t end)
+			{
+				const T* a = lhs.Component(0);
+				const T* b = rhs.Component(0);
+
+				for (size_t i = begin; i < end; ++i)
+					out[i] = a[i] * b[i];
+
+				for (size_t c = 1; c < S; ++c)
+				{
+					a = lhs.Component(c);
+					b = rhs.Component(c);
+
+					for (size_t i = begin; i < end; ++i)
+						out[i] += a[i] * b[i];
+				}
+			});
+		}
+
+		/// <summary>Stores the component-wise minimum of each pair of corresponding elements in <paramref name='out'/>, which is resized to fit.</summary>
+		/// <param name='threads'>The number of threads to split the work across; <c>0</c> uses every hardware thread.</param>
+		template <typename T, size_t S>
+		inline void Min(const VectorArray<T, S>& lhs, const VectorArray<T, S>& rhs, VectorArray<T, S>& out, size_t threads = 1)
+		{
+			out.Resize(std::min(lhs.Size(), rhs.Size()));
+
+			ParallelFor(out.Size(), threads, VectorArray<T, S>::ParallelChunk, [&](size_t begin, size_t end)
+			{
+				for (size_t c = 0; c < S; ++c)
+				{
+					const T* a = lhs.Component(c);
+					const T* b = rhs.Component(c);
+					T* r = out.Component(c);
+
+					for (size_t i = begin; i < end; ++i)
+						r[i] = std::min(a[i], b[i]);
+				}
+			});
+		}
+
+		/// <summary>Stores the component-wise maximum of each pair of corresponding elements in <paramref name='out'/>, which is resized to fit.</summary>
+		/// <param name='threads'>The number of threads to split the work across; <c>0</c> uses every hardware thread.</param>
+		template <typename T, size_t S>
+		inline void Max(const VectorArray<T, S>& lhs, const VectorArray<T, S>& rhs, VectorArray<T, S>& out, size_t threads = 1)
+		{
+			out.Resize(std::min(lhs.Size(), rhs.Size()));
+
+			ParallelFor(out.Size(), threads, VectorArray<T, S>::ParallelChunk, [&](size_t begin, size_t end)
+			{
+				for (size_t c = 0; c < S; ++c)
+				{
+					const T* a = lhs.Component(c);
+					const T* b = rhs.Component(c);
+					T* r = out.Component(c);
+
+					for (size_t i = begin; i < end; ++i)
+						r[i] = std::max(a[i], b[i]);
+				}
+			});
+		}
+
+		/// <summary>Reflects each element of <paramref name='vectors'/> around the corresponding element of <paramref name='normals'/>.</summary>
+		/// <param name='out'>Receives the reflected vectors and is resized to fit. It may alias <paramref name='vectors'/>.</param>
+		/// <param name='threads'>The number of threads to split the work across; <c>0</c> uses every hardware thread.</param>
+		template <typename T, size_t S>
+		inline void Reflect(const VectorArray<T, S>& vectors, const VectorArray<T, S>& normals, VectorArray<T, S>& out, size_t threads = 1)
+		{
+			size_t count = std::min(vectors.Size(), normals.Size());
+
+			if (&out != &vectors)
+				out.Resize(count);
+
+			ParallelFor(count, threads, VectorArray<T, S>::ParallelChunk, [&](size_t begin, size_t end)
+			{
+				// Work in cache-sized blocks so the dot products stay in L1 between the two passes.
+				constexpr size_t Block = 1024;
+				T scale[Block];
+
+				for (size_t first = begin; first < end; first += Block)
+				{
+					size_t last = std::min(first + Block, end);
+
+					for (size_t i = first; i < last; ++i)
+						scale[i - first] = T(0);
+
+					for (size_t c = 0; c < S; ++c)
+					{
+						const T* v = vectors.Component(c);
+						const T* n = normals.Component(c);
+
+						for (size_t i = first; i < last; ++i)
+							scale[i - first] += v[i] * n[i];
+					}
+
+					for (size_t c = 0; c < S; ++c)
+					{
+						const T* v = vectors.Component(c);
+						const T* n = normals.Component(c);
+						T* r = out.Component(c);
+
+						for (size_t i = first; i < last; ++i)
+							r[i] = v[i] - n[i] * (scale[i - first] * T(2));
+					}
+				}
+			});
+		}
+
+	}
+
+}
+
+#endif
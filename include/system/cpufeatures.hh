@@ -0,0 +1,25 @@
+#ifndef DECAF_SYSTEM_CPUFEATURES_HH_
+#define DECAF_SYSTEM_CPUFEATURES_HH_
+
+#if defined (__x86_64__) || defined (_M_X64) || defined (__i386__) || defined (_M_IX86)
+#define DECAF_ARCH_X86 1
+#endif
+
+namespace decaf
+{
+
+	/// <summary>The instruction set extensions the running CPU and OS support.</summary>
+	struct CpuFeatures
+	{
+		bool sse2;
+		bool sse41;
+		bool avx2;
+		bool fma;
+
+		/// <summary>Gets the features of the running machine, detected once on first use.</summary>
+		static const CpuFeatures& Get();
+	};
+
+}
+
+#endif
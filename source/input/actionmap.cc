@@ -0,0 +1,242 @@
+#include <algorithm>
+
+#include "decaf/input/actionmap.hh"
+
+namespace decaf
+{
+
+	namespace
+	{
+
+		/// <summary>The slot of the axis array that holds a constant, used by bindings without an axis.</summary>
+		constexpr uint8_t NoAxis = 6;
+
+		inline size_t WordsFor(size_t actions)
+		{
+			return (actions + 63) / 64;
+		}
+
+		inline void Axes(const Gamepad::State& state, float* axes)
+		{
+			axes[0] = state.leftStick[0];
+			axes[1] = state.leftStick[1];
+			axes[2] = state.rightStick[0];
+			axes[3] = state.rightStick[1];
+			axes[4] = state.leftTrigger;
+			axes[5] = state.rightTrigger;
+			axes[NoAxis] = 0.0f;
+		}
+
+	}
+
+
+	////////////////////////////////////////////////////////////
+	ActionMap::ActionMap()
+		: m_compiles{ 0 } { }
+
+
+	////////////////////////////////////////////////////////////
+	ActionMap::ActionId ActionMap::DefineAction(const std::string& name)
+	{
+		auto found = m_names.find(name);
+
+		if (found != m_names.end())
+			return found->second;
+
+		ActionId action = static_cast<ActionId>(m_actions.size());
+		m_actions.push_back(name);
+		m_names.emplace(name, action);
+
+		return action;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	ActionMap::ActionId ActionMap::FindAction(const std::string& name) const
+	{
+		auto found = m_names.find(name);
+		return found != m_names.end() ? found->second : NoAction;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	ActionMap::LayerId ActionMap::AddLayer(const std::string& name, int32_t priority, bool opaque)
+	{
+		Layer layer = {};
+		layer.name = name;
+		layer.priority = priority;
+		layer.opaque = opaque;
+		layer.enabled = false;
+		layer.dirty = true;
+
+		m_layers.push_back(std::move(layer));
+		SortLayers();
+
+		return static_cast<LayerId>(m_layers.size() - 1);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void ActionMap::EnableLayer(ActionMap::LayerId layer, bool enabled)
+	{
+		m_layers[layer].enabled = enabled;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void ActionMap::Bind(ActionMap::LayerId layer, ActionMap::ActionId action, const ActionBinding& binding)
+	{
+		m_layers[layer].bindings.emplace_back(action, binding);
+		m_layers[layer].dirty = true;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void ActionMap::Unbind(ActionMap::LayerId layer, ActionMap::ActionId action)
+	{
+		auto& bindings = m_layers[layer].bindings;
+
+		bindings.erase(std::remove_if(bindings.begin(), bindings.end(), [action](const std::pair<ActionId, ActionBinding>& entry)
+		{
+			return entry.first == action;
+		}), bindings.end());
+
+		m_layers[layer].dirty = true;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void ActionMap::Rebind(ActionMap::LayerId layer, ActionMap::ActionId action, const ActionBinding& binding)
+	{
+		Unbind(layer, action);
+		Bind(layer, action, binding);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void ActionMap::Evaluate(const Gamepad::State& current, const Gamepad::State& previous, ActionFrame& frame)
+	{
+		size_t words = WordsFor(m_actions.size());
+
+		frame.m_down.assign(words, 0);
+		frame.m_was.assign(words, 0);
+		frame.m_shadow.assign(words, 0);
+
+		float now[NoAxis + 1];
+		float was[NoAxis + 1];
+		Axes(current, now);
+		Axes(previous, was);
+
+		uint16_t nowButtons = current.buttons;
+		uint16_t wasButtons = previous.buttons;
+
+		for (LayerId id : m_order)
+		{
+			Layer& layer = m_layers[id];
+
+			if (!layer.enabled)
+				continue;
+
+			if (layer.dirty)
+				Compile(layer);
+
+			const Table& table = layer.table;
+			size_t count = table.required.size();
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				uint16_t required = table.required[i];
+				uint16_t excluded = table.excluded[i];
+				uint8_t axis = table.axis[i];
+
+				// Each test is a comparison, so the whole binding resolves to two masks without branching.
+				bool down = ((nowButtons & required) == required) & ((nowButtons & excluded) == 0) & (now[axis] * table.scale[i] >= table.threshold[i]);
+				bool held = ((wasButtons & required) == required) & ((wasButtons & excluded) == 0) & (was[axis] * table.scale[i] >= table.threshold[i]);
+
+				size_t word = table.word[i];
+				uint64_t live = table.bit[i] & ~frame.m_shadow[word];
+
+				frame.m_down[word] |= live & (0 - static_cast<uint64_t>(down));
+				frame.m_was[word] |= live & (0 - static_cast<uint64_t>(held));
+			}
+
+			for (size_t w = 0; w < table.bound.size() && w < words; ++w)
+				frame.m_shadow[w] |= table.bound[w];
+
+			if (layer.opaque)
+				break;
+		}
+
+		frame.m_pressed.resize(words);
+		frame.m_released.resize(words);
+
+		for (size_t w = 0; w < words; ++w)
+		{
+			frame.m_pressed[w] = frame.m_down[w] & ~frame.m_was[w];
+			frame.m_released[w] = frame.m_was[w] & ~frame.m_down[w];
+		}
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void ActionMap::Compile(ActionMap::Layer& layer)
+	{
+		Table& table = layer.table;
+		size_t count = layer.bindings.size();
+
+		table.required.resize(count);
+		table.excluded.resize(count);
+		table.axis.resize(count);
+		table.scale.resize(count);
+		table.threshold.resize(count);
+		table.word.resize(count);
+		table.bit.resize(count);
+		table.bound.assign(WordsFor(m_actions.size()), 0);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			ActionId action = layer.bindings[i].first;
+			const ActionBinding& binding = layer.bindings[i].second;
+
+			table.required[i] = binding.buttons | binding.modifiers;
+			table.excluded[i] = binding.excluded;
+			table.word[i] = static_cast<uint16_t>(action >> 6);
+			table.bit[i] = uint64_t(1) << (action & 63);
+			table.bound[action >> 6] |= table.bit[i];
+
+			// A negative threshold flips the axis so every test reads "value * scale >= threshold".
+			if (binding.useAxis)
+			{
+				bool negative = binding.threshold < 0.0f;
+				table.axis[i] = static_cast<uint8_t>(binding.axis);
+				table.scale[i] = negative ? -1.0f : 1.0f;
+				table.threshold[i] = negative ? -binding.threshold : binding.threshold;
+			}
+			else
+			{
+				table.axis[i] = NoAxis;
+				table.scale[i] = 0.0f;
+				table.threshold[i] = -std::numeric_limits<float>::infinity();
+			}
+		}
+
+		layer.dirty = false;
+		++m_compiles;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void ActionMap::SortLayers()
+	{
+		m_order.resize(m_layers.size());
+
+		for (size_t i = 0; i < m_order.size(); ++i)
+			m_order[i] = static_cast<LayerId>(i);
+
+		std::stable_sort(m_order.begin(), m_order.end(), [this](LayerId lhs, LayerId rhs)
+		{
+			return m_layers[lhs].priority > m_layers[rhs].priority;
+		});
+	}
+
+}
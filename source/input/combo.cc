@@ -0,0 +1,332 @@
+#include <algorithm>
+#include <deque>
+
+#include "decaf/input/combo.hh"
+
+namespace decaf
+{
+
+	namespace
+	{
+
+		/// <summary>How far the left stick must lean along an axis to count as a direction.</summary>
+		constexpr float StickThreshold = 0.5f;
+
+		/// <summary>The internal window of a step without a limit.</summary>
+		constexpr uint64_t Unlimited = UINT64_MAX;
+
+		/// <summary>The D-pad buttons, which are read as directions rather than presses.</summary>
+		constexpr uint16_t DPad = static_cast<uint16_t>(Gamepad::Button::DPAD_UP) | static_cast<uint16_t>(Gamepad::Button::DPAD_DOWN) |
+			static_cast<uint16_t>(Gamepad::Button::DPAD_LEFT) | static_cast<uint16_t>(Gamepad::Button::DPAD_RIGHT);
+
+		inline uint8_t DirectionSymbol(uint8_t direction)
+		{
+			return static_cast<uint8_t>(direction - 1);
+		}
+
+		inline uint8_t ButtonSymbol(unsigned bit)
+		{
+			return static_cast<uint8_t>(9 + bit);
+		}
+
+	}
+
+
+	////////////////////////////////////////////////////////////
+	ComboRecognizer::ComboRecognizer(uint64_t chordWindow)
+		: m_chordWindow{ chordWindow }, m_maxWindow{ 0 }, m_dirty{ true } { }
+
+
+	////////////////////////////////////////////////////////////
+	ComboRecognizer::PatternId ComboRecognizer::AddPattern(const std::string& name, const std::vector<ComboStep>& steps)
+	{
+		m_names.push_back(name);
+		m_patterns.push_back(steps);
+		m_dirty = true;
+
+		return static_cast<PatternId>(m_names.size() - 1);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void ComboRecognizer::Compile()
+	{
+		if (!m_dirty)
+			return;
+
+		m_spellings.clear();
+		m_symbols.clear();
+		m_windows.clear();
+		m_holds.clear();
+		m_maxWindow = 0;
+
+		std::vector<uint8_t> symbols;
+		std::vector<uint64_t> windows;
+		std::vector<uint64_t> holds;
+
+		for (size_t i = 0; i < m_patterns.size(); ++i)
+			Spell(static_cast<PatternId>(i), m_patterns[i], 0, symbols, windows, holds);
+
+		// Build the trie of every spelling; node 0 is the root, so a zero edge means "no child" until the links are filled in.
+		m_next.assign(Symbols, 0);
+		std::vector<std::vector<uint32_t>> ends(1);
+
+		for (size_t i = 0; i < m_spellings.size(); ++i)
+		{
+			const Spelling& spelling = m_spellings[i];
+			uint32_t node = 0;
+
+			for (uint32_t k = 0; k < spelling.length; ++k)
+			{
+				uint32_t& edge = m_next[node * Symbols + m_symbols[spelling.first + k]];
+
+				if (edge == 0)
+				{
+					edge = static_cast<uint32_t>(ends.size());
+					ends.emplace_back();
+					m_next.resize(m_next.size() + Symbols, 0);
+				}
+
+				node = m_next[node * Symbols + m_symbols[spelling.first + k]];
+			}
+
+			ends[node].push_back(static_cast<uint32_t>(i));
+		}
+
+		// Breadth first, so a node's suffix link is complete before its children need it. Missing edges then take
+		// the suffix link's edge, which turns the trie into a full DFA with one lookup per token.
+		std::vector<uint32_t> suffix(ends.size(), 0);
+		std::deque<uint32_t> queue;
+
+		m_outputs.assign(ends.size(), Output{ 0, 0, 0 });
+		m_ends.clear();
+
+		for (size_t s = 0; s < Symbols; ++s)
+		{
+			if (m_next[s] != 0)
+				queue.push_back(m_next[s]);
+		}
+
+		for (uint32_t node = 0; ; node = queue.front(), queue.pop_front())
+		{
+			m_outputs[node].first = static_cast<uint32_t>(m_ends.size());
+			m_outputs[node].count = static_cast<uint32_t>(ends[node].size());
+			m_ends.insert(m_ends.end(), ends[node].begin(), ends[node].end());
+
+			if (node != 0)
+			{
+				uint32_t link = suffix[node];
+				m_outputs[node].next = (m_outputs[link].count != 0 ? link : m_outputs[link].next);
+
+				for (size_t s = 0; s < Symbols; ++s)
+				{
+					uint32_t& edge = m_next[node * Symbols + s];
+
+					if (edge != 0)
+					{
+						suffix[edge] = m_next[link * Symbols + s];
+						queue.push_back(edge);
+					}
+					else
+					{
+						edge = m_next[link * Symbols + s];
+					}
+				}
+			}
+
+			if (queue.empty())
+				break;
+		}
+
+		m_dirty = false;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void ComboRecognizer::Reset(ComboRecognizer::Cursor& cursor)
+	{
+		cursor.node = 0;
+		cursor.direction = 5;
+		cursor.buttons = 0;
+		cursor.tokens = 0;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	size_t ComboRecognizer::Advance(ComboRecognizer::Cursor& cursor, const Gamepad::State& state, ComboRecognizer::Match* matches, size_t capacity)
+	{
+		Compile();
+
+		size_t count = 0;
+		uint8_t direction = DirectionOf(state);
+
+		if (direction != cursor.direction)
+			Feed(cursor, DirectionSymbol(direction), state.timestamp, matches, capacity, count);
+
+		// Buttons pressed in the same sample are fed lowest bit first; chords accept any order, so that is enough.
+		// The D-pad already produced a direction token, so it must not also interleave press tokens into the motion.
+		uint32_t pressed = state.buttons & ~cursor.buttons & ~DPad & 0xffffu;
+
+		while (pressed != 0)
+		{
+			unsigned bit = 0;
+			while (((pressed >> bit) & 1) == 0)
+				++bit;
+
+			pressed &= pressed - 1;
+			Feed(cursor, ButtonSymbol(bit), state.timestamp, matches, capacity, count);
+		}
+
+		cursor.direction = direction;
+		cursor.buttons = state.buttons;
+
+		return count;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint8_t ComboRecognizer::DirectionOf(const Gamepad::State& state)
+	{
+		int x = 0;
+		int y = 0;
+
+		if ((state.buttons & DPad) != 0)
+		{
+			x = ((state.buttons & static_cast<uint16_t>(Gamepad::Button::DPAD_RIGHT)) != 0) - ((state.buttons & static_cast<uint16_t>(Gamepad::Button::DPAD_LEFT)) != 0);
+			y = ((state.buttons & static_cast<uint16_t>(Gamepad::Button::DPAD_UP)) != 0) - ((state.buttons & static_cast<uint16_t>(Gamepad::Button::DPAD_DOWN)) != 0);
+		}
+		else
+		{
+			x = (state.leftStick[0] >= StickThreshold) - (state.leftStick[0] <= -StickThreshold);
+			y = (state.leftStick[1] >= StickThreshold) - (state.leftStick[1] <= -StickThreshold);
+		}
+
+		return static_cast<uint8_t>(5 + x + 3 * y);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void ComboRecognizer::Spell(ComboRecognizer::PatternId pattern, const std::vector<ComboStep>& steps, size_t step, std::vector<uint8_t>& symbols, std::vector<uint64_t>& windows, std::vector<uint64_t>& holds)
+	{
+		if (step == steps.size())
+		{
+			// Longer spellings could never be timed against the cursor's history, so they are dropped.
+			if (symbols.empty() || symbols.size() > MaxLength)
+				return;
+
+			m_spellings.push_back({ pattern, static_cast<uint32_t>(m_symbols.size()), static_cast<uint32_t>(symbols.size()) });
+			m_symbols.insert(m_symbols.end(), symbols.begin(), symbols.end());
+			m_windows.insert(m_windows.end(), windows.begin(), windows.end());
+			m_holds.insert(m_holds.end(), holds.begin(), holds.end());
+
+			for (size_t k = 1; k < windows.size(); ++k)
+				m_maxWindow = std::max(m_maxWindow, windows[k]);
+
+			return;
+		}
+
+		const ComboStep& current = steps[step];
+		uint64_t window = (current.window != 0 ? current.window : Unlimited);
+		size_t mark = symbols.size();
+
+		if (current.direction != 0)
+		{
+			if (current.direction > 9)
+				return;
+
+			symbols.push_back(DirectionSymbol(current.direction));
+			windows.push_back(window);
+			holds.push_back(current.hold);
+			Spell(pattern, steps, step + 1, symbols, windows, holds);
+		}
+		else
+		{
+			uint8_t bits[16];
+			size_t count = 0;
+
+			for (unsigned bit = 0; bit < 16; ++bit)
+			{
+				if (((current.buttons & ~DPad) >> bit) & 1)
+					bits[count++] = static_cast<uint8_t>(bit);
+			}
+
+			if (count == 0)
+				return;
+
+			// Every order of a chord is its own spelling. Past MaxChord buttons only the order of a single sample is accepted.
+			do
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					symbols.push_back(ButtonSymbol(bits[i]));
+					windows.push_back(i == 0 ? window : m_chordWindow);
+					holds.push_back(0);
+				}
+
+				Spell(pattern, steps, step + 1, symbols, windows, holds);
+
+				symbols.resize(mark);
+				windows.resize(mark);
+				holds.resize(mark);
+			} while (count <= MaxChord && std::next_permutation(bits, bits + count));
+		}
+
+		symbols.resize(mark);
+		windows.resize(mark);
+		holds.resize(mark);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool ComboRecognizer::Timed(const ComboRecognizer::Spelling& spelling, const ComboRecognizer::Cursor& cursor) const
+	{
+		uint64_t start = cursor.tokens - spelling.length;
+
+		for (uint32_t k = 1; k < spelling.length; ++k)
+		{
+			uint64_t gap = cursor.times[(start + k) % MaxLength] - cursor.times[(start + k - 1) % MaxLength];
+
+			if (gap > m_windows[spelling.first + k] || gap < m_holds[spelling.first + k - 1])
+				return false;
+		}
+
+		return true;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void ComboRecognizer::Feed(ComboRecognizer::Cursor& cursor, uint8_t symbol, uint64_t timestamp, ComboRecognizer::Match* matches, size_t capacity, size_t& count) const
+	{
+		// After a pause longer than any window, no partial match can complete, so start over from the root.
+		if (cursor.tokens != 0 && timestamp - cursor.times[(cursor.tokens - 1) % MaxLength] > m_maxWindow)
+			cursor.node = 0;
+
+		cursor.times[cursor.tokens % MaxLength] = timestamp;
+		++cursor.tokens;
+		cursor.node = m_next[cursor.node * Symbols + symbol];
+
+		uint32_t node = cursor.node;
+
+		if (m_outputs[node].count == 0)
+			node = m_outputs[node].next;
+
+		for (; node != 0; node = m_outputs[node].next)
+		{
+			const Output& output = m_outputs[node];
+
+			for (uint32_t i = 0; i < output.count; ++i)
+			{
+				const Spelling& spelling = m_spellings[m_ends[output.first + i]];
+
+				if (!Timed(spelling, cursor))
+					continue;
+
+				if (count < capacity)
+					matches[count] = { spelling.pattern, timestamp };
+
+				++count;
+			}
+		}
+	}
+
+}
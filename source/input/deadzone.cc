@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <cmath>
+
+#include "decaf/input/deadzone.hh"
+
+namespace decaf
+{
+
+	namespace Deadzone
+	{
+
+		namespace
+		{
+
+			inline float Rescale(float magnitude, float inner, float outer)
+			{
+				float range = outer - inner;
+				return (range <= 0 ? 1.0f : std::min(1.0f, (magnitude - inner) / range));
+			}
+
+			inline float Axial(float value, float inner, float outer)
+			{
+				float magnitude = fabsf(value);
+
+				if (magnitude < inner)
+					return 0.0f;
+
+				return copysignf(Rescale(magnitude, inner, outer), value);
+			}
+
+			inline Vector2f ScaledRadial(const Vector2f& stick, float lengthSquared, float inner, float outer)
+			{
+				float length = sqrtf(lengthSquared);
+				return stick * (Rescale(length, inner, outer) / length);
+			}
+
+		}
+
+
+		////////////////////////////////////////////////////////////
+		Vector2f Apply(const Vector2f& stick, const DeadzoneSettings& settings)
+		{
+			const float inner = settings.inner;
+			const float outer = settings.outer;
+
+			switch (settings.mode)
+			{
+				case DeadzoneSettings::Mode::AXIAL:
+					return Vector2f(Axial(stick.X(), inner, outer), Axial(stick.Y(), inner, outer));
+
+				case DeadzoneSettings::Mode::RADIAL:
+				{
+					float lengthSquared = stick.LengthSquared();
+
+					if (lengthSquared < inner * inner)
+						return Vector2f(0.0f);
+
+					// Past the outer edge the magnitude is held at the edge, so the output never jumps.
+					if (lengthSquared > outer * outer)
+						return stick * (outer / sqrtf(lengthSquared));
+
+					return stick;
+				}
+
+				case DeadzoneSettings::Mode::SCALED_RADIAL:
+				{
+					float lengthSquared = stick.LengthSquared();
+
+					// The edge counts as dead, so a centred stick with no inner deadzone never divides by its zero length.
+					if (lengthSquared <= inner * inner)
+						return Vector2f(0.0f);
+
+					return ScaledRadial(stick, lengthSquared, inner, outer);
+				}
+
+				case DeadzoneSettings::Mode::HYBRID:
+				{
+					float lengthSquared = stick.LengthSquared();
+
+					if (lengthSquared < inner * inner)
+						return Vector2f(0.0f);
+
+					Vector2f snapped(stick);
+					float slopeX = inner * fabsf(stick.Y());
+					float slopeY = inner * fabsf(stick.X());
+
+					if (fabsf(stick.X()) < slopeX)
+						snapped.X() = 0.0f;
+					else if (slopeX < 1.0f)
+						snapped.X() = copysignf((fabsf(stick.X()) - slopeX) / (1.0f - slopeX), stick.X());
+
+					if (fabsf(stick.Y()) < slopeY)
+						snapped.Y() = 0.0f;
+					else if (slopeY < 1.0f)
+						snapped.Y() = copysignf((fabsf(stick.Y()) - slopeY) / (1.0f - slopeY), stick.Y());
+
+					// The snapped direction keeps the magnitude of the scaled radial result.
+					float snappedSquared = snapped.LengthSquared();
+					if (snappedSquared == 0.0f)
+						return Vector2f(0.0f);
+
+					float magnitude = Rescale(sqrtf(lengthSquared), inner, outer);
+					return snapped * (magnitude / sqrtf(snappedSquared));
+				}
+
+				case DeadzoneSettings::Mode::XINPUT:
+				default:
+					return stick;
+			}
+		}
+
+
+		////////////////////////////////////////////////////////////
+		void Apply(Vector2f* sticks, size_t count, const DeadzoneSettings& settings)
+		{
+			if (settings.mode == DeadzoneSettings::Mode::XINPUT)
+				return;
+
+			for (size_t i = 0; i < count; ++i)
+				sticks[i] = Apply(sticks[i], settings);
+		}
+
+
+		////////////////////////////////////////////////////////////
+		void Apply(Vector2f* sticks, const DeadzoneSettings* settings, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (settings[i].mode != DeadzoneSettings::Mode::XINPUT)
+					sticks[i] = Apply(sticks[i], settings[i]);
+			}
+		}
+
+	}
+
+}
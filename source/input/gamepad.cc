@@ -1,96 +1,721 @@
+#include <atomic>
+#include <type_traits>
+
+#include "decaf/concurrent/triplebuffer.hh"
+#include "decaf/input/deadzone.hh"
 #include "decaf/input/gamepad.hh"
+#include "decaf/input/gamepadcontext.hh"
+#include "decaf/input/gamepadevents.hh"
 #include "decaf/input/gamepadimpl.hh"
+#include "decaf/input/gamepadsampler.hh"
+#include "decaf/input/latelatch.hh"
+#include "decaf/input/latency.hh"
+#include "decaf/input/response.hh"
+#include "decaf/input/rumble.hh"
+#include "decaf/input/stickfilter.hh"
 
 namespace decaf
 {
 
+	namespace
+	{
+
+		GamepadSampler& Sampler()
+		{
+			static GamepadSampler sampler;
+			return sampler;
+		}
+
+		GamepadEventQueue& Events()
+		{
+			static GamepadEventQueue events;
+			return events;
+		}
+
+		RumbleMixer& Rumble()
+		{
+			static RumbleMixer rumble;
+			return rumble;
+		}
+
+		StickFilter& Filters()
+		{
+			static StickFilter filters;
+			return filters;
+		}
+
+		LateLatch& Latches()
+		{
+			static LateLatch latches;
+			return latches;
+		}
+
+		GamepadSettings* AllSettings()
+		{
+			static GamepadSettings settings[Gamepad::IndexCount] = {};
+			return settings;
+		}
+
+		GamepadSettings& Settings(Gamepad::Index index)
+		{
+			return AllSettings()[static_cast<size_t>(index)];
+		}
+
+		/// <summary>Each pad's settings as last set, published for <c>Latch</c> so the render thread never reads them while the game thread writes them.</summary>
+		TripleBuffer<GamepadSettings>* LatchSettings()
+		{
+			static TripleBuffer<GamepadSettings> settings[Gamepad::IndexCount];
+			return settings;
+		}
+
+		/// <summary>Bumped whenever deadzones or filters change, so polls know a repeated packet may still convert differently.</summary>
+		std::atomic<uint32_t>& SettingsVersion()
+		{
+			static std::atomic<uint32_t> version{ 1 };
+			return version;
+		}
+
+		inline void ApplySettings(const GamepadSettings& settings, Gamepad::State& state)
+		{
+			state.leftStick = Deadzone::Apply(state.leftStick, settings.leftStick);
+			state.rightStick = Deadzone::Apply(state.rightStick, settings.rightStick);
+		}
+
+		inline void ApplySettings(Gamepad::Index index, Gamepad::State& state)
+		{
+			ApplySettings(Settings(index), state);
+		}
+
+		/// <summary>The packed counterpart of <c>Gamepad::Diff</c>, without the <c>CONNECTED</c> bit.</summary>
+		inline uint8_t DiffPacked(const Gamepad::RawState& previous, const Gamepad::RawState& current)
+		{
+			uint8_t changed = 0;
+
+			changed |= (previous.buttons != current.buttons) ? static_cast<uint8_t>(Gamepad::Field::BUTTONS) : 0;
+			changed |= (previous.thumbLX != current.thumbLX || previous.thumbLY != current.thumbLY) ? static_cast<uint8_t>(Gamepad::Field::LEFT_STICK) : 0;
+			changed |= (previous.thumbRX != current.thumbRX || previous.thumbRY != current.thumbRY) ? static_cast<uint8_t>(Gamepad::Field::RIGHT_STICK) : 0;
+			changed |= (previous.leftTrigger != current.leftTrigger) ? static_cast<uint8_t>(Gamepad::Field::LEFT_TRIGGER) : 0;
+			changed |= (previous.rightTrigger != current.rightTrigger) ? static_cast<uint8_t>(Gamepad::Field::RIGHT_TRIGGER) : 0;
+
+			return changed;
+		}
+
+		/// <summary>Reads the first <paramref name='count'/> pads from the sampler or the backend, before their deadzones and filters.</summary>
+		uint32_t ReadStates(Gamepad::State* states, size_t count, bool sampling)
+		{
+			uint32_t connected = 0;
+
+			if (sampling)
+			{
+				GamepadSampler& sampler = Sampler();
+
+				for (size_t i = 0; i < count && i < Gamepad::IndexCount; ++i)
+				{
+					sampler.Read(static_cast<Gamepad::Index>(i), states[i]);
+					connected |= (states[i].connected ? 1u : 0u) << i;
+				}
+			}
+			else
+			{
+				IGamepadImpl* _impl = IGamepadImpl::Instance();
+				connected = _impl->GetStates(states, count);
+			}
+
+			return connected;
+		}
+
+#if defined (DECAF_INPUT_NO_LATENCY)
+		constexpr bool LatencyEnabled = false;
+
+		inline void RecordPoll(Gamepad::Index, bool, bool, uint64_t, uint64_t) { }
+#else
+		constexpr bool LatencyEnabled = true;
+
+		LatencyHistogram& Histogram(Gamepad::Index index, Gamepad::Latency latency)
+		{
+			static LatencyHistogram histograms[Gamepad::IndexCount][2];
+			return histograms[static_cast<size_t>(index)][static_cast<size_t>(latency)];
+		}
+
+		/// <param name='fresh'>Whether the poll read a packet or timestamp the previous poll did not. Re-reading an idle pad's sample would measure idle time, not latency.</param>
+		inline void RecordPoll(Gamepad::Index index, bool fresh, bool connected, uint64_t timestamp, uint64_t now)
+		{
+			if (fresh && connected && timestamp != 0 && now >= timestamp)
+				Histogram(index, Gamepad::Latency::SAMPLE_TO_POLL).Record(now - timestamp);
+		}
+#endif
+
+	}
+
+
 	////////////////////////////////////////////////////////////
 	Gamepad::State Gamepad::GetState(Gamepad::Index index)
 	{
-		IGamepadImpl* _impl = IGamepadImpl::Instance();
-		return _impl->GetState(index);
+		GamepadSampler& sampler = Sampler();
+		Gamepad::State result;
+
+		if (sampler.IsRunning())
+		{
+			sampler.Read(index, result);
+		}
+		else
+		{
+			IGamepadImpl* _impl = IGamepadImpl::Instance();
+			result = _impl->GetState(index);
+		}
+
+		ApplySettings(index, result);
+		Filters().Apply(index, result, GamepadEventQueue::Now());
+		return result;
 	}
 
 
 	////////////////////////////////////////////////////////////
 	Gamepad::State Gamepad::GetState(Gamepad::Index index, float deadzone)
 	{
+		// While sampling only the sampler thread may read the backend, so convert its newest reading here instead.
+		Gamepad::RawState raw;
+		Gamepad::State result;
+		if (Sampler().IsRunning() && Sampler().ReadRaw(index, raw, result))
+		{
+			GamepadResponse::XInput(deadzone).Decode(raw, result);
+			return result;
+		}
+
 		IGamepadImpl* _impl = IGamepadImpl::Instance();
 		return _impl->GetState(index, deadzone);
 	}
 
 
+	////////////////////////////////////////////////////////////
+	Gamepad::State Gamepad::GetState(Gamepad::Index index, const DeadzoneSettings& deadzone)
+	{
+		IGamepadImpl* _impl = IGamepadImpl::Instance();
+		const GamepadResponse& response = (deadzone.mode == DeadzoneSettings::Mode::XINPUT ? _impl->GetResponse(index) : GamepadResponse::Linear());
+
+		Gamepad::RawState raw;
+		Gamepad::State result;
+		if (Sampler().IsRunning() && Sampler().ReadRaw(index, raw, result))
+			response.Decode(raw, result);
+		else
+			result = _impl->GetState(index, response);
+
+		Vector2f sticks[2] = { result.leftStick, result.rightStick };
+		Deadzone::Apply(sticks, 2, deadzone);
+
+		result.leftStick = sticks[0];
+		result.rightStick = sticks[1];
+		return result;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint32_t Gamepad::GetStates(Gamepad::State* states, size_t count)
+	{
+		uint32_t connected = ReadStates(states, count, Sampler().IsRunning());
+
+		GamepadContextBase::ApplySettings(AllSettings(), states, count < IndexCount ? count : IndexCount);
+		Filters().Apply(states, count, GamepadEventQueue::Now());
+		return connected;
+	}
+
+
 	////////////////////////////////////////////////////////////
 	void Gamepad::SetRumble(Gamepad::Index index, float left, float right)
 	{
+		Rumble().SetLevel(index, left, right, GamepadEventQueue::Now());
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint32_t Gamepad::PlayRumble(Gamepad::Index index, const RumbleEffect& effect)
+	{
+		return Rumble().Play(index, effect, GamepadEventQueue::Now());
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void Gamepad::StopRumble(uint32_t handle)
+	{
+		Rumble().Stop(handle, GamepadEventQueue::Now());
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void Gamepad::FlushRumble()
+	{
+		// While sampling only the sampler thread may call into the backend, so wait for it to submit.
+		while (Sampler().IsRunning())
+		{
+			if (Rumble().Flush(std::chrono::milliseconds(1)))
+				return;
+		}
+
+		IGamepadImpl* _impl = IGamepadImpl::Instance();
+		Rumble().Submit(*_impl);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void Gamepad::SetResponse(Gamepad::Index index, const GamepadResponse& response)
+	{
+		// Polls notice the new curves through the backend's response epoch once a read has picked them up.
 		IGamepadImpl* _impl = IGamepadImpl::Instance();
-		_impl->SetRumble(index, left, right);
+		_impl->SetResponse(index, response);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void Gamepad::SetSettings(Gamepad::Index index, const GamepadSettings& settings)
+	{
+		IGamepadImpl* _impl = IGamepadImpl::Instance();
+		_impl->SetResponse(index, GamepadContextBase::ResponseFor(_impl->GetResponse(index), settings));
+		Settings(index) = settings;
+		SettingsVersion().fetch_add(1, std::memory_order_release);
+
+		TripleBuffer<GamepadSettings>& published = LatchSettings()[static_cast<size_t>(index)];
+		published.WriteBuffer() = settings;
+		published.Publish();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	const GamepadSettings& Gamepad::GetSettings(Gamepad::Index index)
+	{
+		return Settings(index);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void Gamepad::SetStickFilter(Gamepad::Index index, const StickFilterSettings& left, const StickFilterSettings& right)
+	{
+		Filters().SetSettings(index, left, right);
+		SettingsVersion().fetch_add(1, std::memory_order_release);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void Gamepad::Update()
+	{
+		Rumble().Tick(GamepadEventQueue::Now());
+
+		if (Sampler().IsRunning())
+			return;
+
+		IGamepadImpl* _impl = IGamepadImpl::Instance();
+		_impl->SetEventQueue(&Events());
+		_impl->Update();
+		Rumble().Submit(*_impl);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool Gamepad::IsConnected(Gamepad::Index index)
+	{
+		IGamepadImpl* _impl = IGamepadImpl::Instance();
+		return _impl->IsConnected(index);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	size_t Gamepad::DeviceCount()
+	{
+		size_t count;
+		if (Sampler().IsRunning() && Sampler().ReadDeviceCount(count))
+			return count;
+
+		IGamepadImpl* _impl = IGamepadImpl::Instance();
+		return _impl->DeviceCount();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	size_t Gamepad::GetDevices(Gamepad::DeviceId* ids, Gamepad::State* states, size_t capacity)
+	{
+		// While sampling the sampler thread owns the backend's device registry, so serve its newest snapshot.
+		size_t count;
+		if (Sampler().IsRunning() && Sampler().ReadDevices(ids, states, capacity, count))
+			return count;
+
+		IGamepadImpl* _impl = IGamepadImpl::Instance();
+		return _impl->GetDevices(ids, states, capacity);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	Gamepad::DeviceId Gamepad::GetDeviceId(Gamepad::Index index)
+	{
+		IGamepadImpl* _impl = IGamepadImpl::Instance();
+		return _impl->GetDeviceId(index);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool Gamepad::StartSampling(std::chrono::microseconds period)
+	{
+		IGamepadImpl* _impl = IGamepadImpl::Instance();
+		_impl->SetEventQueue(&Events());
+		return Sampler().Start(_impl, period, &Events(), &Rumble());
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void Gamepad::StopSampling()
+	{
+		Sampler().Stop();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool Gamepad::IsSampling()
+	{
+		return Sampler().IsRunning();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void Gamepad::SetAxisEventThreshold(float threshold)
+	{
+		Events().SetAxisThreshold(threshold);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint32_t Gamepad::RegisterLatch(Gamepad::Index index, Gamepad::LatchFunction function, void* slot, void* context)
+	{
+		return Latches().Register(index, function, slot, context);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void Gamepad::UnregisterLatch(uint32_t handle)
+	{
+		Latches().Unregister(handle);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	size_t Gamepad::Latch()
+	{
+		GamepadSampler& sampler = Sampler();
+		LateLatch& latches = Latches();
+
+		if (!sampler.IsRunning() || latches.Count() == 0)
+			return 0;
+
+		Gamepad::State states[IndexCount];
+
+		for (size_t i = 0; i < IndexCount; ++i)
+		{
+			if ((latches.Pads() & (1u << i)) == 0)
+				continue;
+
+			// The settings are a published copy: SetSettings may be rewriting the game thread's own at this moment.
+			TripleBuffer<GamepadSettings>& settings = LatchSettings()[i];
+			settings.Acquire();
+
+			sampler.ReadLatest(static_cast<Gamepad::Index>(i), states[i]);
+			ApplySettings(settings.ReadBuffer(), states[i]);
+		}
+
+		return latches.Fill(states);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	LatencyStats Gamepad::GetLatency(Gamepad::Index index, Gamepad::Latency latency)
+	{
+#if defined (DECAF_INPUT_NO_LATENCY)
+		(void)index;
+		(void)latency;
+		return LatencyStats();
+#else
+		return Histogram(index, latency).Stats();
+#endif
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void Gamepad::ResetLatency(Gamepad::Index index)
+	{
+#if defined (DECAF_INPUT_NO_LATENCY)
+		(void)index;
+#else
+		Histogram(index, Latency::SAMPLE_TO_POLL).Reset();
+		Histogram(index, Latency::POLL_TO_CONSUME).Reset();
+#endif
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint8_t Gamepad::Diff(const Gamepad::State& previous, const Gamepad::State& current)
+	{
+		uint8_t changed = 0;
+
+		changed |= (previous.buttons != current.buttons) ? static_cast<uint8_t>(Field::BUTTONS) : 0;
+		changed |= (previous.leftStick != current.leftStick) ? static_cast<uint8_t>(Field::LEFT_STICK) : 0;
+		changed |= (previous.rightStick != current.rightStick) ? static_cast<uint8_t>(Field::RIGHT_STICK) : 0;
+		changed |= (previous.leftTrigger != current.leftTrigger) ? static_cast<uint8_t>(Field::LEFT_TRIGGER) : 0;
+		changed |= (previous.rightTrigger != current.rightTrigger) ? static_cast<uint8_t>(Field::RIGHT_TRIGGER) : 0;
+		changed |= (previous.connected != current.connected) ? static_cast<uint8_t>(Field::CONNECTED) : 0;
+
+		return changed;
 	}
 
 
 	////////////////////////////////////////////////////////////
 	Gamepad::Gamepad(Gamepad::Index index) 
-		: m_index{ index }, m_lastState{ 0 }, m_currState{ 0 } { }
+		: m_index{ index }, m_lastState{}, m_currState{}, m_packet{ 0 }, m_timestamp{ 0 }, m_pollTime{ 0 }, m_eventFirst{ 0 }, m_eventCount{ 0 },
+		  m_droppedBase{ 0 }, m_eventsLost{ 0 }, m_settingsVersion{ 0 }, m_pressed{ 0 }, m_released{ 0 }, m_changed{ 0 }, m_lastConnected{ false }, m_connected{ false }
+	{
+		// Start reading events from now on, so a pad created late never sees presses that happened before it existed.
+		SkipEvents();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint32_t Gamepad::Poll(Gamepad* gamepads, size_t count)
+	{
+		Gamepad::State states[IndexCount];
+		bool sampling = Sampler().IsRunning();
+		uint32_t connected = ReadStates(states, IndexCount, sampling);
+		uint64_t timestamp = GamepadEventQueue::Now();
+
+		// Events come from the states before deadzones, exactly as the sampler thread emits them.
+		if (!sampling)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				const Gamepad& gamepad = gamepads[i];
+				const Gamepad::State& state = states[static_cast<size_t>(gamepad.m_index)];
+
+				if (gamepad.IsNewSample(state))
+					Events().Sample(gamepad.m_index, state, timestamp);
+			}
+		}
+
+		GamepadContextBase::ApplySettings(AllSettings(), states, IndexCount);
+		Filters().Apply(states, IndexCount, timestamp);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			Gamepad& gamepad = gamepads[i];
+			const Gamepad::State& state = states[static_cast<size_t>(gamepad.m_index)];
+			bool fresh = gamepad.IsNewStamp(state);
+			gamepad.Store(state);
+
+			RecordPoll(gamepad.m_index, fresh, gamepad.m_connected, gamepad.m_timestamp, timestamp);
+			gamepad.m_pollTime = timestamp;
+			gamepad.CollectEvents();
+		}
+
+		return connected;
+	}
 
 
 	////////////////////////////////////////////////////////////
 	bool Gamepad::Poll()
 	{
-		memcpy(&m_lastState, &m_currState, sizeof(Gamepad::State));
-		m_currState = GetState(m_index);
+		GamepadSampler& sampler = Sampler();
+		Gamepad::State state;
+		uint32_t responseEpoch;
+		uint64_t now;
+		bool fresh;
+
+		if (sampler.IsRunning())
+		{
+			sampler.Read(m_index, state, responseEpoch);
+			now = (LatencyEnabled || Filters().IsActive()) ? GamepadEventQueue::Now() : 0;
+			fresh = IsNewStamp(state);
+			Accept(state, responseEpoch, now);
+		}
+		else
+		{
+			IGamepadImpl* _impl = IGamepadImpl::Instance();
+			state = _impl->GetState(m_index);
+			responseEpoch = _impl->ResponseEpoch();
+			now = GamepadEventQueue::Now();
+
+			// Events come from the state before deadzones, exactly as the sampler thread emits them.
+			if (IsNewSample(state))
+				Events().Sample(m_index, state, now);
+
+			fresh = IsNewStamp(state);
+			Accept(state, responseEpoch, now);
+		}
+
+		RecordPoll(m_index, fresh, m_connected, m_timestamp, now);
+		m_pollTime = now;
+		CollectEvents();
+
+		return m_connected;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool Gamepad::IsNewSample(const Gamepad::State& state) const
+	{
+		return state.packet == 0 || state.packet != m_packet || state.connected != m_connected;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool Gamepad::IsNewStamp(const Gamepad::State& state) const
+	{
+		return state.packet != m_packet || state.timestamp != m_timestamp;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void Gamepad::Accept(const Gamepad::State& state, uint32_t responseEpoch, uint64_t now)
+	{
+		// Both counters only grow, so their sum changes whenever the settings or the curves the state was converted with do.
+		uint32_t version = SettingsVersion().load(std::memory_order_acquire) + responseEpoch;
+
+		// The same packet under the same settings and curves converts to the same state, so an idle pad skips the deadzones and the diff.
+		// A stick filter still catching up with the packet is the exception: it must keep running until it settles.
+		if (state.packet != 0 && state.packet == m_packet && state.connected == m_connected && version == m_settingsVersion && Filters().IsSettled(m_index))
+		{
+			m_lastState = m_currState;
+			m_lastConnected = m_connected;
+			m_changed = 0;
+			return;
+		}
+
+		Gamepad::State processed = state;
+		ApplySettings(m_index, processed);
+		Filters().Apply(m_index, processed, now);
+		m_settingsVersion = version;
+		Store(processed);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void Gamepad::Store(const Gamepad::State& state)
+	{
+		m_lastState = m_currState;
+		m_lastConnected = m_connected;
+
+		GamepadResponse::Pack(state, m_currState);
+		m_connected = state.connected;
+		m_packet = state.packet;
+		m_timestamp = state.timestamp;
 
-		return m_currState.connected;
+		m_changed = DiffPacked(m_lastState, m_currState);
+		m_changed |= (m_lastConnected != m_connected) ? static_cast<uint8_t>(Field::CONNECTED) : 0;
 	}
 
 
 	////////////////////////////////////////////////////////////
 	bool Gamepad::IsConnected() const
 	{
-		Gamepad::State temp = GetState(m_index);
-		return temp.connected;
+		return m_connected;
 	}
 
 
 	////////////////////////////////////////////////////////////
 	bool Gamepad::StateChanged() const
 	{
-		return memcmp(&m_lastState, &m_currState, sizeof(Gamepad::State)) != 0;
+		return m_changed != 0;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint8_t Gamepad::ChangedFields() const
+	{
+		return m_changed;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool Gamepad::FieldChanged(Gamepad::Field field) const
+	{
+		return (m_changed & static_cast<uint8_t>(field)) != 0;
 	}
 
 
 	////////////////////////////////////////////////////////////
 	void Gamepad::Clear()
 	{
-		memset(&m_lastState, 0, sizeof(Gamepad::State));
-		memset(&m_currState, 0, sizeof(Gamepad::State));
+		m_lastState = Gamepad::RawState();
+		m_currState = Gamepad::RawState();
+		m_packet = 0;
+		m_timestamp = 0;
+		m_lastConnected = false;
+		m_connected = false;
+
+		SkipEvents();
+		m_pressed = 0;
+		m_released = 0;
+		m_pollTime = 0;
+		m_changed = 0;
+		m_settingsVersion = 0;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	Gamepad::State Gamepad::CurrentState() const
+	{
+		Gamepad::State state;
+		GamepadResponse::Linear().Decode(m_currState, state);
+		state.connected = m_connected;
+		state.packet = m_packet;
+		state.timestamp = m_timestamp;
+		return state;
 	}
 
 
 	////////////////////////////////////////////////////////////
-	const Vector2f& Gamepad::LeftStick() const
+	Gamepad::State Gamepad::PreviousState() const
 	{
-		return m_currState.leftStick;
+		Gamepad::State state;
+		GamepadResponse::Linear().Decode(m_lastState, state);
+		state.connected = m_lastConnected;
+		state.packet = 0;
+		state.timestamp = 0;
+		return state;
 	}
 
 
 	////////////////////////////////////////////////////////////
-	const Vector2f& Gamepad::RightStick() const
+	const Gamepad::RawState& Gamepad::PackedState() const
 	{
-		return m_currState.rightStick;
+		return m_currState;
 	}
 
 
 	////////////////////////////////////////////////////////////
-	const float& Gamepad::LeftTrigger() const
+	uint64_t Gamepad::Timestamp() const
 	{
-		return m_currState.leftTrigger;
+		return m_timestamp;
 	}
 
 
 	////////////////////////////////////////////////////////////
-	const float& Gamepad::RightTrigger() const
+	Vector2f Gamepad::LeftStick() const
 	{
-		return m_currState.rightTrigger;
+		return StickResponse::Linear()(m_currState.thumbLX, m_currState.thumbLY);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	Vector2f Gamepad::RightStick() const
+	{
+		return StickResponse::Linear()(m_currState.thumbRX, m_currState.thumbRY);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	float Gamepad::LeftTrigger() const
+	{
+		return TriggerResponse::Linear()(m_currState.leftTrigger);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	float Gamepad::RightTrigger() const
+	{
+		return TriggerResponse::Linear()(m_currState.rightTrigger);
 	}
 
 
@@ -106,7 +731,7 @@ namespace decaf
 	bool Gamepad::WasButtonPressed(Button button) const
 	{
 		using Type = std::underlying_type<Gamepad::Button>::type;
-		return ((m_currState.buttons & static_cast<Type>(button)) != 0) && ((m_lastState.buttons & static_cast<Type>(button)) == 0);
+		return ((m_pressed & static_cast<Type>(button)) != 0);
 	}
 
 
@@ -114,7 +739,28 @@ namespace decaf
 	bool Gamepad::WasButtonReleased(Button button) const
 	{
 		using Type = std::underlying_type<Gamepad::Button>::type;
-		return ((m_currState.buttons & static_cast<Type>(button)) == 0) && ((m_lastState.buttons & static_cast<Type>(button)) != 0);
+		return ((m_released & static_cast<Type>(button)) != 0);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	size_t Gamepad::EventCount() const
+	{
+		return m_eventCount;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	const Gamepad::Event& Gamepad::GetEvent(size_t i) const
+	{
+		return Events().Get(m_index, m_eventFirst + i);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint64_t Gamepad::DroppedEvents() const
+	{
+		return Events().Dropped(m_index) - m_droppedBase + m_eventsLost;
 	}
 
 
@@ -124,4 +770,62 @@ namespace decaf
 		SetRumble(m_index, left, right);
 	}
 
+
+	////////////////////////////////////////////////////////////
+	void Gamepad::MarkConsumed()
+	{
+#if !defined (DECAF_INPUT_NO_LATENCY)
+		if (m_pollTime == 0)
+			return;
+
+		uint64_t now = GamepadEventQueue::Now();
+		Histogram(m_index, Latency::POLL_TO_CONSUME).Record(now - m_pollTime);
+		m_pollTime = 0;
+#endif
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void Gamepad::CollectEvents()
+	{
+		GamepadEventQueue& events = Events();
+
+		// Every pad object keeps its own cursor into the log, so objects sharing an index each see every event once.
+		uint64_t end = events.Collect(m_index);
+		uint64_t first = m_eventFirst + m_eventCount;
+
+		if (end - first > GamepadEventQueue::Capacity)
+		{
+			m_eventsLost += end - first - GamepadEventQueue::Capacity;
+			first = end - GamepadEventQueue::Capacity;
+		}
+
+		m_eventFirst = first;
+		m_eventCount = static_cast<size_t>(end - first);
+		m_pressed = 0;
+		m_released = 0;
+
+		for (size_t i = 0; i < m_eventCount; ++i)
+		{
+			const Gamepad::Event& event = events.Get(m_index, first + i);
+
+			if (event.type == EventType::BUTTON_DOWN)
+				m_pressed |= event.code;
+			else if (event.type == EventType::BUTTON_UP)
+				m_released |= event.code;
+		}
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void Gamepad::SkipEvents()
+	{
+		GamepadEventQueue& events = Events();
+
+		m_eventFirst = events.Collect(m_index);
+		m_eventCount = 0;
+		m_droppedBase = events.Dropped(m_index);
+		m_eventsLost = 0;
+	}
+
 }
@@ -0,0 +1,146 @@
+#include "decaf/input/gamepadcontext.hh"
+#include "decaf/input/response.hh"
+
+namespace decaf
+{
+
+	namespace
+	{
+
+		/// <summary>Swaps a built-in stick curve for the one a deadzone mode expects. Custom curves are the caller's choice and are kept.</summary>
+		const StickResponse& StickFor(const StickResponse& stick, const DeadzoneSettings& deadzone, const StickResponse& xinput)
+		{
+			bool linear = (deadzone.mode != DeadzoneSettings::Mode::XINPUT);
+
+			if (linear && (stick.Table() == StickResponse::XInputLeft().Table() || stick.Table() == StickResponse::XInputRight().Table()))
+				return StickResponse::Linear();
+
+			if (!linear && stick.Table() == StickResponse::Linear().Table())
+				return xinput;
+
+			return stick;
+		}
+
+	}
+
+
+	////////////////////////////////////////////////////////////
+	GamepadContextBase::GamepadContextBase()
+		: m_settings{} { }
+
+
+	////////////////////////////////////////////////////////////
+	GamepadResponse GamepadContextBase::ResponseFor(const GamepadResponse& response, const GamepadSettings& settings)
+	{
+		GamepadResponse result = response;
+
+		// Every mode but XINPUT works on linear input, so the backend must stop applying its own deadzone.
+		result.leftStick = StickFor(response.leftStick, settings.leftStick, StickResponse::XInputLeft());
+		result.rightStick = StickFor(response.rightStick, settings.rightStick, StickResponse::XInputRight());
+
+		return result;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadContextBase::ApplySettings(const GamepadSettings* settings, Gamepad::State* states, size_t count)
+	{
+		constexpr size_t Chunk = Gamepad::IndexCount;
+
+		// Gather every stick so all pads go through the deadzone stage in one pass.
+		for (size_t first = 0; first < count; first += Chunk)
+		{
+			size_t pads = (count - first < Chunk ? count - first : Chunk);
+			Vector2f sticks[Chunk * 2];
+			DeadzoneSettings deadzones[Chunk * 2];
+
+			for (size_t i = 0; i < pads; ++i)
+			{
+				sticks[i * 2] = states[first + i].leftStick;
+				sticks[i * 2 + 1] = states[first + i].rightStick;
+				deadzones[i * 2] = settings[first + i].leftStick;
+				deadzones[i * 2 + 1] = settings[first + i].rightStick;
+			}
+
+			Deadzone::Apply(sticks, deadzones, pads * 2);
+
+			for (size_t i = 0; i < pads; ++i)
+			{
+				states[first + i].leftStick = sticks[i * 2];
+				states[first + i].rightStick = sticks[i * 2 + 1];
+			}
+		}
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadContextBase::ApplySettings(Gamepad::Index index, Gamepad::State& state) const
+	{
+		const GamepadSettings& settings = m_settings[static_cast<size_t>(index)];
+
+		state.leftStick = Deadzone::Apply(state.leftStick, settings.leftStick);
+		state.rightStick = Deadzone::Apply(state.rightStick, settings.rightStick);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void AnyGamepadContext::Update()
+	{
+		m_backend->Update();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	Gamepad::State AnyGamepadContext::GetState(Gamepad::Index index)
+	{
+		Gamepad::State state = m_backend->GetState(index);
+		m_context->ApplySettings(index, state);
+		return state;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint32_t AnyGamepadContext::GetStates(Gamepad::State* states, size_t count)
+	{
+		uint32_t connected = m_backend->GetStates(states, count);
+		GamepadContextBase::ApplySettings(m_context->m_settings, states, count < Gamepad::IndexCount ? count : Gamepad::IndexCount);
+		return connected;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool AnyGamepadContext::IsConnected(Gamepad::Index index) const
+	{
+		return m_backend->IsConnected(index);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	size_t AnyGamepadContext::GetDevices(Gamepad::DeviceId* ids, Gamepad::State* states, size_t capacity)
+	{
+		return m_backend->GetDevices(ids, states, capacity);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void AnyGamepadContext::SetRumble(Gamepad::Index index, float left, float right)
+	{
+		m_backend->SetRumble(index, left, right);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void AnyGamepadContext::SetSettings(Gamepad::Index index, const GamepadSettings& settings)
+	{
+		m_backend->SetResponse(index, GamepadContextBase::ResponseFor(m_backend->GetResponse(index), settings));
+		m_context->m_settings[static_cast<size_t>(index)] = settings;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	const GamepadSettings& AnyGamepadContext::GetSettings(Gamepad::Index index) const
+	{
+		return m_context->GetSettings(index);
+	}
+
+}
@@ -0,0 +1,120 @@
+#include <chrono>
+
+#include "decaf/input/gamepadevents.hh"
+
+namespace decaf
+{
+
+	namespace
+	{
+
+		inline int8_t Zone(float value, float threshold)
+		{
+			return (value > threshold ? 1 : (value < -threshold ? -1 : 0));
+		}
+
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint64_t GamepadEventQueue::Now()
+	{
+		using namespace std::chrono;
+		return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+	}
+
+
+	////////////////////////////////////////////////////////////
+	GamepadEventQueue::GamepadEventQueue()
+		: m_threshold{ 0.5f }
+	{
+		for (Channel& channel : m_channels)
+		{
+			channel.dropped.store(0, std::memory_order_relaxed);
+			channel.buttons = 0;
+			channel.logged = 0;
+
+			for (int8_t& zone : channel.zones)
+				zone = 0;
+		}
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadEventQueue::SetAxisThreshold(float threshold)
+	{
+		m_threshold.store(threshold, std::memory_order_relaxed);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadEventQueue::Sample(Gamepad::Index index, const Gamepad::State& state, uint64_t timestamp)
+	{
+		Channel& channel = m_channels[static_cast<size_t>(index)];
+
+		uint16_t changed = channel.buttons ^ state.buttons;
+		channel.buttons = state.buttons;
+
+		while (changed != 0)
+		{
+			uint16_t bit = changed & static_cast<uint16_t>(-changed);
+			changed ^= bit;
+
+			Gamepad::EventType type = ((state.buttons & bit) != 0 ? Gamepad::EventType::BUTTON_DOWN : Gamepad::EventType::BUTTON_UP);
+			Push(channel, { timestamp, bit, type, 0 });
+		}
+
+		float threshold = m_threshold.load(std::memory_order_relaxed);
+		const float values[6] = { state.leftStick[0], state.leftStick[1], state.rightStick[0], state.rightStick[1], state.leftTrigger, state.rightTrigger };
+
+		for (size_t i = 0; i < 6; ++i)
+		{
+			int8_t zone = Zone(values[i], threshold);
+
+			if (zone != channel.zones[i])
+			{
+				channel.zones[i] = zone;
+				Push(channel, { timestamp, static_cast<uint16_t>(i), Gamepad::EventType::AXIS_CROSSED, zone });
+			}
+		}
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint64_t GamepadEventQueue::Collect(Gamepad::Index index)
+	{
+		Channel& channel = m_channels[static_cast<size_t>(index)];
+		size_t available = channel.ring.Available();
+
+		for (size_t i = 0; i < available; ++i)
+			channel.log[(channel.logged + i) & (Capacity - 1)] = channel.ring.Peek(i);
+
+		channel.ring.Release(available);
+		channel.logged += available;
+
+		return channel.logged;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	const Gamepad::Event& GamepadEventQueue::Get(Gamepad::Index index, uint64_t sequence) const
+	{
+		return m_channels[static_cast<size_t>(index)].log[sequence & (Capacity - 1)];
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint64_t GamepadEventQueue::Dropped(Gamepad::Index index) const
+	{
+		return m_channels[static_cast<size_t>(index)].dropped.load(std::memory_order_relaxed);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadEventQueue::Push(Channel& channel, const Gamepad::Event& event)
+	{
+		if (!channel.ring.TryPush(event))
+			channel.dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+
+}
@@ -0,0 +1,230 @@
+#include "decaf/input/gamepadhistory.hh"
+#include "decaf/input/response.hh"
+
+namespace decaf
+{
+
+	namespace
+	{
+
+		/// <summary>Gets the bit a single button occupies in <c>Gamepad::State::buttons</c>.</summary>
+		inline size_t BitOf(Gamepad::Button button)
+		{
+			uint32_t mask = static_cast<uint32_t>(button);
+			size_t bit = 0;
+
+			while (mask > 1)
+			{
+				mask >>= 1;
+				++bit;
+			}
+
+			return bit;
+		}
+
+		inline bool Within(uint64_t time, uint64_t window, uint64_t now)
+		{
+			return time >= now || now - time <= window;
+		}
+
+		inline bool Same(const Gamepad::RawState& lhs, const Gamepad::RawState& rhs)
+		{
+			return lhs.thumbLX == rhs.thumbLX && lhs.thumbLY == rhs.thumbLY && lhs.thumbRX == rhs.thumbRX && lhs.thumbRY == rhs.thumbRY
+				&& lhs.leftTrigger == rhs.leftTrigger && lhs.rightTrigger == rhs.rightTrigger && lhs.buttons == rhs.buttons;
+		}
+
+	}
+
+
+	////////////////////////////////////////////////////////////
+	GamepadHistory::GamepadHistory(size_t capacity)
+	{
+		size_t size = 1;
+
+		while (size < capacity)
+			size <<= 1;
+
+		m_entries.resize(size);
+		m_mask = size - 1;
+		Clear();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadHistory::Push(const Gamepad::RawState& state, bool connected, uint64_t timestamp)
+	{
+		if (m_count != 0 && timestamp < Get(0).timestamp)
+			timestamp = Get(0).timestamp;
+
+		// Edges the events already delivered leave nothing to reconcile; anything else, e.g. dropped events, is caught up here.
+		uint16_t changed = static_cast<uint16_t>(state.buttons ^ m_down);
+
+		for (size_t bit = 0; changed != 0; ++bit, changed >>= 1)
+		{
+			if ((changed & 1) == 0)
+				continue;
+
+			if ((state.buttons >> bit) & 1)
+				Press(bit, timestamp);
+			else
+				Release(bit, timestamp);
+		}
+
+		if (m_count != 0)
+		{
+			const Entry& newest = Get(0);
+
+			if (newest.connected == connected && Same(newest.state, state))
+				return;
+		}
+
+		Entry& entry = m_entries[m_count & m_mask];
+		entry.timestamp = timestamp;
+		entry.state = state;
+		entry.connected = connected;
+		++m_count;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadHistory::Record(const Gamepad& pad)
+	{
+		for (size_t i = 0; i < pad.EventCount(); ++i)
+		{
+			const Gamepad::Event& event = pad.GetEvent(i);
+
+			if (event.type == Gamepad::EventType::AXIS_CROSSED)
+				continue;
+
+			for (size_t bit = 0; bit < Buttons; ++bit)
+			{
+				if (((event.code >> bit) & 1) == 0)
+					continue;
+
+				if (event.type == Gamepad::EventType::BUTTON_DOWN)
+					Press(bit, event.timestamp);
+				else
+					Release(bit, event.timestamp);
+			}
+		}
+
+		Push(pad.PackedState(), pad.IsConnected(), pad.Timestamp());
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadHistory::Clear()
+	{
+		m_count = 0;
+		m_down = 0;
+
+		for (size_t bit = 0; bit < Buttons; ++bit)
+		{
+			m_pressCount[bit] = 0;
+			m_released[bit] = 0;
+		}
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool GamepadHistory::IsDown(Gamepad::Button button) const
+	{
+		return ((m_down >> BitOf(button)) & 1) != 0;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool GamepadHistory::WasPressedWithin(Gamepad::Button button, uint64_t window, uint64_t now) const
+	{
+		size_t bit = BitOf(button);
+		uint32_t count = m_pressCount[bit];
+
+		return count != 0 && Within(m_presses[bit][(count - 1) % PressDepth], window, now);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool GamepadHistory::WasReleasedWithin(Gamepad::Button button, uint64_t window, uint64_t now) const
+	{
+		size_t bit = BitOf(button);
+		return m_released[bit] != 0 && Within(m_released[bit], window, now);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint64_t GamepadHistory::HeldDuration(Gamepad::Button button, uint64_t now) const
+	{
+		size_t bit = BitOf(button);
+
+		if (((m_down >> bit) & 1) == 0)
+			return 0;
+
+		uint64_t pressed = m_presses[bit][(m_pressCount[bit] - 1) % PressDepth];
+		return now > pressed ? now - pressed : 0;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	size_t GamepadHistory::PressCount(Gamepad::Button button, uint64_t window, uint64_t now) const
+	{
+		size_t bit = BitOf(button);
+		uint32_t count = m_pressCount[bit];
+		size_t found = 0;
+
+		// Presses are stored oldest to newest, so the walk back stops at the first one outside the window.
+		while (found < PressDepth && found < count && Within(m_presses[bit][(count - 1 - found) % PressDepth], window, now))
+			++found;
+
+		return found;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool GamepadHistory::StateAt(uint64_t timestamp, Gamepad::State& state) const
+	{
+		size_t count = Count();
+
+		if (count == 0 || timestamp < Get(count - 1).timestamp)
+			return false;
+
+		// Find the newest snapshot not after the time: the lowest age whose timestamp passes, as timestamps fall with age.
+		size_t low = 0;
+		size_t high = count - 1;
+
+		while (low < high)
+		{
+			size_t middle = (low + high) / 2;
+
+			if (Get(middle).timestamp <= timestamp)
+				high = middle;
+			else
+				low = middle + 1;
+		}
+
+		const Entry& entry = Get(low);
+
+		GamepadResponse::Linear().Decode(entry.state, state);
+		state.connected = entry.connected;
+		state.packet = 0;
+		state.timestamp = entry.timestamp;
+		return true;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadHistory::Press(size_t bit, uint64_t timestamp)
+	{
+		m_presses[bit][m_pressCount[bit] % PressDepth] = timestamp;
+		++m_pressCount[bit];
+		m_down = static_cast<uint16_t>(m_down | (1u << bit));
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadHistory::Release(size_t bit, uint64_t timestamp)
+	{
+		m_released[bit] = timestamp;
+		m_down = static_cast<uint16_t>(m_down & ~(1u << bit));
+	}
+
+}
@@ -1,21 +1,192 @@
+#include <new>
+
+#include "decaf/input/gamepadevents.hh"
 #include "decaf/input/gamepadimpl.hh"
 
-#if defined (_WIN32)
+#if defined (DECAF_INPUT_MOCK)
+#include "decaf/input/mock/gamepadimpl_mock.hh"
+using ImplType = decaf::GamepadImpl_Mock;
+#elif defined (_WIN32)
 #include "decaf/input/win32/gamepadimpl_win32.hh"
 using ImplType = decaf::GamepadImpl_Win32;
+#elif defined (__linux__)
+#include "decaf/input/linux/gamepadimpl_linux.hh"
+using ImplType = decaf::GamepadImpl_Linux;
 #endif
 
 namespace decaf
 {
 
-	IGamepadImpl* IGamepadImpl::m_instance = nullptr;
+	namespace
+	{
+
+		/// <summary>Constructs the platform backend in static storage on first use; concurrent first calls construct it exactly once.</summary>
+		/// <remarks>It is never destroyed, because the sampler and rumble threads may still reach it while statics are being torn down at exit.</remarks>
+		IGamepadImpl* PlatformInstance()
+		{
+			alignas(ImplType) static unsigned char storage[sizeof(ImplType)];
+			static ImplType* instance = new (storage) ImplType;
+			return instance;
+		}
+
+	}
+
+	std::atomic<IGamepadImpl*> IGamepadImpl::m_instance{ nullptr };
 
 	IGamepadImpl* IGamepadImpl::Instance()
 	{
-		if (m_instance == nullptr)
-			m_instance = new ImplType;
+		IGamepadImpl* impl = m_instance.load(std::memory_order_acquire);
+		return impl != nullptr ? impl : PlatformInstance();
+	}
+
+	void IGamepadImpl::SetInstance(IGamepadImpl* impl)
+	{
+		m_instance.store(impl, std::memory_order_release);
+	}
+
+	void IGamepadImpl::SetResponse(Gamepad::Index index, const GamepadResponse& response)
+	{
+		std::lock_guard<std::mutex> lock(m_responseMutex);
+
+		m_requested[static_cast<size_t>(index)] = response;
+		m_pendingResponses.fetch_or(1u << static_cast<size_t>(index), std::memory_order_release);
+	}
+
+	void IGamepadImpl::ApplyPendingResponses()
+	{
+		std::lock_guard<std::mutex> lock(m_responseMutex);
+		uint32_t pending = m_pendingResponses.exchange(0, std::memory_order_acquire);
+
+		for (size_t i = 0; i < Gamepad::IndexCount; ++i)
+		{
+			if ((pending & (1u << i)) != 0)
+			{
+				m_responses[i] = m_requested[i];
+				InvalidateState(static_cast<Gamepad::Index>(i));
+			}
+		}
+
+		m_responseEpoch.fetch_add(1, std::memory_order_release);
+	}
+
+	void IGamepadImpl::NotifyHotplug()
+	{
+		for (size_t i = 0; i < Gamepad::IndexCount; ++i)
+		{
+			m_nextProbe[i].store(0, std::memory_order_relaxed);
+			m_backoff[i].store(ProbeBackoffMin, std::memory_order_relaxed);
+		}
+	}
+
+	void IGamepadImpl::SetConnected(Gamepad::Index index, bool connected)
+	{
+		size_t slot = static_cast<size_t>(index);
+		uint32_t bit = 1u << slot;
+
+		if (connected)
+		{
+			m_backoff[slot].store(ProbeBackoffMin, std::memory_order_relaxed);
+			m_nextProbe[slot].store(0, std::memory_order_relaxed);
+
+			if ((m_connected.load(std::memory_order_relaxed) & bit) == 0)
+				m_connected.fetch_or(bit, std::memory_order_release);
+		}
+		else if ((m_connected.load(std::memory_order_relaxed) & bit) != 0)
+		{
+			// A reconnected device may restart its packet numbering, so never trust the old stamp or conversion.
+			m_stamps[slot] = 0;
+			m_cached[slot] = false;
+			m_connected.fetch_and(~bit, std::memory_order_release);
+		}
+	}
+
+	void IGamepadImpl::EmitReport(Gamepad::Index index, const Gamepad::State& state)
+	{
+		if (GamepadEventQueue* events = m_events.load(std::memory_order_acquire))
+			events->Sample(index, state, state.timestamp);
+	}
+
+	bool IGamepadImpl::ShouldProbe(Gamepad::Index index)
+	{
+		size_t slot = static_cast<size_t>(index);
+
+		uint64_t nextProbe = m_nextProbe[slot].load(std::memory_order_relaxed);
+
+		if (((m_connected.load(std::memory_order_relaxed) >> slot) & 1) != 0 || nextProbe == 0)
+			return true;
+
+		return GamepadEventQueue::Now() >= nextProbe;
+	}
+
+	void IGamepadImpl::ProbeFailed(Gamepad::Index index)
+	{
+		size_t slot = static_cast<size_t>(index);
+
+		SetConnected(index, false);
+
+		uint64_t backoff = m_backoff[slot].load(std::memory_order_relaxed);
+
+		m_nextProbe[slot].store(GamepadEventQueue::Now() + backoff, std::memory_order_relaxed);
+		m_backoff[slot].store(backoff * 2 < ProbeBackoffMax ? backoff * 2 : ProbeBackoffMax, std::memory_order_relaxed);
+	}
+
+	uint64_t IGamepadImpl::StampPacket(Gamepad::Index index, uint32_t packet)
+	{
+		size_t slot = static_cast<size_t>(index);
+
+		if (m_stamps[slot] == 0 || m_packets[slot] != packet)
+		{
+			m_packets[slot] = packet;
+			m_stamps[slot] = GamepadEventQueue::Now();
+		}
+
+		return m_stamps[slot];
+	}
+
+	size_t IGamepadImpl::DeviceCount() const
+	{
+		size_t count = 0;
+
+		for (uint32_t mask = ConnectedMask(); mask != 0; mask &= mask - 1)
+			++count;
+
+		return count;
+	}
+
+	size_t IGamepadImpl::GetDevices(Gamepad::DeviceId* ids, Gamepad::State* states, size_t capacity)
+	{
+		size_t count = 0;
+
+		for (size_t i = 0; i < Gamepad::IndexCount && count < capacity; ++i)
+		{
+			if (!IsConnected(static_cast<Gamepad::Index>(i)))
+				continue;
+
+			ids[count] = static_cast<Gamepad::DeviceId>(i + 1);
+			states[count] = GetState(static_cast<Gamepad::Index>(i));
+			++count;
+		}
+
+		return count;
+	}
+
+	Gamepad::DeviceId IGamepadImpl::GetDeviceId(Gamepad::Index index) const
+	{
+		return IsConnected(index) ? static_cast<Gamepad::DeviceId>(static_cast<size_t>(index) + 1) : Gamepad::NoDevice;
+	}
+
+	uint32_t IGamepadImpl::GetStates(Gamepad::State* states, size_t count)
+	{
+		uint32_t connected = 0;
+
+		for (size_t i = 0; i < count && i < Gamepad::IndexCount; ++i)
+		{
+			states[i] = GetState(static_cast<Gamepad::Index>(i));
+			SetConnected(static_cast<Gamepad::Index>(i), states[i].connected);
+			connected |= (states[i].connected ? 1u : 0u) << i;
+		}
 
-		return m_instance;
+		return connected;
 	}
 
 }
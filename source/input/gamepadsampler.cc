@@ -0,0 +1,247 @@
+#include <algorithm>
+
+#include "decaf/input/gamepadsampler.hh"
+#include "decaf/input/gamepadevents.hh"
+#include "decaf/input/gamepadimpl.hh"
+#include "decaf/input/response.hh"
+#include "decaf/input/rumble.hh"
+
+namespace decaf
+{
+
+	////////////////////////////////////////////////////////////
+	GamepadSampler::GamepadSampler()
+		: m_impl{ nullptr }, m_events{ nullptr }, m_rumble{ nullptr }, m_period{ 0 }, m_running{ false }, m_wanted{ 0 }, m_published{ 0 } { }
+
+
+	////////////////////////////////////////////////////////////
+	GamepadSampler::~GamepadSampler()
+	{
+		Stop();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool GamepadSampler::Start(IGamepadImpl* impl, std::chrono::microseconds period, GamepadEventQueue* events, RumbleMixer* rumble)
+	{
+		if (impl == nullptr || m_running.load(std::memory_order_acquire))
+			return false;
+
+		m_impl = impl;
+		m_events = events;
+		m_rumble = rumble;
+		m_period = period;
+
+		// Seed the buffers so the first Read after Start is never stale.
+		Gamepad::State states[Gamepad::IndexCount];
+		m_impl->Update();
+		m_impl->GetStates(states, Gamepad::IndexCount);
+		Publish(states, m_impl->ResponseEpoch());
+		PublishExtras();
+
+		m_running.store(true, std::memory_order_release);
+		m_thread = std::thread(&GamepadSampler::Run, this);
+
+		return true;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadSampler::Stop()
+	{
+		m_running.store(false, std::memory_order_release);
+
+		if (m_thread.joinable())
+			m_thread.join();
+
+		// The extras a consumer asked for stay wanted, but what was published is stale once the backend may be read directly again.
+		m_published.store(0, std::memory_order_release);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool GamepadSampler::IsRunning() const
+	{
+		return m_running.load(std::memory_order_acquire);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool GamepadSampler::Read(Gamepad::Index index, Gamepad::State& state)
+	{
+		uint32_t responseEpoch;
+		return Read(index, state, responseEpoch);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool GamepadSampler::Read(Gamepad::Index index, Gamepad::State& state, uint32_t& responseEpoch)
+	{
+		TripleBuffer<Sample>& buffer = m_states[static_cast<size_t>(index)];
+		bool fresh = buffer.Acquire();
+
+		state = buffer.ReadBuffer().state;
+		responseEpoch = buffer.ReadBuffer().responseEpoch;
+		return fresh;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool GamepadSampler::ReadLatest(Gamepad::Index index, Gamepad::State& state)
+	{
+		TripleBuffer<Gamepad::State>& buffer = m_latest[static_cast<size_t>(index)];
+		bool fresh = buffer.Acquire();
+
+		state = buffer.ReadBuffer();
+		return fresh;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool GamepadSampler::ReadRaw(Gamepad::Index index, Gamepad::RawState& raw, Gamepad::State& state)
+	{
+		if (!Want(WantRaw))
+			return false;
+
+		TripleBuffer<RawSample>& buffer = m_raw[static_cast<size_t>(index)];
+		buffer.Acquire();
+
+		raw = buffer.ReadBuffer().raw;
+		state = buffer.ReadBuffer().state;
+		return true;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool GamepadSampler::ReadDevices(Gamepad::DeviceId* ids, Gamepad::State* states, size_t capacity, size_t& count)
+	{
+		if (!Want(WantDevices))
+			return false;
+
+		m_devices.Acquire();
+
+		const Devices& devices = m_devices.ReadBuffer();
+		count = std::min(capacity, devices.ids.size());
+
+		std::copy(devices.ids.begin(), devices.ids.begin() + count, ids);
+		std::copy(devices.states.begin(), devices.states.begin() + count, states);
+		return true;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool GamepadSampler::ReadDeviceCount(size_t& count)
+	{
+		if (!Want(WantDevices))
+			return false;
+
+		m_devices.Acquire();
+
+		count = m_devices.ReadBuffer().ids.size();
+		return true;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadSampler::Run()
+	{
+		using Clock = std::chrono::steady_clock;
+
+		Gamepad::State states[Gamepad::IndexCount];
+		Clock::time_point next = Clock::now();
+
+		while (m_running.load(std::memory_order_acquire))
+		{
+			m_impl->Update();
+
+			if (m_rumble != nullptr)
+				m_rumble->Submit(*m_impl);
+
+			m_impl->GetStates(states, Gamepad::IndexCount);
+			Publish(states, m_impl->ResponseEpoch());
+			PublishExtras();
+
+			next += m_period;
+
+			Clock::time_point now = Clock::now();
+			if (next < now)
+				next = now;
+			else
+				std::this_thread::sleep_until(next);
+		}
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadSampler::Publish(const Gamepad::State* states, uint32_t responseEpoch)
+	{
+		uint64_t timestamp = GamepadEventQueue::Now();
+
+		for (size_t i = 0; i < Gamepad::IndexCount; ++i)
+		{
+			m_states[i].WriteBuffer() = { states[i], responseEpoch };
+			m_states[i].Publish();
+			m_latest[i].WriteBuffer() = states[i];
+			m_latest[i].Publish();
+
+			if (m_events != nullptr)
+				m_events->Sample(static_cast<Gamepad::Index>(i), states[i], timestamp);
+		}
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadSampler::PublishExtras()
+	{
+		uint32_t wanted = m_wanted.load(std::memory_order_acquire);
+
+		if ((wanted & WantRaw) != 0)
+		{
+			for (size_t i = 0; i < Gamepad::IndexCount; ++i)
+			{
+				RawSample& sample = m_raw[i].WriteBuffer();
+				sample.state = m_impl->GetState(static_cast<Gamepad::Index>(i), GamepadResponse::Linear());
+				GamepadResponse::Pack(sample.state, sample.raw);
+				m_raw[i].Publish();
+			}
+		}
+
+		if ((wanted & WantDevices) != 0)
+		{
+			// The snapshot's vectors keep their capacity between samples, so a steady device count stops allocating.
+			Devices& devices = m_devices.WriteBuffer();
+			size_t count = m_impl->DeviceCount();
+
+			devices.ids.resize(count);
+			devices.states.resize(count);
+			count = m_impl->GetDevices(devices.ids.data(), devices.states.data(), count);
+			devices.ids.resize(count);
+			devices.states.resize(count);
+
+			m_devices.Publish();
+		}
+
+		m_published.fetch_or(wanted, std::memory_order_release);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool GamepadSampler::Want(uint32_t extras)
+	{
+		if ((m_published.load(std::memory_order_acquire) & extras) == extras)
+			return true;
+
+		m_wanted.fetch_or(extras, std::memory_order_release);
+
+		while ((m_published.load(std::memory_order_acquire) & extras) != extras)
+		{
+			if (!IsRunning())
+				return false;
+
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+		}
+
+		return true;
+	}
+
+}
@@ -0,0 +1,73 @@
+#include "decaf/input/latelatch.hh"
+
+namespace decaf
+{
+
+	////////////////////////////////////////////////////////////
+	LateLatch::LateLatch()
+		: m_slots{}, m_count{ 0 }, m_pads{ 0 }, m_serial{ 0 } { }
+
+
+	////////////////////////////////////////////////////////////
+	uint32_t LateLatch::Register(Gamepad::Index index, Gamepad::LatchFunction function, void* slot, void* context)
+	{
+		if (function == nullptr || m_count == MaxSlots)
+			return 0;
+
+		// Serials are never 0, so neither is a handle.
+		if (++m_serial == 0)
+			++m_serial;
+
+		m_slots[m_count] = { function, slot, context, index, m_serial };
+		++m_count;
+		m_pads |= 1u << static_cast<uint32_t>(index);
+
+		return m_serial;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void LateLatch::Unregister(uint32_t handle)
+	{
+		if (handle == 0)
+			return;
+
+		size_t found = m_count;
+
+		for (size_t i = 0; i < m_count; ++i)
+		{
+			if (m_slots[i].handle == handle)
+			{
+				found = i;
+				break;
+			}
+		}
+
+		if (found == m_count)
+			return;
+
+		// Shift rather than swap, so the remaining slots keep their registration order.
+		for (size_t i = found + 1; i < m_count; ++i)
+			m_slots[i - 1] = m_slots[i];
+
+		--m_count;
+		m_pads = 0;
+
+		for (size_t i = 0; i < m_count; ++i)
+			m_pads |= 1u << static_cast<uint32_t>(m_slots[i].index);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	size_t LateLatch::Fill(const Gamepad::State* states) const
+	{
+		for (size_t i = 0; i < m_count; ++i)
+		{
+			const Slot& slot = m_slots[i];
+			slot.function(slot.index, states[static_cast<size_t>(slot.index)], slot.slot, slot.context);
+		}
+
+		return m_count;
+	}
+
+}
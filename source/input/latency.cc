@@ -0,0 +1,89 @@
+#include "decaf/input/latency.hh"
+
+namespace decaf
+{
+
+	////////////////////////////////////////////////////////////
+	LatencyHistogram::LatencyHistogram()
+	{
+		Reset();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint64_t LatencyHistogram::Percentile(double fraction) const
+	{
+		uint64_t counts[BucketCount];
+		uint64_t total = 0;
+
+		// Snapshot first so concurrent records cannot push the running sum past the target.
+		for (size_t i = 0; i < BucketCount; ++i)
+		{
+			counts[i] = m_counts[i].load(std::memory_order_relaxed);
+			total += counts[i];
+		}
+
+		if (total == 0)
+			return 0;
+
+		uint64_t target = static_cast<uint64_t>(fraction * static_cast<double>(total) + 0.5);
+		target = target < 1 ? 1 : (target > total ? total : target);
+
+		uint64_t max = m_max.load(std::memory_order_relaxed);
+		uint64_t seen = 0;
+
+		for (size_t i = 0; i < BucketCount; ++i)
+		{
+			seen += counts[i];
+
+			if (seen >= target)
+			{
+				uint64_t bound = UpperBound(i);
+				return bound < max ? bound : max;
+			}
+		}
+
+		return max;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	LatencyStats LatencyHistogram::Stats() const
+	{
+		LatencyStats stats = {};
+
+		for (const std::atomic<uint64_t>& count : m_counts)
+			stats.count += count.load(std::memory_order_relaxed);
+
+		stats.p50 = Percentile(0.50);
+		stats.p99 = Percentile(0.99);
+		stats.max = m_max.load(std::memory_order_relaxed);
+
+		return stats;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void LatencyHistogram::Reset()
+	{
+		for (std::atomic<uint64_t>& count : m_counts)
+			count.store(0, std::memory_order_relaxed);
+
+		m_max.store(0, std::memory_order_relaxed);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint64_t LatencyHistogram::UpperBound(size_t bucket)
+	{
+		if (bucket < SubBuckets * 2)
+			return bucket;
+
+		size_t shift = bucket / SubBuckets - 1;
+		uint64_t sub = bucket % SubBuckets;
+
+		// Wraps to UINT64_MAX for the very last bucket, which is the right answer.
+		return ((SubBuckets + sub + 1) << shift) - 1;
+	}
+
+}
@@ -0,0 +1,740 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/input.h>
+
+#include "decaf/input/gamepadevents.hh"
+#include "decaf/input/linux/gamepadimpl_linux.hh"
+#include "decaf/input/response.hh"
+
+namespace decaf
+{
+
+	namespace
+	{
+
+		constexpr size_t EventBatch = 64;
+
+		/// <summary>The epoll token of the <c>/dev/input</c> watch; devices use their ID, which is never <c>NoDevice</c>.</summary>
+		constexpr uint32_t HotplugToken = Gamepad::NoDevice;
+
+		enum RangeSlot
+		{
+			RANGE_LX = 0,
+			RANGE_LY,
+			RANGE_RX,
+			RANGE_RY,
+			RANGE_LT,
+			RANGE_RT
+		};
+
+		constexpr int RangeCodes[6] = { ABS_X, ABS_Y, ABS_RX, ABS_RY, ABS_Z, ABS_RZ };
+
+		inline bool TestBit(const unsigned long* bits, int bit)
+		{
+			constexpr int BitsPerLong = sizeof(unsigned long) * 8;
+			return (bits[bit / BitsPerLong] >> (bit % BitsPerLong)) & 1;
+		}
+
+		inline uint16_t ButtonFromCode(uint16_t code)
+		{
+			switch (code)
+			{
+				case BTN_SOUTH: return static_cast<uint16_t>(Gamepad::Button::A);
+				case BTN_EAST: return static_cast<uint16_t>(Gamepad::Button::B);
+				case BTN_X: return static_cast<uint16_t>(Gamepad::Button::X);
+				case BTN_Y: return static_cast<uint16_t>(Gamepad::Button::Y);
+				case BTN_TL: return static_cast<uint16_t>(Gamepad::Button::LSHOULDER);
+				case BTN_TR: return static_cast<uint16_t>(Gamepad::Button::RSHOULDER);
+				case BTN_SELECT: return static_cast<uint16_t>(Gamepad::Button::BACK);
+				case BTN_START: return static_cast<uint16_t>(Gamepad::Button::START);
+				case BTN_THUMBL: return static_cast<uint16_t>(Gamepad::Button::LTHUMB);
+				case BTN_THUMBR: return static_cast<uint16_t>(Gamepad::Button::RTHUMB);
+				case BTN_DPAD_UP: return static_cast<uint16_t>(Gamepad::Button::DPAD_UP);
+				case BTN_DPAD_DOWN: return static_cast<uint16_t>(Gamepad::Button::DPAD_DOWN);
+				case BTN_DPAD_LEFT: return static_cast<uint16_t>(Gamepad::Button::DPAD_LEFT);
+				case BTN_DPAD_RIGHT: return static_cast<uint16_t>(Gamepad::Button::DPAD_RIGHT);
+				default: return 0;
+			}
+		}
+
+#if !defined (input_event_sec)
+#define input_event_sec time.tv_sec
+#define input_event_usec time.tv_usec
+#endif
+
+		inline uint64_t EventTime(const input_event& event)
+		{
+			return static_cast<uint64_t>(event.input_event_sec) * 1000000000ull + static_cast<uint64_t>(event.input_event_usec) * 1000ull;
+		}
+
+		inline int16_t NormalizeStick(int32_t value, int32_t minimum, int32_t maximum, bool flip)
+		{
+			if (maximum <= minimum)
+				return 0;
+
+			int64_t scaled = (static_cast<int64_t>(value - minimum) * 65535) / (maximum - minimum) - 32768;
+
+			// evdev reports Y growing downwards, XInput upwards.
+			if (flip)
+				scaled = -scaled;
+
+			return static_cast<int16_t>(std::max<int64_t>(-32768, std::min<int64_t>(32767, scaled)));
+		}
+
+		inline uint8_t NormalizeTrigger(int32_t value, int32_t minimum, int32_t maximum)
+		{
+			if (maximum <= minimum)
+				return 0;
+
+			int64_t scaled = (static_cast<int64_t>(value - minimum) * 255) / (maximum - minimum);
+			return static_cast<uint8_t>(std::max<int64_t>(0, std::min<int64_t>(255, scaled)));
+		}
+
+	}
+
+
+	////////////////////////////////////////////////////////////
+	GamepadImpl_Linux::GamepadImpl_Linux()
+		: GamepadImpl_Linux(true) { }
+
+
+	////////////////////////////////////////////////////////////
+	GamepadImpl_Linux::GamepadImpl_Linux(bool scanDevices)
+		: m_epoll{ epoll_create1(EPOLL_CLOEXEC) }, m_inotify{ -1 }, m_scanDevices{ scanDevices }, m_rescan{ false }, m_unboundResponse{ GamepadResponse::XInput() }
+	{
+		static_assert(sizeof(input_event) <= sizeof(Device::partial), "Device::partial must hold one input_event");
+
+		if (!scanDevices)
+			return;
+
+		// udev creates the node first and fixes its permissions afterwards, so watch attribute changes too.
+		m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+		if (m_inotify >= 0 && inotify_add_watch(m_inotify, "/dev/input", IN_CREATE | IN_ATTRIB | IN_MOVED_TO) >= 0 && m_epoll >= 0)
+		{
+			epoll_event watch;
+			memset(&watch, 0, sizeof(epoll_event));
+			watch.events = EPOLLIN;
+			watch.data.u32 = HotplugToken;
+
+			if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_inotify, &watch) < 0)
+			{
+				close(m_inotify);
+				m_inotify = -1;
+			}
+		}
+		else if (m_inotify >= 0)
+		{
+			close(m_inotify);
+			m_inotify = -1;
+		}
+
+		Scan();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	GamepadImpl_Linux::~GamepadImpl_Linux()
+	{
+		while (m_devices.Count() > 0)
+			DetachDevice(m_devices.Id(m_devices.Count() - 1));
+
+		if (m_inotify >= 0)
+			close(m_inotify);
+
+		if (m_epoll >= 0)
+			close(m_epoll);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	Gamepad::State GamepadImpl_Linux::GetState(Gamepad::Index index)
+	{
+		size_t i = m_devices.Find(m_devices.Slot(index));
+		Gamepad::State result = {};
+		ApplyResponses();
+
+		if (i != m_devices.NotFound)
+			DecodeSlot(index, i, result);
+
+		return result;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	Gamepad::State GamepadImpl_Linux::GetState(Gamepad::Index index, const GamepadResponse& response)
+	{
+		size_t i = m_devices.Find(m_devices.Slot(index));
+		Gamepad::State result = {};
+
+		if (i != m_devices.NotFound)
+			Decode(i, response, result);
+
+		return result;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint32_t GamepadImpl_Linux::GetStates(Gamepad::State* states, size_t count)
+	{
+		uint32_t connected = 0;
+		ApplyResponses();
+
+		for (size_t i = 0; i < count && i < MaxPads; ++i)
+		{
+			size_t device = m_devices.Find(m_devices.Slot(static_cast<Gamepad::Index>(i)));
+
+			states[i] = Gamepad::State();
+
+			if (device != m_devices.NotFound)
+			{
+				DecodeSlot(static_cast<Gamepad::Index>(i), device, states[i]);
+				connected |= 1u << i;
+			}
+		}
+
+		return connected;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	size_t GamepadImpl_Linux::DeviceCount() const
+	{
+		return m_devices.Count();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	size_t GamepadImpl_Linux::GetDevices(Gamepad::DeviceId* ids, Gamepad::State* states, size_t capacity)
+	{
+		size_t count = std::min(capacity, m_devices.Count());
+		ApplyResponses();
+
+		std::copy(m_devices.Ids(), m_devices.Ids() + count, ids);
+
+		// Readings are stored raw, so each device is converted here: all of them through the unbound curves, then the few in slots again through their slot's.
+		for (size_t i = 0; i < count; ++i)
+			Decode(i, m_unboundResponse, states[i]);
+
+		for (size_t slot = 0; slot < MaxPads; ++slot)
+		{
+			size_t i = m_devices.Find(m_devices.Slot(static_cast<Gamepad::Index>(slot)));
+
+			if (i < count)
+				Decode(i, m_responses[slot], states[i]);
+		}
+
+		return count;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	Gamepad::DeviceId GamepadImpl_Linux::GetDeviceId(Gamepad::Index index) const
+	{
+		return m_devices.Slot(index);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Linux::SetRumble(Gamepad::Index index, float left, float right)
+	{
+		size_t i = m_devices.Find(m_devices.Slot(index));
+
+		if (i == m_devices.NotFound)
+			return;
+
+		Device& device = m_devices.Data(i);
+
+		uint16_t strong = (uint16_t)(left * 65535);
+		uint16_t weak = (uint16_t)(right * 65535);
+		bool play = (strong != 0 || weak != 0);
+
+		// The effect is uploaded once and then updated in place; new magnitudes take over without restarting playback.
+		if (play && (device.rumbleId < 0 || strong != device.rumble[0] || weak != device.rumble[1]))
+		{
+			ff_effect effect;
+			memset(&effect, 0, sizeof(ff_effect));
+			effect.type = FF_RUMBLE;
+			effect.id = device.rumbleId;
+			effect.u.rumble.strong_magnitude = strong;
+			effect.u.rumble.weak_magnitude = weak;
+
+			if (ioctl(device.fd, EVIOCSFF, &effect) < 0)
+				return;
+
+			device.rumbleId = effect.id;
+			device.rumble[0] = strong;
+			device.rumble[1] = weak;
+		}
+
+		if (play == device.rumblePlaying || device.rumbleId < 0)
+			return;
+
+		input_event trigger;
+		memset(&trigger, 0, sizeof(input_event));
+		trigger.type = EV_FF;
+		trigger.code = static_cast<uint16_t>(device.rumbleId);
+		trigger.value = play ? 1 : 0;
+
+		if (write(device.fd, &trigger, sizeof(input_event)) < 0)
+			return;
+
+		device.rumblePlaying = play;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Linux::Update()
+	{
+		// Only devices with pending reports come back from epoll, so an update costs O(active devices) however many are attached.
+		epoll_event ready[EventBatch];
+		int count;
+
+		do
+		{
+			count = epoll_wait(m_epoll, ready, static_cast<int>(EventBatch), 0);
+
+			for (int i = 0; i < count; ++i)
+			{
+				if (ready[i].data.u32 == HotplugToken)
+					HandleHotplug();
+				else
+					ReadDevice(ready[i].data.u32);
+			}
+		}
+		while (count == static_cast<int>(EventBatch));
+
+		if (!m_scanDevices)
+			return;
+
+		// Without inotify, empty slots are found by rescanning on an exponential backoff.
+		size_t empty = 0;
+		while (empty < MaxPads && m_devices.Slot(static_cast<Gamepad::Index>(empty)) != Gamepad::NoDevice)
+			++empty;
+
+		if (m_rescan.exchange(false, std::memory_order_acquire) || (m_inotify < 0 && empty < MaxPads && ShouldProbe(static_cast<Gamepad::Index>(empty))))
+		{
+			Scan();
+
+			if (empty < MaxPads && m_devices.Slot(static_cast<Gamepad::Index>(empty)) == Gamepad::NoDevice)
+				ProbeFailed(static_cast<Gamepad::Index>(empty));
+		}
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Linux::NotifyHotplug()
+	{
+		IGamepadImpl::NotifyHotplug();
+		m_rescan.store(m_scanDevices, std::memory_order_release);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Linux::HandleHotplug()
+	{
+		alignas(inotify_event) char buffer[4096];
+		bool added = false;
+
+		for (;;)
+		{
+			ssize_t bytes = read(m_inotify, buffer, sizeof(buffer));
+
+			if (bytes < 0 && errno == EINTR)
+				continue;
+
+			if (bytes <= 0)
+				break;
+
+			for (ssize_t offset = 0; offset < bytes; )
+			{
+				const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+				added |= (event->len > 0 && strncmp(event->name, "event", 5) == 0);
+				offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+			}
+		}
+
+		if (added)
+			Scan();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Linux::Scan()
+	{
+		DIR* dir = opendir("/dev/input");
+
+		if (dir == nullptr)
+			return;
+
+		while (dirent* entry = readdir(dir))
+		{
+			if (strncmp(entry->d_name, "event", 5) != 0)
+				continue;
+
+			char path[sizeof(dirent::d_name) + 16];
+			snprintf(path, sizeof(path), "/dev/input/%s", entry->d_name);
+
+			int fd = open(path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+			if (fd < 0)
+				fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+			if (fd < 0)
+				continue;
+
+			unsigned long keys[(KEY_MAX + 1) / (sizeof(unsigned long) * 8) + 1] = { 0 };
+			bool isGamepad = ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keys)), keys) >= 0 && TestBit(keys, BTN_GAMEPAD);
+
+			// Open refuses devices that are already attached, recognising them by their device number.
+			if (!isGamepad || Open(fd, MaxPads) == Gamepad::NoDevice)
+				close(fd);
+		}
+
+		closedir(dir);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool GamepadImpl_Linux::Attach(Gamepad::Index index, int fd)
+	{
+		size_t slot = static_cast<size_t>(index);
+
+		if (m_epoll < 0 || fd < 0 || slot >= MaxPads)
+			return false;
+
+		Detach(index);
+
+		// Detaching may have promoted an unbound device into the slot; this stream takes the slot and that device goes back to being unbound.
+		m_devices.Unbind(index);
+		Gamepad::DeviceId id = Open(fd, slot);
+
+		SyncSlots();
+		return id != Gamepad::NoDevice;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	Gamepad::DeviceId GamepadImpl_Linux::AttachDevice(int fd)
+	{
+		if (m_epoll < 0 || fd < 0)
+			return Gamepad::NoDevice;
+
+		return Open(fd, MaxPads);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	Gamepad::DeviceId GamepadImpl_Linux::Open(int fd, size_t slot)
+	{
+		int flags = fcntl(fd, F_GETFL);
+		if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+			return Gamepad::NoDevice;
+
+		Device device = Device();
+		device.fd = fd;
+		device.rumbleId = -1;
+
+		// Character devices keep their device number across reconnections; pipes and sockets get a fresh ID every time.
+		struct stat info;
+		if (fstat(fd, &info) == 0 && S_ISCHR(info.st_mode))
+			device.hardwareKey = static_cast<uint64_t>(info.st_rdev);
+
+		Gamepad::DeviceId id = m_devices.Add(device.hardwareKey, device, slot);
+
+		if (id == Gamepad::NoDevice)
+			return Gamepad::NoDevice;
+
+		epoll_event watch;
+		memset(&watch, 0, sizeof(epoll_event));
+		watch.events = EPOLLIN;
+		watch.data.u32 = id;
+
+		if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &watch) < 0)
+		{
+			m_devices.Remove(id);
+			return Gamepad::NoDevice;
+		}
+
+		size_t i = m_devices.Find(id);
+		Device& added = m_devices.Data(i);
+
+		// Ask evdev to stamp events on the monotonic clock so they compare with GamepadEventQueue::Now.
+		// Injected streams carry no usable stamps; their reports are stamped when they are read.
+		int clock = CLOCK_MONOTONIC;
+		added.monotonic = ioctl(fd, EVIOCSCLOCKID, &clock) == 0;
+
+		// Injected streams have no absinfo, so fall back to XInput's native ranges.
+		for (size_t r = 0; r < 6; ++r)
+		{
+			bool trigger = (r == RANGE_LT || r == RANGE_RT);
+			added.ranges[r].minimum = trigger ? 0 : -32768;
+			added.ranges[r].maximum = trigger ? 255 : 32767;
+		}
+
+		Resync(added);
+		m_devices.Raw(i) = added.pending;
+		m_devices.Timestamp(i) = GamepadEventQueue::Now();
+		SyncSlots();
+
+		return id;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Linux::Detach(Gamepad::Index index)
+	{
+		if (static_cast<size_t>(index) < MaxPads)
+			DetachDevice(m_devices.Slot(index));
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Linux::DetachDevice(Gamepad::DeviceId id)
+	{
+		size_t i = m_devices.Find(id);
+
+		if (i == m_devices.NotFound)
+			return;
+
+		Device& device = m_devices.Data(i);
+
+		if (device.rumbleId >= 0)
+			ioctl(device.fd, EVIOCRMFF, device.rumbleId);
+
+		epoll_ctl(m_epoll, EPOLL_CTL_DEL, device.fd, nullptr);
+		close(device.fd);
+
+		m_devices.Remove(id);
+		SyncSlots();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Linux::Decode(size_t i, const GamepadResponse& response, Gamepad::State& state) const
+	{
+		response.Decode(m_devices.Raw(i), state);
+		state.connected = true;
+		state.packet = m_devices.Packet(i);
+		state.timestamp = m_devices.Timestamp(i);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Linux::DecodeSlot(Gamepad::Index index, size_t i, Gamepad::State& state)
+	{
+		// A device's packet counter only advances on SYN_REPORT, so an idle pad reuses its last conversion.
+		if (const Gamepad::State* cached = CachedState(index, m_devices.Packet(i)))
+		{
+			state = *cached;
+			return;
+		}
+
+		Decode(i, m_responses[static_cast<size_t>(index)], state);
+		CacheState(index, state);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Linux::SyncSlots()
+	{
+		// Slots may now view other devices, whose packet numbers mean nothing against the cached ones.
+		for (size_t i = 0; i < MaxPads; ++i)
+		{
+			InvalidateState(static_cast<Gamepad::Index>(i));
+			SetConnected(static_cast<Gamepad::Index>(i), m_devices.Slot(static_cast<Gamepad::Index>(i)) != Gamepad::NoDevice);
+		}
+	}
+
+
+	////////////////////////////////////////////////////////////
+	const GamepadResponse& GamepadImpl_Linux::ResponseOf(Gamepad::DeviceId id) const
+	{
+		size_t slot = m_devices.SlotOf(id);
+		return slot < MaxPads ? m_responses[slot] : m_unboundResponse;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Linux::ReadDevice(Gamepad::DeviceId id)
+	{
+		size_t i = m_devices.Find(id);
+
+		if (i == m_devices.NotFound)
+			return;
+
+		Device& device = m_devices.Data(i);
+		input_event events[EventBatch];
+		size_t slot = m_devices.SlotOf(id);
+
+		for (;;)
+		{
+			unsigned char* buffer = reinterpret_cast<unsigned char*>(events);
+			memcpy(buffer, device.partial, device.partialBytes);
+
+			ssize_t bytes = read(device.fd, buffer + device.partialBytes, sizeof(events) - device.partialBytes);
+
+			if (bytes < 0 && errno == EINTR)
+				continue;
+
+			if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+				return;
+
+			if (bytes <= 0)
+			{
+				// Removal moves another device into this record, so nothing may touch it afterwards.
+				DetachDevice(id);
+				return;
+			}
+
+			// Pipes may split records, evdev never does.
+			size_t total = device.partialBytes + static_cast<size_t>(bytes);
+			size_t count = total / sizeof(input_event);
+			device.partialBytes = total % sizeof(input_event);
+			memcpy(device.partial, buffer + count * sizeof(input_event), device.partialBytes);
+
+			uint64_t readTime = device.monotonic ? 0 : GamepadEventQueue::Now();
+
+			for (size_t e = 0; e < count; ++e)
+			{
+				if (!HandleEvent(device, events[e].type, events[e].code, events[e].value))
+					continue;
+
+				m_devices.Raw(i) = device.pending;
+				++m_devices.Packet(i);
+				m_devices.Timestamp(i) = device.monotonic ? EventTime(events[e]) : readTime;
+
+				// Reads only see the newest report, so hand each one to the event queue now, or a tap within one read would leave no edge.
+				if (slot < MaxPads && EmitsReports())
+				{
+					Gamepad::State report;
+					Decode(i, m_responses[slot], report);
+					EmitReport(static_cast<Gamepad::Index>(slot), report);
+				}
+			}
+		}
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool GamepadImpl_Linux::HandleEvent(Device& device, uint16_t type, uint16_t code, int32_t value)
+	{
+		if (type == EV_SYN)
+		{
+			if (code == SYN_DROPPED)
+			{
+				device.syncDropped = true;
+			}
+			else if (code == SYN_REPORT)
+			{
+				if (device.syncDropped)
+				{
+					device.syncDropped = false;
+					Resync(device);
+				}
+
+				return true;
+			}
+
+			return false;
+		}
+
+		// Everything between SYN_DROPPED and the next SYN_REPORT is incomplete.
+		if (device.syncDropped)
+			return false;
+
+		Gamepad::RawState& raw = device.pending;
+
+		if (type == EV_KEY)
+		{
+			uint16_t mask = ButtonFromCode(code);
+
+			if (value != 0)
+				raw.buttons |= mask;
+			else
+				raw.buttons &= ~mask;
+		}
+		else if (type == EV_ABS)
+		{
+			const AxisRange* ranges = device.ranges;
+
+			switch (code)
+			{
+				case ABS_X: raw.thumbLX = NormalizeStick(value, ranges[RANGE_LX].minimum, ranges[RANGE_LX].maximum, false); break;
+				case ABS_Y: raw.thumbLY = NormalizeStick(value, ranges[RANGE_LY].minimum, ranges[RANGE_LY].maximum, true); break;
+				case ABS_RX: raw.thumbRX = NormalizeStick(value, ranges[RANGE_RX].minimum, ranges[RANGE_RX].maximum, false); break;
+				case ABS_RY: raw.thumbRY = NormalizeStick(value, ranges[RANGE_RY].minimum, ranges[RANGE_RY].maximum, true); break;
+				case ABS_Z: raw.leftTrigger = NormalizeTrigger(value, ranges[RANGE_LT].minimum, ranges[RANGE_LT].maximum); break;
+				case ABS_RZ: raw.rightTrigger = NormalizeTrigger(value, ranges[RANGE_RT].minimum, ranges[RANGE_RT].maximum); break;
+
+				case ABS_HAT0X:
+				{
+					raw.buttons &= ~static_cast<uint16_t>(Gamepad::Button::DPAD_LEFT) & ~static_cast<uint16_t>(Gamepad::Button::DPAD_RIGHT);
+					if (value < 0)
+						raw.buttons |= static_cast<uint16_t>(Gamepad::Button::DPAD_LEFT);
+					else if (value > 0)
+						raw.buttons |= static_cast<uint16_t>(Gamepad::Button::DPAD_RIGHT);
+					break;
+				}
+
+				case ABS_HAT0Y:
+				{
+					raw.buttons &= ~static_cast<uint16_t>(Gamepad::Button::DPAD_UP) & ~static_cast<uint16_t>(Gamepad::Button::DPAD_DOWN);
+					if (value < 0)
+						raw.buttons |= static_cast<uint16_t>(Gamepad::Button::DPAD_UP);
+					else if (value > 0)
+						raw.buttons |= static_cast<uint16_t>(Gamepad::Button::DPAD_DOWN);
+					break;
+				}
+
+				default:
+					break;
+			}
+		}
+
+		return false;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Linux::Resync(Device& device)
+	{
+		for (size_t i = 0; i < 6; ++i)
+		{
+			input_absinfo info;
+			if (ioctl(device.fd, EVIOCGABS(RangeCodes[i]), &info) < 0)
+				continue;
+
+			device.ranges[i].minimum = info.minimum;
+			device.ranges[i].maximum = info.maximum;
+			HandleEvent(device, EV_ABS, static_cast<uint16_t>(RangeCodes[i]), info.value);
+		}
+
+		for (int hat : { ABS_HAT0X, ABS_HAT0Y })
+		{
+			input_absinfo info;
+			if (ioctl(device.fd, EVIOCGABS(hat), &info) >= 0)
+				HandleEvent(device, EV_ABS, static_cast<uint16_t>(hat), info.value);
+		}
+
+		unsigned long keys[(KEY_MAX + 1) / (sizeof(unsigned long) * 8) + 1] = { 0 };
+		if (ioctl(device.fd, EVIOCGKEY(sizeof(keys)), keys) < 0)
+			return;
+
+		for (int code = BTN_MISC; code < BTN_TRIGGER_HAPPY; ++code)
+		{
+			if (ButtonFromCode(static_cast<uint16_t>(code)) != 0)
+				HandleEvent(device, EV_KEY, static_cast<uint16_t>(code), TestBit(keys, code) ? 1 : 0);
+		}
+	}
+
+}
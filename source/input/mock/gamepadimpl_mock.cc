@@ -0,0 +1,139 @@
+#include "decaf/input/gamepadevents.hh"
+#include "decaf/input/mock/gamepadimpl_mock.hh"
+#include "decaf/input/response.hh"
+
+namespace decaf
+{
+
+	////////////////////////////////////////////////////////////
+	GamepadImpl_Mock::GamepadImpl_Mock()
+		: m_raw{}, m_packet{}, m_timestamp{}, m_rumble{}, m_generator{ nullptr }, m_context{ nullptr }, m_updates{ 0 } { }
+
+
+	////////////////////////////////////////////////////////////
+	Gamepad::State GamepadImpl_Mock::GetState(Gamepad::Index index)
+	{
+		Gamepad::State result = {};
+		ApplyResponses();
+		Convert(index, result);
+		return result;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	Gamepad::State GamepadImpl_Mock::GetState(Gamepad::Index index, const GamepadResponse& response)
+	{
+		size_t slot = static_cast<size_t>(index);
+		Gamepad::State result = {};
+
+		if (m_raw[slot].connected)
+		{
+			response.Decode(m_raw[slot], result);
+			result.connected = true;
+			result.packet = m_packet[slot];
+			result.timestamp = m_timestamp[slot];
+		}
+
+		return result;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint32_t GamepadImpl_Mock::GetStates(Gamepad::State* states, size_t count)
+	{
+		uint32_t connected = 0;
+		ApplyResponses();
+
+		for (size_t i = 0; i < count && i < Gamepad::IndexCount; ++i)
+		{
+			states[i] = {};
+
+			if (Convert(static_cast<Gamepad::Index>(i), states[i]))
+				connected |= 1u << i;
+		}
+
+		return connected;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool GamepadImpl_Mock::Convert(Gamepad::Index index, Gamepad::State& gps)
+	{
+		size_t slot = static_cast<size_t>(index);
+
+		if (!m_raw[slot].connected)
+			return false;
+
+		if (const Gamepad::State* cached = CachedState(index, m_packet[slot]))
+		{
+			gps = *cached;
+			return true;
+		}
+
+		m_responses[slot].Decode(m_raw[slot], gps);
+		gps.connected = true;
+		gps.packet = m_packet[slot];
+		gps.timestamp = m_timestamp[slot];
+		CacheState(index, gps);
+
+		return true;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Mock::SetRumble(Gamepad::Index index, float left, float right)
+	{
+		m_rumble[static_cast<size_t>(index)][0] = left;
+		m_rumble[static_cast<size_t>(index)][1] = right;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Mock::Update()
+	{
+		++m_updates;
+
+		if (m_generator == nullptr)
+			return;
+
+		for (size_t i = 0; i < Gamepad::IndexCount; ++i)
+			SetRawState(static_cast<Gamepad::Index>(i), m_generator(static_cast<Gamepad::Index>(i), m_updates, m_context));
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Mock::SetRawState(Gamepad::Index index, const RawState& raw)
+	{
+		size_t slot = static_cast<size_t>(index);
+
+		m_raw[slot] = raw;
+		m_packet[slot]++;
+		m_timestamp[slot] = GamepadEventQueue::Now();
+
+		SetConnected(index, raw.connected);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	const GamepadImpl_Mock::RawState& GamepadImpl_Mock::GetRawState(Gamepad::Index index) const
+	{
+		return m_raw[static_cast<size_t>(index)];
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Mock::SetGenerator(Generator generator, void* context)
+	{
+		m_generator = generator;
+		m_context = context;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Mock::GetRumble(Gamepad::Index index, float& left, float& right) const
+	{
+		left = m_rumble[static_cast<size_t>(index)][0];
+		right = m_rumble[static_cast<size_t>(index)][1];
+	}
+
+}
@@ -0,0 +1,348 @@
+#include "decaf/input/gamepadevents.hh"
+#include "decaf/input/remote/remotestream.hh"
+
+namespace decaf
+{
+
+	namespace
+	{
+
+		enum class Kind : uint32_t
+		{
+			FRAMES = 0,
+			ACK = 1
+		};
+
+		/// <summary>Every datagram starts with a 4-bit version and a 1-bit kind.</summary>
+		inline void WriteHeader(Kind kind, BitWriter& writer)
+		{
+			writer.Write(Remote::Version, 4);
+			writer.Write(static_cast<uint32_t>(kind), 1);
+		}
+
+		inline bool ReadHeader(Kind kind, BitReader& reader)
+		{
+			uint32_t version = reader.Read(4);
+			return version == Remote::Version && reader.Read(1) == static_cast<uint32_t>(kind);
+		}
+
+	}
+
+
+	////////////////////////////////////////////////////////////
+	RemoteSender::RemoteSender()
+		: m_history{}, m_frame{ 0 }, m_acked{ 0 }, m_pads{ 0 }, m_lastSize{ 0 }, m_bytesSent{ 0 } { }
+
+
+	////////////////////////////////////////////////////////////
+	bool RemoteSender::Open(const char* host, uint16_t port, uint16_t localPort)
+	{
+		if (!m_socket.Open(nullptr, localPort))
+			return false;
+
+		if (!m_socket.SetPeer(host, port))
+		{
+			m_socket.Close();
+			return false;
+		}
+
+		return true;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void RemoteSender::Close()
+	{
+		m_socket.Close();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint32_t RemoteSender::Send(const Gamepad::State* states, size_t count)
+	{
+		uint32_t frame = Push(states, count);
+		ReceiveAcks();
+
+		uint8_t buffer[Remote::MaxDatagram];
+		size_t size = Encode(buffer, sizeof(buffer));
+
+		if (frame == 0 || size == 0 || !m_socket.Send(buffer, size))
+			return 0;
+
+		m_lastSize = size;
+		m_bytesSent += size;
+		return frame;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint32_t RemoteSender::Push(const Gamepad::State* states, size_t count)
+	{
+		if (count == 0)
+			return 0;
+
+		if (count > Gamepad::IndexCount)
+			count = Gamepad::IndexCount;
+
+		// The receiver cannot decode against a baseline with a different number of pads.
+		if (count != m_pads)
+		{
+			m_pads = static_cast<uint32_t>(count);
+			m_acked = 0;
+		}
+
+		++m_frame;
+		StateCodec::Quantized* frame = m_history[m_frame % Remote::History];
+
+		for (size_t i = 0; i < count; ++i)
+			StateCodec::Quantize(states[i], frame[i]);
+
+		return m_frame;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	size_t RemoteSender::Encode(uint8_t* buffer, size_t capacity) const
+	{
+		if (m_frame == 0)
+			return 0;
+
+		uint32_t baseline = (m_acked != 0 && m_frame - m_acked < Remote::History) ? m_acked : 0;
+		uint32_t first = baseline + 1;
+
+		if (first > m_frame)
+			first = m_frame;
+
+		if (m_frame - first >= Remote::MaxFrames)
+			first = m_frame - static_cast<uint32_t>(Remote::MaxFrames) + 1;
+
+		// When the frames do not fit, drop the oldest; the newest state matters most.
+		for (; first <= m_frame; ++first)
+		{
+			size_t size = EncodeFrom(first, baseline, buffer, capacity);
+
+			if (size != 0)
+				return size;
+		}
+
+		return 0;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void RemoteSender::Acknowledge(uint32_t frame)
+	{
+		if (frame > m_acked && frame <= m_frame)
+			m_acked = frame;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void RemoteSender::ReceiveAcks()
+	{
+		uint8_t buffer[16];
+		int size;
+
+		while ((size = m_socket.Receive(buffer, sizeof(buffer))) >= 0)
+		{
+			BitReader reader(buffer, static_cast<size_t>(size));
+
+			if (!ReadHeader(Kind::ACK, reader))
+				continue;
+
+			uint32_t frame = reader.Read(32);
+
+			if (!reader.Overflowed())
+				Acknowledge(frame);
+		}
+	}
+
+
+	////////////////////////////////////////////////////////////
+	size_t RemoteSender::EncodeFrom(uint32_t first, uint32_t baseline, uint8_t* buffer, size_t capacity) const
+	{
+		static const StateCodec::Quantized Zero[Gamepad::IndexCount] = {};
+
+		BitWriter writer(buffer, capacity);
+		uint32_t frames = m_frame - first + 1;
+
+		WriteHeader(Kind::FRAMES, writer);
+		// The baseline is always within the history of the first frame, so it is sent as a distance back from it; 0 means none.
+		writer.Write(first, 32);
+		writer.Write(baseline != 0 ? first - baseline : 0, 6);
+		writer.Write(m_pads - 1, 2);
+		writer.Write(frames - 1, 5);
+
+		const StateCodec::Quantized* reference = (baseline != 0 ? m_history[baseline % Remote::History] : Zero);
+
+		for (uint32_t frame = first; frame <= m_frame && !writer.Overflowed(); ++frame)
+		{
+			const StateCodec::Quantized* states = m_history[frame % Remote::History];
+
+			for (size_t i = 0; i < m_pads; ++i)
+				StateCodec::Encode(reference[i], states[i], writer);
+
+			reference = states;
+		}
+
+		return writer.Finish();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	RemoteReceiver::RemoteReceiver()
+		: m_history{}, m_numbers{}, m_states{}, m_latest{ 0 }, m_pads{ 0 }, m_rejected{ 0 } { }
+
+
+	////////////////////////////////////////////////////////////
+	bool RemoteReceiver::Open(const char* address, uint16_t port)
+	{
+		return m_socket.Open(address, port);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void RemoteReceiver::Close()
+	{
+		m_socket.Close();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool RemoteReceiver::Update()
+	{
+		uint8_t buffer[Remote::MaxDatagram];
+		uint32_t latest = m_latest;
+		bool accepted = false;
+		int size;
+
+		while ((size = m_socket.Receive(buffer, sizeof(buffer))) >= 0)
+			accepted |= Decode(buffer, static_cast<size_t>(size));
+
+		// Acknowledge even repeats, so a lost acknowledgement never stalls the sender's baseline.
+		if (accepted)
+		{
+			uint8_t ack[8];
+			BitWriter writer(ack, sizeof(ack));
+
+			WriteHeader(Kind::ACK, writer);
+			writer.Write(m_latest, 32);
+			m_socket.Send(ack, writer.Finish());
+		}
+
+		return m_latest != latest;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool RemoteReceiver::Decode(const uint8_t* data, size_t size)
+	{
+		static const StateCodec::Quantized Zero[Gamepad::IndexCount] = {};
+
+		BitReader reader(data, size);
+
+		if (!ReadHeader(Kind::FRAMES, reader))
+		{
+			++m_rejected;
+			return false;
+		}
+
+		uint32_t first = reader.Read(32);
+		uint32_t distance = reader.Read(6);
+		uint32_t baseline = first - distance;
+		uint32_t pads = reader.Read(2) + 1;
+		uint32_t frames = reader.Read(5) + 1;
+
+		bool known = (distance == 0 || (distance < first && m_numbers[baseline % Remote::History] == baseline && pads == m_pads));
+
+		if (reader.Overflowed() || first == 0 || !known)
+		{
+			++m_rejected;
+			return false;
+		}
+
+		// Decode everything before keeping anything, so a truncated datagram leaves the history untouched.
+		StateCodec::Quantized decoded[Remote::MaxFrames][Gamepad::IndexCount];
+		const StateCodec::Quantized* reference = (distance != 0 ? m_history[baseline % Remote::History] : Zero);
+
+		for (uint32_t k = 0; k < frames; ++k)
+		{
+			for (size_t i = 0; i < pads; ++i)
+				StateCodec::Decode(reference[i], decoded[k][i], reader);
+
+			reference = decoded[k];
+		}
+
+		if (reader.Overflowed())
+		{
+			++m_rejected;
+			return false;
+		}
+
+		m_pads = pads;
+		uint32_t newest = frames;
+
+		for (uint32_t k = 0; k < frames; ++k)
+		{
+			uint32_t frame = first + k;
+
+			// A late datagram must not overwrite the slots of newer frames.
+			if (m_latest >= Remote::History && frame <= m_latest - Remote::History)
+				continue;
+
+			size_t slot = frame % Remote::History;
+
+			for (size_t i = 0; i < pads; ++i)
+				m_history[slot][i] = decoded[k][i];
+
+			m_numbers[slot] = frame;
+
+			if (frame > m_latest)
+			{
+				m_latest = frame;
+				newest = k;
+			}
+		}
+
+		if (newest != frames)
+		{
+			uint64_t now = GamepadEventQueue::Now();
+
+			for (size_t i = 0; i < Gamepad::IndexCount; ++i)
+			{
+				m_states[i] = Gamepad::State();
+
+				if (i < pads)
+					StateCodec::Dequantize(decoded[newest][i], m_states[i]);
+
+				m_states[i].packet = m_latest;
+				m_states[i].timestamp = now;
+			}
+		}
+
+		return true;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool RemoteReceiver::GetFrame(uint32_t frame, Gamepad::State* states, size_t count) const
+	{
+		size_t slot = frame % Remote::History;
+
+		if (frame == 0 || m_numbers[slot] != frame)
+			return false;
+
+		for (size_t i = 0; i < count && i < Gamepad::IndexCount; ++i)
+		{
+			states[i] = Gamepad::State();
+
+			if (i < m_pads)
+				StateCodec::Dequantize(m_history[slot][i], states[i]);
+
+			states[i].packet = frame;
+		}
+
+		return true;
+	}
+
+}
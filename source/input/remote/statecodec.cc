@@ -0,0 +1,178 @@
+#include <cmath>
+
+#include "decaf/input/remote/statecodec.hh"
+
+namespace decaf
+{
+
+	namespace
+	{
+
+		/// <summary>Bits of the field mask written before a changed pad. Sticks and triggers take one bit per axis, from the first.</summary>
+		constexpr uint32_t FieldButtons = 0x01;
+		constexpr uint32_t FieldSticks = 0x02;
+		constexpr uint32_t FieldTriggers = 0x20;
+		constexpr uint32_t FieldConnected = 0x80;
+
+		/// <summary>Bits 10 and 11 of <c>Gamepad::Button</c> are unused; packing squeezes them out.</summary>
+		inline uint32_t PackButtons(uint16_t buttons)
+		{
+			return (buttons & 0x03ffu) | ((buttons >> 2) & 0x3c00u);
+		}
+
+		inline uint16_t UnpackButtons(uint32_t packed)
+		{
+			return static_cast<uint16_t>((packed & 0x03ffu) | ((packed & 0x3c00u) << 2));
+		}
+
+		inline uint32_t ZigZag(int32_t value)
+		{
+			return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+		}
+
+		inline int32_t UnZigZag(uint32_t value)
+		{
+			return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+		}
+
+		/// <summary>Widths of a stick difference, chosen by a 2-bit prefix: small corrections, drifts, sweeps and full flicks.</summary>
+		constexpr unsigned StickWidths[4] = { 5, 9, 13, 17 };
+
+		/// <summary>Widths of a trigger difference, chosen by a 1-bit prefix.</summary>
+		constexpr unsigned TriggerWidths[2] = { 4, 9 };
+
+		inline void WriteStick(int32_t delta, BitWriter& writer)
+		{
+			uint32_t value = ZigZag(delta);
+			uint32_t width = (value >= (1u << StickWidths[0])) + (value >= (1u << StickWidths[1])) + (value >= (1u << StickWidths[2]));
+
+			writer.Write(width, 2);
+			writer.Write(value, StickWidths[width]);
+		}
+
+		inline void WriteTrigger(int32_t delta, BitWriter& writer)
+		{
+			uint32_t value = ZigZag(delta);
+			uint32_t width = (value >= (1u << TriggerWidths[0]));
+
+			writer.Write(width, 1);
+			writer.Write(value, TriggerWidths[width]);
+		}
+
+		inline int16_t ToStick(float value)
+		{
+			value = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+			return static_cast<int16_t>(std::lround(value * 32767.0f));
+		}
+
+		inline uint8_t ToTrigger(float value)
+		{
+			value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+			return static_cast<uint8_t>(std::lround(value * 255.0f));
+		}
+
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void StateCodec::Quantize(const Gamepad::State& state, StateCodec::Quantized& quantized)
+	{
+		quantized.buttons = static_cast<uint16_t>(state.buttons & 0xf3ffu);
+		quantized.sticks[0] = ToStick(state.leftStick[0]);
+		quantized.sticks[1] = ToStick(state.leftStick[1]);
+		quantized.sticks[2] = ToStick(state.rightStick[0]);
+		quantized.sticks[3] = ToStick(state.rightStick[1]);
+		quantized.triggers[0] = ToTrigger(state.leftTrigger);
+		quantized.triggers[1] = ToTrigger(state.rightTrigger);
+		quantized.connected = state.connected ? 1 : 0;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void StateCodec::Dequantize(const StateCodec::Quantized& quantized, Gamepad::State& state)
+	{
+		state.leftStick = Vector2f(quantized.sticks[0] / 32767.0f, quantized.sticks[1] / 32767.0f);
+		state.rightStick = Vector2f(quantized.sticks[2] / 32767.0f, quantized.sticks[3] / 32767.0f);
+		state.leftTrigger = quantized.triggers[0] / 255.0f;
+		state.rightTrigger = quantized.triggers[1] / 255.0f;
+		state.buttons = quantized.buttons;
+		state.connected = (quantized.connected != 0);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void StateCodec::Encode(const StateCodec::Quantized& reference, const StateCodec::Quantized& state, BitWriter& writer)
+	{
+		uint32_t fields = 0;
+
+		fields |= (PackButtons(state.buttons) != PackButtons(reference.buttons)) ? FieldButtons : 0u;
+
+		for (size_t i = 0; i < 4; ++i)
+			fields |= (state.sticks[i] != reference.sticks[i]) ? (FieldSticks << i) : 0u;
+
+		for (size_t i = 0; i < 2; ++i)
+			fields |= (state.triggers[i] != reference.triggers[i]) ? (FieldTriggers << i) : 0u;
+
+		fields |= (state.connected != reference.connected) ? FieldConnected : 0u;
+
+		// The common case by far is an idle pad, which costs a single bit.
+		writer.Write(fields != 0, 1);
+
+		if (fields == 0)
+			return;
+
+		writer.Write(fields, 8);
+
+		if (fields & FieldButtons)
+			writer.Write(PackButtons(state.buttons), 14);
+
+		for (size_t i = 0; i < 4; ++i)
+		{
+			if (fields & (FieldSticks << i))
+				WriteStick(int32_t(state.sticks[i]) - int32_t(reference.sticks[i]), writer);
+		}
+
+		for (size_t i = 0; i < 2; ++i)
+		{
+			if (fields & (FieldTriggers << i))
+				WriteTrigger(int32_t(state.triggers[i]) - int32_t(reference.triggers[i]), writer);
+		}
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void StateCodec::Decode(const StateCodec::Quantized& reference, StateCodec::Quantized& state, BitReader& reader)
+	{
+		state = reference;
+
+		if (reader.Read(1) == 0)
+			return;
+
+		uint32_t fields = reader.Read(8);
+
+		if (fields & FieldButtons)
+			state.buttons = UnpackButtons(reader.Read(14));
+
+		for (size_t i = 0; i < 4; ++i)
+		{
+			if (fields & (FieldSticks << i))
+			{
+				uint32_t width = reader.Read(2);
+				state.sticks[i] = static_cast<int16_t>(int32_t(reference.sticks[i]) + UnZigZag(reader.Read(StickWidths[width])));
+			}
+		}
+
+		for (size_t i = 0; i < 2; ++i)
+		{
+			if (fields & (FieldTriggers << i))
+			{
+				uint32_t width = reader.Read(1);
+				state.triggers[i] = static_cast<uint8_t>(int32_t(reference.triggers[i]) + UnZigZag(reader.Read(TriggerWidths[width])));
+			}
+		}
+
+		if (fields & FieldConnected)
+			state.connected ^= 1;
+	}
+
+}
@@ -0,0 +1,162 @@
+#include <cstring>
+
+#include "decaf/input/gamepadevents.hh"
+#include "decaf/input/replay/gamepadimpl_replay.hh"
+
+namespace decaf
+{
+
+	////////////////////////////////////////////////////////////
+	GamepadImpl_Replay::GamepadImpl_Replay()
+		: m_mode{ Mode::REALTIME }, m_records{ nullptr }, m_count{ 0 }, m_cursor{ 0 }, m_base{ 0 }
+	{
+		Rewind();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	GamepadImpl_Replay::GamepadImpl_Replay(const char* path, Mode mode)
+		: GamepadImpl_Replay()
+	{
+		Open(path, mode);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool GamepadImpl_Replay::Open(const char* path, Mode mode)
+	{
+		m_records = nullptr;
+		m_count = 0;
+		m_mode = mode;
+
+		if (!m_file.Open(path) || m_file.Size() < sizeof(Replay::Header))
+		{
+			m_file.Close();
+			Rewind();
+			return false;
+		}
+
+		const Replay::Header* header = reinterpret_cast<const Replay::Header*>(m_file.Data());
+
+		if (memcmp(header->magic, Replay::Magic, sizeof(Replay::Magic)) != 0 || header->version != Replay::Version || header->recordSize != sizeof(Replay::Record))
+		{
+			m_file.Close();
+			Rewind();
+			return false;
+		}
+
+		m_records = reinterpret_cast<const Replay::Record*>(m_file.Data() + sizeof(Replay::Header));
+		m_count = (m_file.Size() - sizeof(Replay::Header)) / sizeof(Replay::Record);
+
+		Rewind();
+		return true;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Replay::Rewind()
+	{
+		m_cursor = 0;
+		m_base = GamepadEventQueue::Now();
+
+		for (size_t i = 0; i < Gamepad::IndexCount; ++i)
+			m_current[i] = nullptr;
+
+		SetConnectedMask(0);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool GamepadImpl_Replay::Finished() const
+	{
+		return m_cursor >= m_count;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	size_t GamepadImpl_Replay::RecordCount() const
+	{
+		return m_count;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	Gamepad::State GamepadImpl_Replay::GetState(Gamepad::Index index)
+	{
+		Gamepad::State result = {};
+		size_t slot = static_cast<size_t>(index);
+		const Replay::Record* record = m_current[slot];
+
+		// A record's position in the file serves as its packet number.
+		if (record != nullptr)
+		{
+			Replay::Decode(*record, result);
+			result.packet = static_cast<uint32_t>(record - m_records) + 1;
+			result.timestamp = m_base + record->timestamp;
+		}
+
+		return result;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	Gamepad::State GamepadImpl_Replay::GetState(Gamepad::Index index, const GamepadResponse& /*response*/)
+	{
+		return GetState(index);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint32_t GamepadImpl_Replay::GetStates(Gamepad::State* states, size_t count)
+	{
+		uint32_t connected = 0;
+
+		for (size_t i = 0; i < count && i < Gamepad::IndexCount; ++i)
+		{
+			states[i] = GetState(static_cast<Gamepad::Index>(i));
+			connected |= (states[i].connected ? 1u : 0u) << i;
+		}
+
+		return connected;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Replay::SetRumble(Gamepad::Index /*index*/, float /*left*/, float /*right*/)
+	{
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Replay::Update()
+	{
+		if (Finished())
+			return;
+
+		if (m_mode == Mode::REALTIME)
+		{
+			Apply(GamepadEventQueue::Now() - m_base);
+		}
+		else
+		{
+			Apply(m_records[m_cursor].timestamp);
+		}
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Replay::Apply(uint64_t until)
+	{
+		while (m_cursor < m_count && m_records[m_cursor].timestamp <= until)
+		{
+			const Replay::Record& record = m_records[m_cursor++];
+
+			if (record.index < Gamepad::IndexCount)
+			{
+				m_current[record.index] = &record;
+				SetConnected(static_cast<Gamepad::Index>(record.index), record.connected != 0);
+			}
+		}
+	}
+
+}
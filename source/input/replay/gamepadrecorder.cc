@@ -0,0 +1,178 @@
+#include <cstring>
+
+#include "decaf/input/replay/gamepadrecorder.hh"
+
+namespace decaf
+{
+
+	////////////////////////////////////////////////////////////
+	GamepadRecorder::GamepadRecorder(IGamepadImpl* source, const char* path)
+		: m_source{ source }, m_file{ fopen(path, "wb") }, m_origin{ 0 }, m_elapsed{ 0 }
+	{
+		memset(m_last, 0, sizeof(m_last));
+
+		for (bool& written : m_written)
+			written = false;
+
+		if (m_file == nullptr)
+			return;
+
+		Replay::Header header = { { 0 }, Replay::Version, sizeof(Replay::Record), 0 };
+		memcpy(header.magic, Replay::Magic, sizeof(Replay::Magic));
+
+		if (fwrite(&header, sizeof(Replay::Header), 1, m_file) != 1)
+		{
+			fclose(m_file);
+			m_file = nullptr;
+		}
+	}
+
+
+	////////////////////////////////////////////////////////////
+	GamepadRecorder::~GamepadRecorder()
+	{
+		if (m_file != nullptr)
+			fclose(m_file);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool GamepadRecorder::IsOpen() const
+	{
+		return m_file != nullptr;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadRecorder::Flush()
+	{
+		if (m_file != nullptr)
+			fflush(m_file);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	Gamepad::State GamepadRecorder::GetState(Gamepad::Index index)
+	{
+		// Only to advance ResponseEpoch; the source applies the same curves on its own read.
+		ApplyResponses();
+
+		Gamepad::State result = m_source->GetState(index);
+		SetConnectedMask(m_source->ConnectedMask());
+		Record(index, result);
+
+		return result;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	Gamepad::State GamepadRecorder::GetState(Gamepad::Index index, const GamepadResponse& response)
+	{
+		return m_source->GetState(index, response);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint32_t GamepadRecorder::GetStates(Gamepad::State* states, size_t count)
+	{
+		ApplyResponses();
+
+		uint32_t connected = m_source->GetStates(states, count);
+		SetConnectedMask(m_source->ConnectedMask());
+
+		for (size_t i = 0; i < count && i < Gamepad::IndexCount; ++i)
+			Record(static_cast<Gamepad::Index>(i), states[i]);
+
+		return connected;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadRecorder::SetRumble(Gamepad::Index index, float left, float right)
+	{
+		m_source->SetRumble(index, left, right);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadRecorder::SetResponse(Gamepad::Index index, const GamepadResponse& response)
+	{
+		IGamepadImpl::SetResponse(index, response);
+		m_source->SetResponse(index, response);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadRecorder::Update()
+	{
+		m_source->Update();
+		SetConnectedMask(m_source->ConnectedMask());
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadRecorder::NotifyHotplug()
+	{
+		m_source->NotifyHotplug();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadRecorder::SetEventQueue(GamepadEventQueue* events)
+	{
+		m_source->SetEventQueue(events);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	size_t GamepadRecorder::DeviceCount() const
+	{
+		return m_source->DeviceCount();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	size_t GamepadRecorder::GetDevices(Gamepad::DeviceId* ids, Gamepad::State* states, size_t capacity)
+	{
+		return m_source->GetDevices(ids, states, capacity);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	Gamepad::DeviceId GamepadRecorder::GetDeviceId(Gamepad::Index index) const
+	{
+		return m_source->GetDeviceId(index);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void GamepadRecorder::Record(Gamepad::Index index, const Gamepad::State& state)
+	{
+		size_t slot = static_cast<size_t>(index);
+
+		if (m_file == nullptr)
+			return;
+
+		if (m_origin == 0)
+			m_origin = state.timestamp;
+
+		// A pad still holding a reading older than one already written is stamped with that record's time, so playback stays in file order.
+		uint64_t elapsed = (state.timestamp > m_origin ? state.timestamp - m_origin : 0);
+		if (elapsed < m_elapsed)
+			elapsed = m_elapsed;
+
+		Replay::Record record;
+		Replay::Encode(state, index, elapsed, record);
+
+		// Compare everything but the timestamp; unchanged states are implied by the previous record.
+		if (m_written[slot] && memcmp(&record.state, &m_last[slot].state, sizeof(Replay::Record) - sizeof(uint64_t)) == 0)
+			return;
+
+		m_last[slot] = record;
+		m_written[slot] = true;
+		m_elapsed = elapsed;
+
+		fwrite(&record, sizeof(Replay::Record), 1, m_file);
+	}
+
+}
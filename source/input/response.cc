@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <cmath>
+
+#include "decaf/input/response.hh"
+
+namespace decaf
+{
+
+	namespace
+	{
+
+		// Same thresholds as XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE / XINPUT_GAMEPAD_RIGHT_THUMB_DEADZONE.
+		constexpr float LeftThumbDeadzone = 7849.0f / 32767;
+		constexpr float RightThumbDeadzone = 8689.0f / 32767;
+
+		struct StickTable
+		{
+			float values[StickResponse::TableSize];
+		};
+
+		/// The historical per-axis formula, kept operation for operation so the tables reproduce it exactly.
+		constexpr float XInputCurve(float n, float deadzone)
+		{
+			float magnitude = (n < 0 ? -n : n);
+			float value = (magnitude < deadzone ? 0 : (magnitude - deadzone) * (n * magnitude));
+			return value * (1 / (1 - deadzone));
+		}
+
+		constexpr float StickMagnitude(size_t i)
+		{
+			// -32768 normalizes below -1 and was always clamped, so the last entry repeats full deflection.
+			return static_cast<float>(i < 32767 ? i : 32767) / 32767.0f;
+		}
+
+		constexpr StickTable BuildXInputStick(float deadzone)
+		{
+			StickTable table = {};
+
+			for (size_t i = 0; i < StickResponse::TableSize; ++i)
+				table.values[i] = XInputCurve(StickMagnitude(i), deadzone);
+
+			return table;
+		}
+
+		constexpr StickTable XInputLeftTable = BuildXInputStick(LeftThumbDeadzone);
+		constexpr StickTable XInputRightTable = BuildXInputStick(RightThumbDeadzone);
+
+		constexpr StickTable BuildLinearStick()
+		{
+			StickTable table = {};
+
+			for (size_t i = 0; i < StickResponse::TableSize; ++i)
+				table.values[i] = StickMagnitude(i);
+
+			return table;
+		}
+
+		constexpr StickTable LinearTable = BuildLinearStick();
+
+		float EvaluateCurve(const AxisCurve& curve, float magnitude)
+		{
+			if (curve.shape == AxisCurve::Shape::XINPUT)
+				return XInputCurve(magnitude, curve.deadzone);
+
+			float range = curve.outerDeadzone - curve.deadzone;
+			if (range <= 0)
+				return (magnitude < curve.deadzone ? 0.0f : 1.0f);
+
+			float t = std::min(1.0f, std::max(0.0f, (magnitude - curve.deadzone) / range));
+			return (curve.exponent == 1 ? t : powf(t, curve.exponent));
+		}
+
+	}
+
+
+	////////////////////////////////////////////////////////////
+	const StickResponse& StickResponse::XInputLeft()
+	{
+		static const StickResponse response(XInputLeftTable.values);
+		return response;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	const StickResponse& StickResponse::XInputRight()
+	{
+		static const StickResponse response(XInputRightTable.values);
+		return response;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	const StickResponse& StickResponse::Linear()
+	{
+		static const StickResponse response(LinearTable.values);
+		return response;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	StickResponse::StickResponse()
+		: StickResponse(XInputLeftTable.values) { }
+
+
+	////////////////////////////////////////////////////////////
+	StickResponse::StickResponse(const float* table)
+		: m_table{ table }, m_invertX{ false }, m_invertY{ false } { }
+
+
+	////////////////////////////////////////////////////////////
+	StickResponse::StickResponse(const AxisCurve& curve, bool invertX, bool invertY)
+		: m_invertX{ invertX }, m_invertY{ invertY }
+	{
+		auto storage = std::make_shared<std::vector<float>>(TableSize);
+
+		for (size_t i = 0; i < TableSize; ++i)
+			(*storage)[i] = EvaluateCurve(curve, StickMagnitude(i));
+
+		m_table = storage->data();
+		m_storage = std::move(storage);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	const TriggerResponse& TriggerResponse::Linear()
+	{
+		static const TriggerResponse response;
+		return response;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	TriggerResponse::TriggerResponse()
+	{
+		for (size_t i = 0; i < TableSize; ++i)
+			m_table[i] = (float)i / 255;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	TriggerResponse::TriggerResponse(const AxisCurve& curve)
+	{
+		for (size_t i = 0; i < TableSize; ++i)
+			m_table[i] = EvaluateCurve(curve, (float)i / 255);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	const GamepadResponse& GamepadResponse::XInput()
+	{
+		static const GamepadResponse response = { StickResponse::XInputLeft(), StickResponse::XInputRight(), TriggerResponse::Linear(), TriggerResponse::Linear() };
+		return response;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	const GamepadResponse& GamepadResponse::XInput(float deadzone)
+	{
+		struct Entry
+		{
+			float deadzone;
+			GamepadResponse response;
+		};
+
+		thread_local Entry cache[XInputCacheSize];
+		thread_local size_t count = 0;
+		thread_local size_t next = 0;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (cache[i].deadzone == deadzone)
+				return cache[i].response;
+		}
+
+		// Evict the oldest entry once the cache is full.
+		Entry& entry = cache[next];
+		StickResponse stick({ AxisCurve::Shape::XINPUT, deadzone, 1.0f, 1.0f });
+
+		entry.deadzone = deadzone;
+		entry.response = { stick, stick, TriggerResponse::Linear(), TriggerResponse::Linear() };
+
+		next = (next + 1) % XInputCacheSize;
+		count = count < XInputCacheSize ? count + 1 : count;
+
+		return entry.response;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	const GamepadResponse& GamepadResponse::Linear()
+	{
+		static const GamepadResponse response = { StickResponse::Linear(), StickResponse::Linear(), TriggerResponse::Linear(), TriggerResponse::Linear() };
+		return response;
+	}
+
+}
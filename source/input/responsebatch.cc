@@ -0,0 +1,226 @@
+#include <atomic>
+
+#include "decaf/input/responsebatch.hh"
+#include "decaf/system/cpufeatures.hh"
+
+#if defined (DECAF_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+#if defined (DECAF_ARCH_X86) && (defined (__GNUC__) || defined (__clang__))
+#define DECAF_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define DECAF_TARGET_AVX2
+#endif
+
+namespace decaf
+{
+
+	namespace Response
+	{
+
+		namespace
+		{
+
+			using AxisKernel = void (*)(const float* table, uint32_t invert, const int16_t* raw, float* out, size_t count);
+			using TriggerKernel = void (*)(const float* table, const uint8_t* raw, float* out, size_t count);
+
+			inline float LookupAxis(const float* table, uint32_t invert, int16_t raw)
+			{
+				bool negative = (raw < 0);
+				float magnitude = table[negative ? -static_cast<int32_t>(raw) : raw];
+				return ((negative != (invert != 0)) ? -magnitude : magnitude) + 0.0f;
+			}
+
+			void AxisScalar(const float* table, uint32_t invert, const int16_t* raw, float* out, size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					out[i] = LookupAxis(table, invert, raw[i]);
+			}
+
+			void TriggerScalar(const float* table, const uint8_t* raw, float* out, size_t count)
+			{
+				for (size_t i = 0; i < count; ++i)
+					out[i] = table[raw[i]];
+			}
+
+#if defined (DECAF_ARCH_X86)
+
+			void AxisSSE2(const float* table, uint32_t invert, const int16_t* raw, float* out, size_t count)
+			{
+				const __m128 invertMask = _mm_castsi128_ps(_mm_set1_epi32(invert != 0 ? static_cast<int>(0x80000000u) : 0));
+				const __m128i signBit = _mm_set1_epi32(static_cast<int>(0x80000000u));
+				const __m128 zero = _mm_setzero_ps();
+
+				size_t i = 0;
+
+				for (; i + 8 <= count; i += 8)
+				{
+					__m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(raw + i));
+
+					// Sign-extend the eight int16 lanes into two int32 vectors.
+					__m128i halves[2] = { _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16), _mm_srai_epi32(_mm_unpackhi_epi16(packed, packed), 16) };
+
+					for (int h = 0; h < 2; ++h)
+					{
+						__m128i value = halves[h];
+						__m128i sign = _mm_srai_epi32(value, 31);
+						__m128i magnitude = _mm_sub_epi32(_mm_xor_si128(value, sign), sign);
+
+						alignas(16) int32_t index[4];
+						_mm_store_si128(reinterpret_cast<__m128i*>(index), magnitude);
+
+						__m128 result = _mm_setr_ps(table[index[0]], table[index[1]], table[index[2]], table[index[3]]);
+						__m128 flip = _mm_xor_ps(_mm_castsi128_ps(_mm_and_si128(value, signBit)), invertMask);
+
+						result = _mm_add_ps(_mm_xor_ps(result, flip), zero);
+						_mm_storeu_ps(out + i + h * 4, result);
+					}
+				}
+
+				AxisScalar(table, invert, raw + i, out + i, count - i);
+			}
+
+			void TriggerSSE2(const float* table, const uint8_t* raw, float* out, size_t count)
+			{
+				size_t i = 0;
+
+				for (; i + 4 <= count; i += 4)
+					_mm_storeu_ps(out + i, _mm_setr_ps(table[raw[i]], table[raw[i + 1]], table[raw[i + 2]], table[raw[i + 3]]));
+
+				TriggerScalar(table, raw + i, out + i, count - i);
+			}
+
+			DECAF_TARGET_AVX2 void AxisAVX2(const float* table, uint32_t invert, const int16_t* raw, float* out, size_t count)
+			{
+				const __m256 invertMask = _mm256_castsi256_ps(_mm256_set1_epi32(invert != 0 ? static_cast<int>(0x80000000u) : 0));
+				const __m256i signBit = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+				const __m256 zero = _mm256_setzero_ps();
+
+				size_t i = 0;
+
+				for (; i + 8 <= count; i += 8)
+				{
+					__m256i value = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(raw + i)));
+					__m256 result = _mm256_i32gather_ps(table, _mm256_abs_epi32(value), 4);
+					__m256 flip = _mm256_xor_ps(_mm256_castsi256_ps(_mm256_and_si256(value, signBit)), invertMask);
+
+					_mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_xor_ps(result, flip), zero));
+				}
+
+				AxisScalar(table, invert, raw + i, out + i, count - i);
+			}
+
+			DECAF_TARGET_AVX2 void TriggerAVX2(const float* table, const uint8_t* raw, float* out, size_t count)
+			{
+				size_t i = 0;
+
+				for (; i + 8 <= count; i += 8)
+				{
+					__m256i index = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(raw + i)));
+					_mm256_storeu_ps(out + i, _mm256_i32gather_ps(table, index, 4));
+				}
+
+				TriggerScalar(table, raw + i, out + i, count - i);
+			}
+
+#endif
+
+			struct Dispatch
+			{
+				Kernel kernel;
+				AxisKernel axis;
+				TriggerKernel trigger;
+			};
+
+			Dispatch Resolve(Kernel requested)
+			{
+#if defined (DECAF_ARCH_X86)
+				const CpuFeatures& cpu = CpuFeatures::Get();
+
+				if (requested == Kernel::AVX2 && cpu.avx2)
+					return { Kernel::AVX2, AxisAVX2, TriggerAVX2 };
+
+				if (requested != Kernel::SCALAR && cpu.sse2)
+					return { Kernel::SSE2, AxisSSE2, TriggerSSE2 };
+#else
+				(void)requested;
+#endif
+
+				return { Kernel::SCALAR, AxisScalar, TriggerScalar };
+			}
+
+			std::atomic<AxisKernel> s_axis{ nullptr };
+			std::atomic<TriggerKernel> s_trigger{ nullptr };
+			std::atomic<Kernel> s_kernel{ Kernel::SCALAR };
+
+			void Install(const Dispatch& dispatch)
+			{
+				s_kernel.store(dispatch.kernel, std::memory_order_relaxed);
+				s_trigger.store(dispatch.trigger, std::memory_order_relaxed);
+				s_axis.store(dispatch.axis, std::memory_order_release);
+			}
+
+			inline AxisKernel Axis()
+			{
+				AxisKernel kernel = s_axis.load(std::memory_order_acquire);
+
+				if (kernel == nullptr)
+				{
+					Install(Resolve(Kernel::AVX2));
+					kernel = s_axis.load(std::memory_order_acquire);
+				}
+
+				return kernel;
+			}
+
+			inline TriggerKernel Trigger()
+			{
+				Axis();
+				return s_trigger.load(std::memory_order_relaxed);
+			}
+
+		}
+
+
+		////////////////////////////////////////////////////////////
+		Kernel ActiveKernel()
+		{
+			Axis();
+			return s_kernel.load(std::memory_order_relaxed);
+		}
+
+
+		////////////////////////////////////////////////////////////
+		Kernel SelectKernel(Kernel kernel)
+		{
+			Install(Resolve(kernel));
+			return s_kernel.load(std::memory_order_relaxed);
+		}
+
+
+		////////////////////////////////////////////////////////////
+		void ConvertAxis(const StickResponse& response, bool invert, const int16_t* raw, float* out, size_t count)
+		{
+			Axis()(response.Table(), invert ? 1u : 0u, raw, out, count);
+		}
+
+
+		////////////////////////////////////////////////////////////
+		void ConvertStick(const StickResponse& response, const int16_t* rawX, const int16_t* rawY, float* outX, float* outY, size_t count)
+		{
+			AxisKernel kernel = Axis();
+			kernel(response.Table(), response.InvertX() ? 1u : 0u, rawX, outX, count);
+			kernel(response.Table(), response.InvertY() ? 1u : 0u, rawY, outY, count);
+		}
+
+
+		////////////////////////////////////////////////////////////
+		void ConvertTrigger(const TriggerResponse& response, const uint8_t* raw, float* out, size_t count)
+		{
+			Trigger()(response.Table(), raw, out, count);
+		}
+
+	}
+
+}
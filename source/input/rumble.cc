@@ -0,0 +1,292 @@
+#include "decaf/input/rumble.hh"
+#include "decaf/input/gamepadimpl.hh"
+
+namespace decaf
+{
+
+	namespace
+	{
+
+		inline uint16_t ToSpeed(float value)
+		{
+			value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+			return static_cast<uint16_t>(value * 65535.0f + 0.5f);
+		}
+
+	}
+
+
+	////////////////////////////////////////////////////////////
+	RumbleMixer::RumbleMixer()
+		: m_pads{}, m_serial{ 0 }, m_pending{}, m_submits{ 0 }, m_target{ nullptr }
+	{
+		for (uint64_t& written : m_written)
+			written = Unwritten;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint32_t RumbleMixer::Play(Gamepad::Index index, const RumbleEffect& effect, uint64_t now)
+	{
+		size_t slot = static_cast<size_t>(index);
+		std::lock_guard<std::mutex> lock(m_mutex);
+		Pad& pad = m_pads[slot];
+
+		size_t voice = pad.count;
+
+		if (pad.count == MaxEffects)
+		{
+			// Make room by cutting the oldest of the quietest-priority effects, if any ranks below the new one.
+			voice = 0;
+
+			for (size_t i = 1; i < pad.count; ++i)
+			{
+				if (pad.voices[i].effect.priority < pad.voices[voice].effect.priority)
+					voice = i;
+			}
+
+			if (pad.voices[voice].effect.priority >= effect.priority)
+				return 0;
+		}
+		else
+		{
+			++pad.count;
+		}
+
+		// The low bits carry the pad so Stop finds the voice without searching every pad.
+		m_serial = (m_serial + 1) & 0x3fffffff;
+		m_serial += (m_serial == 0);
+
+		uint32_t handle = (m_serial << 2) | static_cast<uint32_t>(slot);
+		pad.voices[voice] = { effect, now, handle };
+
+		Mix(slot, now);
+		return handle;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void RumbleMixer::Stop(uint32_t handle, uint64_t now)
+	{
+		if (handle == 0)
+			return;
+
+		size_t slot = handle & 3;
+		std::lock_guard<std::mutex> lock(m_mutex);
+		Pad& pad = m_pads[slot];
+
+		for (size_t i = 0; i < pad.count; ++i)
+		{
+			if (pad.voices[i].handle == handle)
+			{
+				pad.voices[i] = pad.voices[--pad.count];
+				Mix(slot, now);
+				return;
+			}
+		}
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void RumbleMixer::StopAll(Gamepad::Index index, uint64_t now)
+	{
+		size_t slot = static_cast<size_t>(index);
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		m_pads[slot].count = 0;
+		m_pads[slot].level[0] = 0.0f;
+		m_pads[slot].level[1] = 0.0f;
+
+		Mix(slot, now);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void RumbleMixer::SetLevel(Gamepad::Index index, float left, float right, uint64_t now)
+	{
+		size_t slot = static_cast<size_t>(index);
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		m_pads[slot].level[0] = left;
+		m_pads[slot].level[1] = right;
+
+		Mix(slot, now);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void RumbleMixer::Tick(uint64_t now)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		for (size_t i = 0; i < Gamepad::IndexCount; ++i)
+		{
+			if (m_pads[i].count != 0)
+				Mix(i, now);
+		}
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void RumbleMixer::Submit(IGamepadImpl& impl)
+	{
+		if (!IsPending())
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(m_submitMutex);
+
+			// A replaced backend's motors may run at anything.
+			if (&impl != m_target)
+			{
+				m_target = &impl;
+
+				for (uint64_t& written : m_written)
+					written = Unwritten;
+			}
+
+			for (size_t i = 0; i < Gamepad::IndexCount; ++i)
+			{
+				uint64_t pending = m_pending[i].fetch_and(~Dirty, std::memory_order_acquire);
+
+				if ((pending & Dirty) == 0)
+					continue;
+
+				// A mix that went and came back between two submissions leaves the motors where they are.
+				uint64_t speeds = pending & ~Dirty;
+				if (m_written[i] == speeds)
+					continue;
+
+				m_written[i] = speeds;
+
+				uint16_t left = static_cast<uint16_t>(pending >> 16);
+				uint16_t right = static_cast<uint16_t>(pending);
+
+				impl.SetRumble(static_cast<Gamepad::Index>(i), left / 65535.0f, right / 65535.0f);
+				m_submits.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
+		m_submitted.notify_all();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool RumbleMixer::Flush(std::chrono::microseconds timeout)
+	{
+		std::unique_lock<std::mutex> lock(m_submitMutex);
+		return m_submitted.wait_for(lock, timeout, [this] { return !IsPending(); });
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool RumbleMixer::IsPending() const
+	{
+		for (const std::atomic<uint64_t>& pending : m_pending)
+		{
+			if ((pending.load(std::memory_order_acquire) & Dirty) != 0)
+				return true;
+		}
+
+		return false;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void RumbleMixer::GetMix(Gamepad::Index index, float& left, float& right) const
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		const Pad& pad = m_pads[static_cast<size_t>(index)];
+
+		left = pad.mixed[0] / 65535.0f;
+		right = pad.mixed[1] / 65535.0f;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint64_t RumbleMixer::SubmitCount() const
+	{
+		return m_submits.load(std::memory_order_relaxed);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	float RumbleMixer::Envelope(const RumbleEffect& effect, uint64_t elapsed)
+	{
+		if (elapsed < effect.attack)
+			return static_cast<float>(elapsed) / static_cast<float>(effect.attack);
+
+		elapsed -= effect.attack;
+
+		if (effect.sustain == RumbleEffect::Forever || elapsed < effect.sustain)
+			return 1.0f;
+
+		elapsed -= effect.sustain;
+
+		if (elapsed < effect.decay)
+			return 1.0f - static_cast<float>(elapsed) / static_cast<float>(effect.decay);
+
+		return -1.0f;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void RumbleMixer::Mix(size_t slot, uint64_t now)
+	{
+		Pad& pad = m_pads[slot];
+		bool leveled = (pad.level[0] > 0.0f || pad.level[1] > 0.0f);
+
+		int32_t priority = 0;
+		bool any = leveled;
+
+		for (size_t i = 0; i < pad.count; )
+		{
+			const Voice& voice = pad.voices[i];
+
+			if (now >= voice.start && Envelope(voice.effect, now - voice.start) < 0.0f)
+			{
+				pad.voices[i] = pad.voices[--pad.count];
+				continue;
+			}
+
+			if (!any || voice.effect.priority > priority)
+				priority = voice.effect.priority;
+
+			any = true;
+			++i;
+		}
+
+		float left = 0.0f;
+		float right = 0.0f;
+
+		if (leveled && priority <= 0)
+		{
+			left = pad.level[0];
+			right = pad.level[1];
+		}
+
+		// Effects of the winning priority stack by taking the strongest of each motor, so two identical effects do not double up.
+		for (size_t i = 0; i < pad.count; ++i)
+		{
+			const Voice& voice = pad.voices[i];
+
+			if (voice.effect.priority != priority)
+				continue;
+
+			float envelope = now >= voice.start ? Envelope(voice.effect, now - voice.start) : 0.0f;
+			left = left > voice.effect.left * envelope ? left : voice.effect.left * envelope;
+			right = right > voice.effect.right * envelope ? right : voice.effect.right * envelope;
+		}
+
+		uint16_t speed[2] = { ToSpeed(left), ToSpeed(right) };
+
+		if (speed[0] == pad.mixed[0] && speed[1] == pad.mixed[1])
+			return;
+
+		pad.mixed[0] = speed[0];
+		pad.mixed[1] = speed[1];
+
+		m_pending[slot].store(Dirty | (static_cast<uint64_t>(speed[0]) << 16) | speed[1], std::memory_order_release);
+	}
+
+}
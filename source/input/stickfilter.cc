@@ -0,0 +1,229 @@
+#include <cmath>
+
+#include "decaf/input/stickfilter.hh"
+
+namespace decaf
+{
+
+	namespace
+	{
+
+		constexpr float TwoPi = 6.28318531f;
+
+		/// <summary>The cutoff of the One Euro filter's speed estimate, in Hz, as recommended by its authors.</summary>
+		constexpr float DerivativeCutoff = 1.0f;
+
+		/// <summary>The smallest smoothing time a spring accepts, so its stiffness stays finite.</summary>
+		constexpr float MinSmoothTime = 0.0001f;
+
+		/// <summary>How close to its sample a lane must be, with how little speed left, before it snaps onto the sample and counts as settled.
+		/// Half a step of the packed int16 stick, so the snap never changes a stored state.</summary>
+		constexpr float SettleDistance = 0.5f / 32767.0f;
+		constexpr float SettleSpeed = 0.001f;
+
+		inline float Clamp(float value)
+		{
+			return value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+		}
+
+		inline void Gather(const Gamepad::State& state, float* lanes)
+		{
+			lanes[0] = state.leftStick[0];
+			lanes[1] = state.leftStick[1];
+			lanes[2] = state.rightStick[0];
+			lanes[3] = state.rightStick[1];
+		}
+
+	}
+
+
+	////////////////////////////////////////////////////////////
+	StickFilter::StickFilter()
+		: m_value{}, m_velocity{}, m_raw{}, m_minCutoff{}, m_beta{}, m_omega{}, m_lead{}, m_oneEuro{}, m_damped{}, m_time{}, m_primed{}, m_active{ 0 }, m_settled{ 0 }
+	{
+		for (StickFilterSettings& settings : m_settings)
+			settings = StickFilterSettings::None();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void StickFilter::SetSettings(Gamepad::Index index, const StickFilterSettings& left, const StickFilterSettings& right)
+	{
+		size_t pad = static_cast<size_t>(index);
+		const StickFilterSettings* sticks[2] = { &left, &right };
+
+		m_active &= ~(1u << pad);
+
+		for (size_t stick = 0; stick < 2; ++stick)
+		{
+			const StickFilterSettings& settings = *sticks[stick];
+			m_settings[pad * 2 + stick] = settings;
+
+			bool oneEuro = (settings.mode == StickFilterSettings::Mode::ONE_EURO);
+			bool damped = (settings.mode == StickFilterSettings::Mode::CRITICALLY_DAMPED);
+			float smoothTime = settings.smoothTime > MinSmoothTime ? settings.smoothTime : MinSmoothTime;
+
+			for (size_t axis = 0; axis < 2; ++axis)
+			{
+				size_t lane = pad * 4 + stick * 2 + axis;
+
+				m_minCutoff[lane] = settings.minCutoff;
+				m_beta[lane] = settings.beta;
+				m_omega[lane] = 2.0f / smoothTime;
+				m_lead[lane] = settings.lead;
+				m_oneEuro[lane] = oneEuro ? 1.0f : 0.0f;
+				m_damped[lane] = damped ? 1.0f : 0.0f;
+			}
+
+			if (oneEuro || damped || settings.lead != 0.0f)
+				m_active |= 1u << pad;
+		}
+
+		Reset(index);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void StickFilter::Reset(Gamepad::Index index)
+	{
+		m_primed[static_cast<size_t>(index)] = false;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void StickFilter::Apply(Gamepad::State* states, size_t count, uint64_t now)
+	{
+		if (m_active == 0)
+			return;
+
+		Run(0, count < Gamepad::IndexCount ? count : Gamepad::IndexCount, states, now);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void StickFilter::Apply(Gamepad::Index index, Gamepad::State& state, uint64_t now)
+	{
+		if ((m_active & (1u << static_cast<size_t>(index))) == 0)
+			return;
+
+		Run(static_cast<size_t>(index), 1, &state, now);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void StickFilter::Run(size_t first, size_t pads, Gamepad::State* states, uint64_t now)
+	{
+		alignas(16) float raw[Lanes];
+		alignas(16) float step[Lanes];
+		alignas(16) float fresh[Lanes];
+		bool write[Gamepad::IndexCount];
+
+		// Work out each pad's time step; stale lanes get a harmless step of 1 and are blended out below.
+		for (size_t p = 0; p < pads; ++p)
+		{
+			size_t pad = first + p;
+			const Gamepad::State& state = states[p];
+			float dt = 1.0f;
+			float isFresh = 0.0f;
+
+			Gather(state, raw + pad * 4);
+			write[p] = state.connected;
+
+			if (!state.connected)
+			{
+				m_primed[pad] = false;
+			}
+			else if (!m_primed[pad])
+			{
+				for (size_t lane = pad * 4; lane < pad * 4 + 4; ++lane)
+				{
+					m_value[lane] = raw[lane];
+					m_velocity[lane] = 0.0f;
+					m_raw[lane] = raw[lane];
+				}
+
+				m_time[pad] = now;
+				m_primed[pad] = true;
+			}
+			else if (now > m_time[pad])
+			{
+				// Step by the poll clock: the same sample read again later still moves the filter towards it.
+				dt = static_cast<float>(now - m_time[pad]) * 1e-9f;
+				isFresh = 1.0f;
+				m_time[pad] = now;
+			}
+
+			for (size_t lane = pad * 4; lane < pad * 4 + 4; ++lane)
+			{
+				step[lane] = dt;
+				fresh[lane] = isFresh;
+			}
+		}
+
+		// Every lane runs every mode and keeps the one its weights select, so the loop has no branches.
+		for (size_t lane = first * 4; lane < (first + pads) * 4; ++lane)
+		{
+			float x = raw[lane];
+			float dt = step[lane];
+			float f = fresh[lane];
+			float value = m_value[lane];
+			float velocity = m_velocity[lane];
+			float dx = (x - m_raw[lane]) / dt;
+
+			// One Euro: smooth the speed, then let it open up the cutoff of the value's low-pass.
+			float wd = TwoPi * DerivativeCutoff * dt;
+			float euroVelocity = velocity + (wd / (wd + 1.0f)) * (dx - velocity);
+			float wc = TwoPi * (m_minCutoff[lane] + m_beta[lane] * std::fabs(euroVelocity)) * dt;
+			float euro = value + (wc / (wc + 1.0f)) * (x - value);
+
+			// Critically damped spring, with the usual polynomial approximation of exp(-omega * dt).
+			float omega = m_omega[lane];
+			float w = omega * dt;
+			float decay = 1.0f / (1.0f + w + 0.48f * w * w + 0.235f * w * w * w);
+			float change = value - x;
+			float temp = (velocity + omega * change) * dt;
+			float springVelocity = (velocity - omega * temp) * decay;
+			float spring = x + (change + temp) * decay;
+
+			float e = m_oneEuro[lane];
+			float c = m_damped[lane];
+			float n = 1.0f - e - c;
+
+			float nextValue = e * euro + c * spring + n * x;
+			float nextVelocity = e * euroVelocity + c * springVelocity + n * dx;
+
+			// A lane that has all but caught up lands exactly on its sample, so a held stick settles instead of creeping forever.
+			float snap = f * static_cast<float>((std::fabs(nextValue - x) <= SettleDistance) & (std::fabs(nextVelocity) <= SettleSpeed));
+			nextValue = snap * x + (1.0f - snap) * nextValue;
+			nextVelocity = (1.0f - snap) * nextVelocity;
+
+			m_value[lane] = f * nextValue + (1.0f - f) * value;
+			m_velocity[lane] = f * nextVelocity + (1.0f - f) * velocity;
+			m_raw[lane] = f * x + (1.0f - f) * m_raw[lane];
+		}
+
+		for (size_t p = 0; p < pads; ++p)
+		{
+			size_t pad = first + p;
+			size_t lane = pad * 4;
+			bool settled = true;
+
+			for (size_t i = 0; i < 4; ++i)
+				settled = settled && m_value[lane + i] == m_raw[lane + i] && m_velocity[lane + i] == 0.0f;
+
+			m_settled = settled || !write[p] ? (m_settled | (1u << pad)) : (m_settled & ~(1u << pad));
+
+			if (!write[p])
+				continue;
+
+			float out[4];
+
+			for (size_t i = 0; i < 4; ++i)
+				out[i] = Clamp(m_value[lane + i] + m_velocity[lane + i] * m_lead[lane + i]);
+
+			states[p].leftStick = Vector2f(out[0], out[1]);
+			states[p].rightStick = Vector2f(out[2], out[3]);
+		}
+	}
+
+}
@@ -1,94 +1,117 @@
-#include <cmath>
-
 #include <Windows.h>
 #pragma comment (lib, "XInput.lib")
 #include <Xinput.h>
 
+#include "decaf/input/gamepadevents.hh"
+#include "decaf/input/response.hh"
 #include "decaf/input/win32/gamepadimpl_win32.hh"
 
 namespace decaf
 {
 
 	////////////////////////////////////////////////////////////
-	void ParseXInputState(const XINPUT_STATE& xis, Gamepad::State& gps)
+	void ParseXInputState(const XINPUT_STATE& xis, Gamepad::State& gps, const GamepadResponse& response)
 	{
-		constexpr float dzL = (float)XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE / 32767;
-		constexpr float dzR = (float)XINPUT_GAMEPAD_RIGHT_THUMB_DEADZONE / 32767;
-
-		float nLX = fmaxf(-1.0f, (float)xis.Gamepad.sThumbLX / 32767.0f);
-		float nLY = fmaxf(-1.0f, (float)xis.Gamepad.sThumbLY / 32767.0f);
-
-		gps.leftStick[0] = (abs(nLX) < dzL ? 0 : (abs(nLX) - dzL) * (nLX * abs(nLX)));
-		gps.leftStick[1] = (abs(nLY) < dzL ? 0 : (abs(nLY) - dzL) * (nLY * abs(nLY)));
-
-		float nRX = fmaxf(-1.0f, (float)xis.Gamepad.sThumbRX / 32767.0f);
-		float nRY = fmaxf(-1.0f, (float)xis.Gamepad.sThumbRY / 32767.0f);
-
-		gps.rightStick[0] = (abs(nRX) < dzR ? 0 : (abs(nRX) - dzR) * (nRX * abs(nRX)));
-		gps.rightStick[1] = (abs(nRY) < dzR ? 0 : (abs(nRY) - dzR) * (nRY * abs(nRY)));
-
-		gps.leftStick *= 1 / (1 - dzL);
-		gps.rightStick *= 1 / (1 - dzR);
-
-		gps.leftTrigger = (float)xis.Gamepad.bLeftTrigger / 255;
-		gps.rightTrigger = (float)xis.Gamepad.bRightTrigger / 255;
+		Gamepad::RawState raw;
+		raw.thumbLX = xis.Gamepad.sThumbLX;
+		raw.thumbLY = xis.Gamepad.sThumbLY;
+		raw.thumbRX = xis.Gamepad.sThumbRX;
+		raw.thumbRY = xis.Gamepad.sThumbRY;
+		raw.leftTrigger = xis.Gamepad.bLeftTrigger;
+		raw.rightTrigger = xis.Gamepad.bRightTrigger;
+		raw.buttons = xis.Gamepad.wButtons;
 
-		gps.buttons = xis.Gamepad.wButtons;
+		response.Decode(raw, gps);
 
 		gps.connected = true;
+
+		gps.packet = static_cast<uint32_t>(xis.dwPacketNumber);
+		gps.timestamp = GamepadEventQueue::Now();
 	}
 
 
 	////////////////////////////////////////////////////////////
-	void ParseXInputState(const XINPUT_STATE& xis, Gamepad::State& gps, float deadzone)
+	Gamepad::State GamepadImpl_Win32::GetState(Gamepad::Index index)
 	{
-		float nLX = fmaxf(-1.0f, (float)xis.Gamepad.sThumbLX / 32767.0f);
-		float nLY = fmaxf(-1.0f, (float)xis.Gamepad.sThumbLY / 32767.0f);
-
-		gps.leftStick[0] = (abs(nLX) < deadzone ? 0 : (abs(nLX) - deadzone) * (nLX * abs(nLX)));
-		gps.leftStick[1] = (abs(nLY) < deadzone ? 0 : (abs(nLY) - deadzone) * (nLY * abs(nLY)));
+		XINPUT_STATE xis = { 0 };
+		Gamepad::State result = {};
+		ApplyResponses();
 
-		float nRX = fmaxf(-1.0f, (float)xis.Gamepad.sThumbRX / 32767.0f);
-		float nRY = fmaxf(-1.0f, (float)xis.Gamepad.sThumbRY / 32767.0f);
+		if (Probe(index, xis))
+			Convert(index, xis, result);
 
-		gps.rightStick[0] = (abs(nRX) < deadzone ? 0 : (abs(nRX) - deadzone) * (nRX * abs(nRX)));
-		gps.rightStick[1] = (abs(nRY) < deadzone ? 0 : (abs(nRY) - deadzone) * (nRY * abs(nRY)));
+		return result;
+	}
 
-		gps.leftStick *= 1 / (1 - deadzone);
-		gps.rightStick *= 1 / (1 - deadzone);
 
-		gps.leftTrigger = (float)xis.Gamepad.bLeftTrigger / 255;
-		gps.rightTrigger = (float)xis.Gamepad.bRightTrigger / 255;
+	////////////////////////////////////////////////////////////
+	Gamepad::State GamepadImpl_Win32::GetState(Gamepad::Index index, const GamepadResponse& response)
+	{
+		XINPUT_STATE xis = { 0 };
+		Gamepad::State result = {};
 
-		gps.buttons = xis.Gamepad.wButtons;
+		if (Probe(index, xis))
+			ParseXInputState(xis, result, response);
 
-		gps.connected = true;
+		return result;
 	}
 
 
 	////////////////////////////////////////////////////////////
-	Gamepad::State GamepadImpl_Win32::GetState(Gamepad::Index index)
+	uint32_t GamepadImpl_Win32::GetStates(Gamepad::State* states, size_t count)
 	{
-		XINPUT_STATE xis = { 0 };
-		Gamepad::State result = { 0 };
-
-		if (XInputGetState(static_cast<int>(index), &xis) == ERROR_SUCCESS)
-			ParseXInputState(xis, result);
-	
-		return result;
+		uint32_t connected = 0;
+		ApplyResponses();
+
+		for (DWORD i = 0; i < count && i < XUSER_MAX_COUNT; ++i)
+		{
+			XINPUT_STATE xis = { 0 };
+			states[i] = {};
+
+			if (Probe(static_cast<Gamepad::Index>(i), xis))
+			{
+				Convert(static_cast<Gamepad::Index>(i), xis, states[i]);
+				connected |= 1u << i;
+			}
+		}
+
+		return connected;
 	}
 
 
 	////////////////////////////////////////////////////////////
-	Gamepad::State GamepadImpl_Win32::GetState(Gamepad::Index index, float deadzone)
+	bool GamepadImpl_Win32::Probe(Gamepad::Index index, XINPUT_STATE& xis)
 	{
-		XINPUT_STATE xis = { 0 };
-		Gamepad::State result = { 0 };
+		// XInputGetState on an empty slot is slow enough to show up in a frame, so back off.
+		if (!ShouldProbe(index))
+			return false;
+
+		if (XInputGetState(static_cast<DWORD>(index), &xis) != ERROR_SUCCESS)
+		{
+			ProbeFailed(index);
+			return false;
+		}
+
+		SetConnected(index, true);
+		return true;
+	}
 
-		if (XInputGetState(static_cast<int>(index), &xis) == ERROR_SUCCESS)
-			ParseXInputState(xis, result, deadzone);
 
-		return result;
+	////////////////////////////////////////////////////////////
+	void GamepadImpl_Win32::Convert(Gamepad::Index index, const XINPUT_STATE& xis, Gamepad::State& gps)
+	{
+		// dwPacketNumber only advances when the controller state changes, so an idle pad reuses its last conversion.
+		if (const Gamepad::State* cached = CachedState(index, static_cast<uint32_t>(xis.dwPacketNumber)))
+		{
+			gps = *cached;
+			return;
+		}
+
+		ParseXInputState(xis, gps, m_responses[static_cast<size_t>(index)]);
+
+		// An idle pad keeps the time its report first arrived.
+		gps.timestamp = StampPacket(index, gps.packet);
+		CacheState(index, gps);
 	}
 
 
@@ -0,0 +1,149 @@
+#if defined (_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "decaf/io/mappedfile.hh"
+
+namespace decaf
+{
+
+	////////////////////////////////////////////////////////////
+	MappedFile::MappedFile()
+		: m_data{ nullptr }, m_size{ 0 }
+#if defined (_WIN32)
+		, m_file{ INVALID_HANDLE_VALUE }, m_mapping{ nullptr }
+#endif
+	{ }
+
+
+	////////////////////////////////////////////////////////////
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+
+#if defined (_WIN32)
+
+	////////////////////////////////////////////////////////////
+	bool MappedFile::Open(const char* path)
+	{
+		Close();
+
+		m_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (m_file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+		{
+			Close();
+			return false;
+		}
+
+		m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (m_mapping == nullptr)
+		{
+			Close();
+			return false;
+		}
+
+		m_data = static_cast<const unsigned char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+		if (m_data == nullptr)
+		{
+			Close();
+			return false;
+		}
+
+		m_size = static_cast<size_t>(size.QuadPart);
+		return true;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void MappedFile::Close()
+	{
+		if (m_data != nullptr)
+			UnmapViewOfFile(m_data);
+
+		if (m_mapping != nullptr)
+			CloseHandle(m_mapping);
+
+		if (m_file != INVALID_HANDLE_VALUE)
+			CloseHandle(m_file);
+
+		m_data = nullptr;
+		m_size = 0;
+		m_file = INVALID_HANDLE_VALUE;
+		m_mapping = nullptr;
+	}
+
+#else
+
+	////////////////////////////////////////////////////////////
+	bool MappedFile::Open(const char* path)
+	{
+		Close();
+
+		int fd = open(path, O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+			return false;
+
+		struct stat info;
+		if (fstat(fd, &info) != 0 || info.st_size == 0)
+		{
+			close(fd);
+			return false;
+		}
+
+		void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+
+		if (data == MAP_FAILED)
+			return false;
+
+		m_data = static_cast<const unsigned char*>(data);
+		m_size = static_cast<size_t>(info.st_size);
+		return true;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void MappedFile::Close()
+	{
+		if (m_data != nullptr)
+			munmap(const_cast<unsigned char*>(m_data), m_size);
+
+		m_data = nullptr;
+		m_size = 0;
+	}
+
+#endif
+
+
+	////////////////////////////////////////////////////////////
+	bool MappedFile::IsOpen() const
+	{
+		return m_data != nullptr;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	const unsigned char* MappedFile::Data() const
+	{
+		return m_data;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	size_t MappedFile::Size() const
+	{
+		return m_size;
+	}
+
+}
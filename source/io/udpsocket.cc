@@ -0,0 +1,241 @@
+#include <cstring>
+
+#if defined (_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "decaf/io/udpsocket.hh"
+
+namespace decaf
+{
+
+	namespace
+	{
+
+#if defined (_WIN32)
+		using Handle = SOCKET;
+		using Length = int;
+
+		const uintptr_t Invalid = static_cast<uintptr_t>(INVALID_SOCKET);
+
+		inline bool StartNetwork()
+		{
+			static const bool started = []
+			{
+				WSADATA data;
+				return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+			}();
+
+			return started;
+		}
+
+		inline void CloseSocket(Handle handle)
+		{
+			closesocket(handle);
+		}
+
+		inline bool SetNonBlocking(Handle handle)
+		{
+			u_long enabled = 1;
+			return ioctlsocket(handle, FIONBIO, &enabled) == 0;
+		}
+#else
+		using Handle = int;
+		using Length = socklen_t;
+
+		const int Invalid = -1;
+
+		inline bool StartNetwork()
+		{
+			return true;
+		}
+
+		inline void CloseSocket(Handle handle)
+		{
+			close(handle);
+		}
+
+		inline bool SetNonBlocking(Handle handle)
+		{
+			int flags = fcntl(handle, F_GETFL);
+			return flags >= 0 && fcntl(handle, F_SETFL, flags | O_NONBLOCK) == 0;
+		}
+#endif
+
+		/// <summary>Resolves a host to an IPv4 address in network order.</summary>
+		bool Resolve(const char* host, uint32_t& address)
+		{
+			in_addr numeric;
+
+			if (inet_pton(AF_INET, host, &numeric) == 1)
+			{
+				address = numeric.s_addr;
+				return true;
+			}
+
+			addrinfo hints;
+			memset(&hints, 0, sizeof(hints));
+			hints.ai_family = AF_INET;
+			hints.ai_socktype = SOCK_DGRAM;
+
+			addrinfo* result = nullptr;
+
+			if (getaddrinfo(host, nullptr, &hints, &result) != 0 || result == nullptr)
+				return false;
+
+			address = reinterpret_cast<const sockaddr_in*>(result->ai_addr)->sin_addr.s_addr;
+			freeaddrinfo(result);
+			return true;
+		}
+
+	}
+
+
+	////////////////////////////////////////////////////////////
+	UdpSocket::UdpSocket()
+		: m_socket{ Invalid }, m_peerAddress{ 0 }, m_peerPort{ 0 }, m_hasPeer{ false } { }
+
+
+	////////////////////////////////////////////////////////////
+	UdpSocket::~UdpSocket()
+	{
+		Close();
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool UdpSocket::Open(const char* address, uint16_t port)
+	{
+		Close();
+
+		if (!StartNetwork())
+			return false;
+
+		sockaddr_in local;
+		memset(&local, 0, sizeof(local));
+		local.sin_family = AF_INET;
+		local.sin_port = htons(port);
+		local.sin_addr.s_addr = htonl(INADDR_ANY);
+
+		if (address != nullptr && inet_pton(AF_INET, address, &local.sin_addr) != 1)
+			return false;
+
+		Handle handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+
+		if (handle == static_cast<Handle>(Invalid))
+			return false;
+
+		if (bind(handle, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0 || !SetNonBlocking(handle))
+		{
+			CloseSocket(handle);
+			return false;
+		}
+
+		m_socket = handle;
+		return true;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	void UdpSocket::Close()
+	{
+		if (m_socket != Invalid)
+			CloseSocket(static_cast<Handle>(m_socket));
+
+		m_socket = Invalid;
+		m_hasPeer = false;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool UdpSocket::IsOpen() const
+	{
+		return m_socket != Invalid;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	uint16_t UdpSocket::LocalPort() const
+	{
+		if (m_socket == Invalid)
+			return 0;
+
+		sockaddr_in local;
+		Length length = sizeof(local);
+
+		if (getsockname(static_cast<Handle>(m_socket), reinterpret_cast<sockaddr*>(&local), &length) != 0)
+			return 0;
+
+		return ntohs(local.sin_port);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool UdpSocket::SetPeer(const char* host, uint16_t port)
+	{
+		if (!StartNetwork() || !Resolve(host, m_peerAddress))
+			return false;
+
+		m_peerPort = htons(port);
+		m_hasPeer = true;
+		return true;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool UdpSocket::HasPeer() const
+	{
+		return m_hasPeer;
+	}
+
+
+	////////////////////////////////////////////////////////////
+	bool UdpSocket::Send(const void* data, size_t size)
+	{
+		if (m_socket == Invalid || !m_hasPeer)
+			return false;
+
+		sockaddr_in peer;
+		memset(&peer, 0, sizeof(peer));
+		peer.sin_family = AF_INET;
+		peer.sin_port = m_peerPort;
+		peer.sin_addr.s_addr = m_peerAddress;
+
+		auto sent = sendto(static_cast<Handle>(m_socket), static_cast<const char*>(data), static_cast<int>(size), 0, reinterpret_cast<const sockaddr*>(&peer), sizeof(peer));
+		return sent == static_cast<decltype(sent)>(size);
+	}
+
+
+	////////////////////////////////////////////////////////////
+	int UdpSocket::Receive(void* data, size_t capacity)
+	{
+		if (m_socket == Invalid)
+			return -1;
+
+		sockaddr_in from;
+		Length length = sizeof(from);
+
+		auto received = recvfrom(static_cast<Handle>(m_socket), static_cast<char*>(data), static_cast<int>(capacity), 0, reinterpret_cast<sockaddr*>(&from), &length);
+
+		if (received < 0)
+			return -1;
+
+		if (!m_hasPeer)
+		{
+			m_peerAddress = from.sin_addr.s_addr;
+			m_peerPort = from.sin_port;
+			m_hasPeer = true;
+		}
+
+		return static_cast<int>(received);
+	}
+
+}
@@ -0,0 +1,56 @@
+#if defined (_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "decaf/system/cpufeatures.hh"
+
+namespace decaf
+{
+
+	namespace
+	{
+
+		CpuFeatures Detect()
+		{
+			CpuFeatures features = { false, false, false, false };
+
+#if defined (DECAF_ARCH_X86) && defined (_MSC_VER)
+			int info[4];
+			__cpuid(info, 0);
+			int maxLeaf = info[0];
+
+			__cpuid(info, 1);
+			features.sse2 = (info[3] & (1 << 26)) != 0;
+			features.sse41 = (info[2] & (1 << 19)) != 0;
+
+			// AVX state must also be enabled by the OS (OSXSAVE + XCR0 bits 1 and 2).
+			bool osAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+			features.fma = osAvx && (info[2] & (1 << 12)) != 0;
+
+			if (maxLeaf >= 7)
+			{
+				__cpuidex(info, 7, 0);
+				features.avx2 = osAvx && (info[1] & (1 << 5)) != 0;
+			}
+#elif defined (DECAF_ARCH_X86)
+			__builtin_cpu_init();
+			features.sse2 = __builtin_cpu_supports("sse2");
+			features.sse41 = __builtin_cpu_supports("sse4.1");
+			features.avx2 = __builtin_cpu_supports("avx2");
+			features.fma = __builtin_cpu_supports("fma");
+#endif
+
+			return features;
+		}
+
+	}
+
+
+	////////////////////////////////////////////////////////////
+	const CpuFeatures& CpuFeatures::Get()
+	{
+		static const CpuFeatures features = Detect();
+		return features;
+	}
+
+}
@@ -0,0 +1,182 @@
+#include "decaf/input/actionmap.hh"
+#include "decaf/input/gamepad.hh"
+
+#include "test.hh"
+
+using namespace decaf;
+
+namespace
+{
+
+	Gamepad::State Holding(uint16_t buttons)
+	{
+		Gamepad::State state = {};
+		state.buttons = buttons;
+		state.connected = true;
+		return state;
+	}
+
+	inline uint16_t Bit(Gamepad::Button button)
+	{
+		return static_cast<uint16_t>(button);
+	}
+
+	/// <summary>Evaluates one frame moving from <paramref name='was'/> to <paramref name='now'/>.</summary>
+	ActionFrame Step(ActionMap& map, uint16_t was, uint16_t now)
+	{
+		ActionFrame frame;
+		map.Evaluate(Holding(now), Holding(was), frame);
+		return frame;
+	}
+
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(HigherLayersShadowTheActionsTheyBind)
+{
+	ActionMap map;
+	ActionMap::ActionId jump = map.DefineAction("jump");
+	ActionMap::ActionId fire = map.DefineAction("fire");
+
+	ActionMap::LayerId onFoot = map.AddLayer("on foot", 0);
+	ActionMap::LayerId vehicle = map.AddLayer("vehicle", 10);
+	map.Bind(onFoot, jump, ActionBinding::Button(Gamepad::Button::A));
+	map.Bind(onFoot, fire, ActionBinding::Button(Gamepad::Button::X));
+	map.Bind(vehicle, jump, ActionBinding::Button(Gamepad::Button::B));
+	map.EnableLayer(onFoot, true);
+
+	CHECK(Step(map, 0, Bit(Gamepad::Button::A)).WasPressed(jump));
+	CHECK(!Step(map, 0, Bit(Gamepad::Button::B)).IsDown(jump));
+
+	// The vehicle binds jump, so the on-foot binding is hidden even while B is up; fire is not bound there and falls through.
+	map.EnableLayer(vehicle, true);
+	CHECK(!Step(map, 0, Bit(Gamepad::Button::A)).IsDown(jump));
+	CHECK(Step(map, 0, Bit(Gamepad::Button::B)).WasPressed(jump));
+	CHECK(Step(map, 0, Bit(Gamepad::Button::X)).WasPressed(fire));
+
+	map.EnableLayer(vehicle, false);
+	CHECK(Step(map, 0, Bit(Gamepad::Button::A)).IsDown(jump));
+	CHECK(!Step(map, 0, Bit(Gamepad::Button::B)).IsDown(jump));
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(OpaqueLayersHideEverythingBelow)
+{
+	ActionMap map;
+	ActionMap::ActionId fire = map.DefineAction("fire");
+	ActionMap::ActionId confirm = map.DefineAction("confirm");
+
+	ActionMap::LayerId game = map.AddLayer("game", 0);
+	ActionMap::LayerId menu = map.AddLayer("menu", 100, true);
+	map.Bind(game, fire, ActionBinding::Button(Gamepad::Button::X));
+	map.Bind(menu, confirm, ActionBinding::Button(Gamepad::Button::A));
+	map.EnableLayer(game, true);
+	map.EnableLayer(menu, true);
+
+	ActionFrame frame = Step(map, 0, Bit(Gamepad::Button::X) | Bit(Gamepad::Button::A));
+	CHECK(frame.IsDown(confirm));
+	CHECK(!frame.IsDown(fire));
+
+	map.EnableLayer(menu, false);
+	frame = Step(map, 0, Bit(Gamepad::Button::X) | Bit(Gamepad::Button::A));
+	CHECK(frame.IsDown(fire));
+	CHECK(!frame.IsDown(confirm));
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(EqualPrioritiesKeepTheirCreationOrder)
+{
+	ActionMap map;
+	ActionMap::ActionId use = map.DefineAction("use");
+
+	ActionMap::LayerId first = map.AddLayer("first", 5);
+	ActionMap::LayerId second = map.AddLayer("second", 5);
+	map.Bind(first, use, ActionBinding::Button(Gamepad::Button::Y));
+	map.Bind(second, use, ActionBinding::Button(Gamepad::Button::B));
+	map.EnableLayer(first, true);
+	map.EnableLayer(second, true);
+
+	CHECK(Step(map, 0, Bit(Gamepad::Button::Y)).IsDown(use));
+	CHECK(!Step(map, 0, Bit(Gamepad::Button::B)).IsDown(use));
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(UnbindingStopsShadowingAndRecompilesOneLayer)
+{
+	ActionMap map;
+	ActionMap::ActionId jump = map.DefineAction("jump");
+
+	ActionMap::LayerId base = map.AddLayer("base", 0);
+	ActionMap::LayerId top = map.AddLayer("top", 1);
+	map.Bind(base, jump, ActionBinding::Button(Gamepad::Button::A));
+	map.Bind(top, jump, ActionBinding::Button(Gamepad::Button::B));
+	map.EnableLayer(base, true);
+	map.EnableLayer(top, true);
+
+	CHECK(!Step(map, 0, Bit(Gamepad::Button::A)).IsDown(jump));
+
+	uint64_t compiles = map.CompileCount();
+	map.Unbind(top, jump);
+	CHECK(Step(map, 0, Bit(Gamepad::Button::A)).IsDown(jump));
+	CHECK(map.CompileCount() == compiles + 1);
+
+	// Rebinding shadows again, with the new binding.
+	map.Rebind(top, jump, ActionBinding::Button(Gamepad::Button::Y));
+	CHECK(!Step(map, 0, Bit(Gamepad::Button::A)).IsDown(jump));
+	CHECK(Step(map, 0, Bit(Gamepad::Button::Y)).IsDown(jump));
+	CHECK(map.CompileCount() == compiles + 2);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(ModifiersAndExclusionsSplitAChord)
+{
+	ActionMap map;
+	ActionMap::ActionId attack = map.DefineAction("attack");
+	ActionMap::ActionId special = map.DefineAction("special");
+
+	ActionMap::LayerId base = map.AddLayer("base", 0);
+	ActionMap::LayerId modified = map.AddLayer("modified", 1);
+	map.Bind(base, attack, ActionBinding::Button(Gamepad::Button::X).Without(Gamepad::Button::RSHOULDER));
+	map.Bind(modified, special, ActionBinding::Button(Gamepad::Button::X).With(Gamepad::Button::RSHOULDER));
+	map.EnableLayer(base, true);
+	map.EnableLayer(modified, true);
+
+	ActionFrame plain = Step(map, 0, Bit(Gamepad::Button::X));
+	CHECK(plain.IsDown(attack) && !plain.IsDown(special));
+
+	ActionFrame chord = Step(map, Bit(Gamepad::Button::X), Bit(Gamepad::Button::X) | Bit(Gamepad::Button::RSHOULDER));
+	CHECK(chord.IsDown(special) && chord.WasPressed(special));
+	CHECK(!chord.IsDown(attack) && chord.WasReleased(attack));
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(AxisBindingsFollowTheirThresholdSign)
+{
+	ActionMap map;
+	ActionMap::ActionId left = map.DefineAction("left");
+	ActionMap::ActionId right = map.DefineAction("right");
+
+	ActionMap::LayerId layer = map.AddLayer("move", 0);
+	map.Bind(layer, left, ActionBinding::Axis(Gamepad::Axis::LSTICK_X, -0.5f));
+	map.Bind(layer, right, ActionBinding::Axis(Gamepad::Axis::LSTICK_X, 0.5f));
+	map.EnableLayer(layer, true);
+
+	Gamepad::State previous = Holding(0);
+	Gamepad::State current = Holding(0);
+	ActionFrame frame;
+
+	current.leftStick = Vector2f(-0.75f, 0.0f);
+	map.Evaluate(current, previous, frame);
+	CHECK(frame.WasPressed(left) && !frame.IsDown(right));
+
+	previous = current;
+	current.leftStick = Vector2f(0.5f, 0.0f);
+	map.Evaluate(current, previous, frame);
+	CHECK(frame.WasReleased(left) && frame.WasPressed(right));
+}
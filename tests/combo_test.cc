@@ -0,0 +1,202 @@
+#include <vector>
+
+#include "decaf/input/combo.hh"
+#include "decaf/input/gamepad.hh"
+
+#include "test.hh"
+
+using namespace decaf;
+
+namespace
+{
+
+	constexpr uint64_t Millisecond = 1000000;
+
+	constexpr uint16_t Down = static_cast<uint16_t>(Gamepad::Button::DPAD_DOWN);
+	constexpr uint16_t Left = static_cast<uint16_t>(Gamepad::Button::DPAD_LEFT);
+	constexpr uint16_t Right = static_cast<uint16_t>(Gamepad::Button::DPAD_RIGHT);
+	constexpr uint16_t A = static_cast<uint16_t>(Gamepad::Button::A);
+	constexpr uint16_t B = static_cast<uint16_t>(Gamepad::Button::B);
+	constexpr uint16_t X = static_cast<uint16_t>(Gamepad::Button::X);
+
+	/// <summary>Feeds a sample holding <paramref name='buttons'/> at <paramref name='ms'/> milliseconds and collects what it completes.</summary>
+	std::vector<ComboRecognizer::PatternId> Feed(ComboRecognizer& recognizer, ComboRecognizer::Cursor& cursor, uint16_t buttons, uint64_t ms)
+	{
+		Gamepad::State state = {};
+		state.buttons = buttons;
+		state.connected = true;
+		state.timestamp = ms * Millisecond;
+
+		ComboRecognizer::Match matches[8];
+		size_t count = recognizer.Advance(cursor, state, matches, 8);
+
+		std::vector<ComboRecognizer::PatternId> patterns;
+
+		for (size_t i = 0; i < count && i < 8; ++i)
+		{
+			CHECK(matches[i].timestamp == state.timestamp);
+			patterns.push_back(matches[i].pattern);
+		}
+
+		return patterns;
+	}
+
+	/// <summary>Plays a quarter-circle forward and punch, each step <paramref name='gap'/> milliseconds after the previous one.</summary>
+	std::vector<ComboRecognizer::PatternId> QuarterCircle(ComboRecognizer& recognizer, uint64_t gap)
+	{
+		ComboRecognizer::Cursor cursor;
+		ComboRecognizer::Reset(cursor);
+
+		Feed(recognizer, cursor, Down, 1000);
+		Feed(recognizer, cursor, Down | Right, 1000 + gap);
+		Feed(recognizer, cursor, Right, 1000 + 2 * gap);
+		return Feed(recognizer, cursor, Right | X, 1000 + 3 * gap);
+	}
+
+	ComboRecognizer::PatternId AddQuarterCircle(ComboRecognizer& recognizer, uint64_t window)
+	{
+		return recognizer.AddPattern("fireball", {
+			ComboStep::Direction(2),
+			ComboStep::Direction(3, window),
+			ComboStep::Direction(6, window),
+			ComboStep::Press(Gamepad::Button::X, window)
+		});
+	}
+
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(StepsMustStartWithinTheirWindow)
+{
+	ComboRecognizer recognizer;
+	ComboRecognizer::PatternId fireball = AddQuarterCircle(recognizer, 100 * Millisecond);
+
+	std::vector<ComboRecognizer::PatternId> quick = QuarterCircle(recognizer, 30);
+	CHECK(quick.size() == 1 && quick[0] == fireball);
+
+	// The window is inclusive.
+	CHECK(QuarterCircle(recognizer, 100).size() == 1);
+	CHECK(QuarterCircle(recognizer, 101).empty());
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(OneLateStepBreaksTheCombo)
+{
+	ComboRecognizer recognizer;
+	AddQuarterCircle(recognizer, 100 * Millisecond);
+
+	ComboRecognizer::Cursor cursor;
+	ComboRecognizer::Reset(cursor);
+
+	Feed(recognizer, cursor, Down, 0);
+	Feed(recognizer, cursor, Down | Right, 50);
+	Feed(recognizer, cursor, Right, 200);
+	CHECK(Feed(recognizer, cursor, Right | X, 250).empty());
+
+	// Starting over right away still works: a late step does not poison the cursor.
+	Feed(recognizer, cursor, 0, 260);
+	Feed(recognizer, cursor, Down, 270);
+	Feed(recognizer, cursor, Down | Right, 280);
+	Feed(recognizer, cursor, Right, 290);
+	CHECK(Feed(recognizer, cursor, Right | X, 300).size() == 1);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(ChargeStepsMustBeHeldLongEnough)
+{
+	ComboRecognizer recognizer;
+	ComboRecognizer::PatternId charge = recognizer.AddPattern("sonic", {
+		ComboStep::Direction(4, 0, 800 * Millisecond),
+		ComboStep::Direction(6, 1000 * Millisecond),
+		ComboStep::Press(Gamepad::Button::X, 100 * Millisecond)
+	});
+
+	ComboRecognizer::Cursor cursor;
+	ComboRecognizer::Reset(cursor);
+
+	Feed(recognizer, cursor, Left, 0);
+	Feed(recognizer, cursor, Right, 500);
+	CHECK(Feed(recognizer, cursor, Right | X, 550).empty());
+
+	Feed(recognizer, cursor, 0, 600);
+	Feed(recognizer, cursor, Left, 700);
+	Feed(recognizer, cursor, Right, 1500);
+	std::vector<ComboRecognizer::PatternId> matched = Feed(recognizer, cursor, Right | X, 1550);
+	CHECK(matched.size() == 1 && matched[0] == charge);
+
+	// Holding longer than the next step's window is too slow as well.
+	Feed(recognizer, cursor, 0, 1600);
+	Feed(recognizer, cursor, Left, 1700);
+	Feed(recognizer, cursor, Right, 2800);
+	CHECK(Feed(recognizer, cursor, Right | X, 2850).empty());
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(DoubleTapsNeedAReleaseWithinTheWindow)
+{
+	ComboRecognizer recognizer;
+	recognizer.AddPattern("dash", { ComboStep::Press(Gamepad::Button::A), ComboStep::Press(Gamepad::Button::A, 200 * Millisecond) });
+
+	ComboRecognizer::Cursor cursor;
+	ComboRecognizer::Reset(cursor);
+
+	// Holding the button is one press, however long.
+	Feed(recognizer, cursor, A, 0);
+	CHECK(Feed(recognizer, cursor, A, 100).empty());
+
+	Feed(recognizer, cursor, 0, 150);
+	CHECK(Feed(recognizer, cursor, A, 180).size() == 1);
+
+	Feed(recognizer, cursor, 0, 1000);
+	Feed(recognizer, cursor, A, 1300);
+	Feed(recognizer, cursor, 0, 1400);
+	CHECK(Feed(recognizer, cursor, A, 1600).empty());
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(ChordsAcceptAnyOrderWithinTheChordWindow)
+{
+	ComboRecognizer recognizer(50 * Millisecond);
+	ComboRecognizer::PatternId throwing = recognizer.AddPattern("throw", { ComboStep::Chord(A | B) });
+
+	ComboRecognizer::Cursor cursor;
+	ComboRecognizer::Reset(cursor);
+
+	std::vector<ComboRecognizer::PatternId> together = Feed(recognizer, cursor, A | B, 0);
+	CHECK(together.size() == 1 && together[0] == throwing);
+
+	Feed(recognizer, cursor, 0, 100);
+	Feed(recognizer, cursor, B, 200);
+	CHECK(Feed(recognizer, cursor, A | B, 250).size() == 1);
+
+	Feed(recognizer, cursor, 0, 300);
+	Feed(recognizer, cursor, A, 400);
+	CHECK(Feed(recognizer, cursor, A | B, 451).empty());
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(OverlappingPatternsAreTimedSeparately)
+{
+	ComboRecognizer recognizer;
+	ComboRecognizer::PatternId slow = recognizer.AddPattern("slow", { ComboStep::Direction(6), ComboStep::Press(Gamepad::Button::X, 500 * Millisecond) });
+	ComboRecognizer::PatternId fast = recognizer.AddPattern("fast", { ComboStep::Direction(2), ComboStep::Direction(6, 50 * Millisecond), ComboStep::Press(Gamepad::Button::X, 50 * Millisecond) });
+
+	ComboRecognizer::Cursor cursor;
+	ComboRecognizer::Reset(cursor);
+
+	Feed(recognizer, cursor, Down, 0);
+	Feed(recognizer, cursor, Right, 40);
+	std::vector<ComboRecognizer::PatternId> both = Feed(recognizer, cursor, Right | X, 80);
+	CHECK(both.size() == 2 && (both[0] == slow || both[1] == slow) && (both[0] == fast || both[1] == fast));
+
+	Feed(recognizer, cursor, Down, 1000);
+	Feed(recognizer, cursor, Right, 1040);
+	std::vector<ComboRecognizer::PatternId> one = Feed(recognizer, cursor, Right | X, 1300);
+	CHECK(one.size() == 1 && one[0] == slow);
+}
@@ -0,0 +1,121 @@
+#include <cmath>
+
+#include "decaf/input/deadzone.hh"
+#include "decaf/input/gamepad.hh"
+#include "decaf/input/gamepadcontext.hh"
+#include "decaf/input/gamepadimpl.hh"
+#include "decaf/input/mock/gamepadimpl_mock.hh"
+#include "decaf/input/response.hh"
+
+#include "test.hh"
+
+using namespace decaf;
+
+namespace
+{
+
+	float Magnitude(float length, float angle, const DeadzoneSettings& settings)
+	{
+		Vector2f stick(length * cosf(angle), length * sinf(angle));
+		return Deadzone::Apply(stick, settings).Length();
+	}
+
+	/// <summary>The largest jump in output magnitude between neighbouring inputs along a ray from the centre.</summary>
+	float LargestStep(const DeadzoneSettings& settings, float from)
+	{
+		float largest = 0.0f;
+		float previous = Magnitude(from, 0.7f, settings);
+
+		for (float length = from + 0.001f; length <= 1.0f; length += 0.001f)
+		{
+			float current = Magnitude(length, 0.7f, settings);
+			largest = fmaxf(largest, fabsf(current - previous));
+			previous = current;
+		}
+
+		return largest;
+	}
+
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(CentredSticksStayZeroWithNoInnerDeadzone)
+{
+	for (DeadzoneSettings::Mode mode : { DeadzoneSettings::Mode::AXIAL, DeadzoneSettings::Mode::RADIAL, DeadzoneSettings::Mode::SCALED_RADIAL, DeadzoneSettings::Mode::HYBRID })
+	{
+		Vector2f result = Deadzone::Apply(Vector2f(0.0f), { mode, 0.0f, 1.0f });
+
+		CHECK(result[0] == 0.0f);
+		CHECK(result[1] == 0.0f);
+	}
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(RadialHoldsItsMagnitudeAtTheOuterEdge)
+{
+	DeadzoneSettings settings = { DeadzoneSettings::Mode::RADIAL, 0.2f, 0.9f };
+
+	CHECK_NEAR(Magnitude(0.5f, 0.3f, settings), 0.5f, 1e-6f);
+	CHECK_NEAR(Magnitude(0.95f, 0.3f, settings), 0.9f, 1e-6f);
+	CHECK_NEAR(Magnitude(1.0f, 0.3f, settings), 0.9f, 1e-6f);
+	CHECK(LargestStep(settings, 0.25f) < 0.002f);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(ScaledRadialIsContinuousAndReachesFullDeflection)
+{
+	DeadzoneSettings settings = { DeadzoneSettings::Mode::SCALED_RADIAL, 0.2f, 0.9f };
+
+	CHECK(Magnitude(0.2f, 0.3f, settings) == 0.0f);
+	CHECK_NEAR(Magnitude(0.9f, 0.3f, settings), 1.0f, 1e-5f);
+	CHECK_NEAR(Magnitude(1.0f, 0.3f, settings), 1.0f, 1e-5f);
+	CHECK(LargestStep(settings, 0.0f) < 0.002f);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(ResponseForSwapsOnlyBuiltInCurves)
+{
+	GamepadSettings radial = {};
+	radial.leftStick = { DeadzoneSettings::Mode::RADIAL, 0.2f, 1.0f };
+	radial.rightStick = { DeadzoneSettings::Mode::RADIAL, 0.2f, 1.0f };
+
+	GamepadResponse linear = GamepadContextBase::ResponseFor(GamepadResponse::XInput(), radial);
+	CHECK(linear.leftStick.Table() == StickResponse::Linear().Table());
+	CHECK(linear.rightStick.Table() == StickResponse::Linear().Table());
+
+	GamepadResponse xinput = GamepadContextBase::ResponseFor(linear, GamepadSettings());
+	CHECK(xinput.leftStick.Table() == StickResponse::XInputLeft().Table());
+	CHECK(xinput.rightStick.Table() == StickResponse::XInputRight().Table());
+
+	StickResponse custom({ AxisCurve::Shape::POWER, 0.0f, 1.0f, 2.0f }, true, false);
+	GamepadResponse response = { custom, custom, TriggerResponse(), TriggerResponse() };
+
+	CHECK(GamepadContextBase::ResponseFor(response, radial).leftStick.Table() == custom.Table());
+	CHECK(GamepadContextBase::ResponseFor(response, GamepadSettings()).rightStick.Table() == custom.Table());
+	CHECK(GamepadContextBase::ResponseFor(response, radial).leftStick.InvertX());
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(SetSettingsKeepsACustomCurve)
+{
+	GamepadImpl_Mock mock;
+	IGamepadImpl::SetInstance(&mock);
+
+	StickResponse custom({ AxisCurve::Shape::POWER, 0.0f, 1.0f, 2.0f });
+	Gamepad::SetResponse(Gamepad::Index::TWO, { custom, custom, TriggerResponse(), TriggerResponse() });
+
+	GamepadSettings settings = {};
+	settings.leftStick = { DeadzoneSettings::Mode::SCALED_RADIAL, 0.1f, 1.0f };
+	settings.rightStick = { DeadzoneSettings::Mode::SCALED_RADIAL, 0.1f, 1.0f };
+	Gamepad::SetSettings(Gamepad::Index::TWO, settings);
+
+	CHECK(mock.GetResponse(Gamepad::Index::TWO).leftStick.Table() == custom.Table());
+
+	Gamepad::SetSettings(Gamepad::Index::TWO, GamepadSettings());
+	IGamepadImpl::SetInstance(nullptr);
+}
@@ -0,0 +1,215 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "decaf/input/deadzone.hh"
+#include "decaf/input/gamepad.hh"
+#include "decaf/input/gamepadimpl.hh"
+#include "decaf/input/mock/gamepadimpl_mock.hh"
+
+#include "test.hh"
+
+using namespace decaf;
+
+namespace
+{
+
+	struct Script
+	{
+		std::atomic<uint16_t> buttons{ 0 };
+		std::atomic<int16_t> thumbLX{ 0 };
+	};
+
+	GamepadImpl_Mock::RawState Scripted(Gamepad::Index, uint64_t, void* context)
+	{
+		const Script& script = *static_cast<const Script*>(context);
+		GamepadImpl_Mock::RawState raw = {};
+
+		raw.buttons = script.buttons.load(std::memory_order_relaxed);
+		raw.thumbLX = script.thumbLX.load(std::memory_order_relaxed);
+		raw.connected = true;
+
+		return raw;
+	}
+
+	/// <summary>Lets the sampler publish a few updates of the current script.</summary>
+	void Settle()
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	}
+
+	void Set(GamepadImpl_Mock& mock, uint16_t buttons, int16_t thumbLX = 0)
+	{
+		GamepadImpl_Mock::RawState raw = {};
+		raw.buttons = buttons;
+		raw.thumbLX = thumbLX;
+		raw.connected = true;
+		mock.SetRawState(Gamepad::Index::ONE, raw);
+	}
+
+	bool HasCrossing(const Gamepad& pad, Gamepad::Axis axis, int8_t zone)
+	{
+		for (size_t i = 0; i < pad.EventCount(); ++i)
+		{
+			const Gamepad::Event& event = pad.GetEvent(i);
+
+			if (event.type == Gamepad::EventType::AXIS_CROSSED && event.code == static_cast<uint16_t>(axis) && event.zone == zone)
+				return true;
+		}
+
+		return false;
+	}
+
+	constexpr uint16_t ButtonA = static_cast<uint16_t>(Gamepad::Button::A);
+
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(PadsSharingAnIndexEachSeeEveryEvent)
+{
+	GamepadImpl_Mock mock;
+	IGamepadImpl::SetInstance(&mock);
+	Set(mock, 0);
+
+	Gamepad first(Gamepad::Index::ONE);
+	Gamepad second(Gamepad::Index::ONE);
+	first.Poll();
+	second.Poll();
+
+	Set(mock, ButtonA);
+	first.Poll();
+	second.Poll();
+	CHECK(first.WasButtonPressed(Gamepad::Button::A));
+	CHECK(second.WasButtonPressed(Gamepad::Button::A));
+
+	Set(mock, 0);
+	first.Poll();
+	second.Poll();
+	CHECK(first.WasButtonReleased(Gamepad::Button::A));
+	CHECK(second.WasButtonReleased(Gamepad::Button::A));
+	CHECK(first.EventCount() == 1);
+	CHECK(second.EventCount() == 1);
+
+	IGamepadImpl::SetInstance(nullptr);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(PadsSharingAnIndexEachSeeEveryEventWhileSampling)
+{
+	GamepadImpl_Mock mock;
+	Script script;
+	mock.SetGenerator(&Scripted, &script);
+	IGamepadImpl::SetInstance(&mock);
+	CHECK(Gamepad::StartSampling(std::chrono::milliseconds(1)));
+
+	Gamepad first(Gamepad::Index::ONE);
+	Gamepad second(Gamepad::Index::ONE);
+	Settle();
+	first.Poll();
+	second.Poll();
+
+	script.buttons = ButtonA;
+	Settle();
+	first.Poll();
+	CHECK(first.WasButtonPressed(Gamepad::Button::A));
+
+	script.buttons = 0;
+	Settle();
+	first.Poll();
+	second.Poll();
+	CHECK(first.WasButtonReleased(Gamepad::Button::A));
+	CHECK(second.WasButtonPressed(Gamepad::Button::A));
+	CHECK(second.WasButtonReleased(Gamepad::Button::A));
+
+	Gamepad::StopSampling();
+	IGamepadImpl::SetInstance(nullptr);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(NewPadsSeeNoEventsFromBeforeThem)
+{
+	GamepadImpl_Mock mock;
+	Script script;
+	mock.SetGenerator(&Scripted, &script);
+	IGamepadImpl::SetInstance(&mock);
+	CHECK(Gamepad::StartSampling(std::chrono::milliseconds(1)));
+
+	// Nothing polls pad one while it is pressed and released.
+	for (int i = 0; i < 4; ++i)
+	{
+		script.buttons = ButtonA;
+		Settle();
+		script.buttons = 0;
+		Settle();
+	}
+
+	Gamepad late(Gamepad::Index::ONE);
+	late.Poll();
+	CHECK(late.EventCount() == 0);
+	CHECK(!late.WasButtonPressed(Gamepad::Button::A));
+
+	script.buttons = ButtonA;
+	Settle();
+	late.Poll();
+	CHECK(late.EventCount() == 1);
+	CHECK(late.WasButtonPressed(Gamepad::Button::A));
+
+	late.Clear();
+	script.buttons = 0;
+	Settle();
+	late.Clear();
+	late.Poll();
+	CHECK(late.EventCount() == 0);
+	CHECK(late.DroppedEvents() == 0);
+
+	Gamepad::StopSampling();
+	IGamepadImpl::SetInstance(nullptr);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(AxisEventsIgnoreDeadzonesWithOrWithoutSampling)
+{
+	GamepadImpl_Mock mock;
+	Script script;
+	IGamepadImpl::SetInstance(&mock);
+
+	// 0.55 crosses the default 0.5 threshold, but is dead after a 0.6 radial deadzone.
+	GamepadSettings settings = {};
+	settings.leftStick = { DeadzoneSettings::Mode::SCALED_RADIAL, 0.6f, 1.0f };
+	settings.rightStick = { DeadzoneSettings::Mode::SCALED_RADIAL, 0.6f, 1.0f };
+	Gamepad::SetSettings(Gamepad::Index::ONE, settings);
+
+	const int16_t live = static_cast<int16_t>(0.55f * 32767.0f);
+
+	Gamepad polled(Gamepad::Index::ONE);
+	Set(mock, 0);
+	polled.Poll();
+	Set(mock, 0, live);
+	polled.Poll();
+	CHECK(polled.LeftStick()[0] == 0.0f);
+	CHECK(HasCrossing(polled, Gamepad::Axis::LSTICK_X, 1));
+
+	Set(mock, 0);
+	polled.Poll();
+	CHECK(HasCrossing(polled, Gamepad::Axis::LSTICK_X, 0));
+
+	mock.SetGenerator(&Scripted, &script);
+	CHECK(Gamepad::StartSampling(std::chrono::milliseconds(1)));
+
+	Gamepad sampled(Gamepad::Index::ONE);
+	Settle();
+	sampled.Poll();
+	script.thumbLX = live;
+	Settle();
+	sampled.Poll();
+	CHECK(sampled.LeftStick()[0] == 0.0f);
+	CHECK(HasCrossing(sampled, Gamepad::Axis::LSTICK_X, 1));
+
+	Gamepad::StopSampling();
+	Gamepad::SetSettings(Gamepad::Index::ONE, GamepadSettings());
+	IGamepadImpl::SetInstance(nullptr);
+}
@@ -0,0 +1,372 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "decaf/input/deadzone.hh"
+#include "decaf/input/gamepad.hh"
+#include "decaf/input/gamepadevents.hh"
+#include "decaf/input/gamepadimpl.hh"
+#include "decaf/input/mock/gamepadimpl_mock.hh"
+#include "decaf/input/response.hh"
+
+#if defined(__linux__)
+#include <linux/input.h>
+#include <unistd.h>
+
+#include "decaf/input/linux/gamepadimpl_linux.hh"
+#endif
+
+#include "test.hh"
+
+using namespace decaf;
+
+namespace
+{
+
+	/// <summary>A mock that flags reads of its devices, or of states through caller-supplied curves, from any thread but the one updating it.</summary>
+	class OwnedMock : public GamepadImpl_Mock
+	{
+
+	public:
+
+		OwnedMock()
+			: m_foreign{ 0 } { }
+
+		virtual void Update()
+		{
+			m_owner.store(std::this_thread::get_id(), std::memory_order_relaxed);
+			GamepadImpl_Mock::Update();
+		}
+
+		using GamepadImpl_Mock::GetState;
+
+		virtual Gamepad::State GetState(Gamepad::Index index, const GamepadResponse& response)
+		{
+			Check();
+			return GamepadImpl_Mock::GetState(index, response);
+		}
+
+		virtual size_t DeviceCount() const
+		{
+			Check();
+			return GamepadImpl_Mock::DeviceCount();
+		}
+
+		virtual size_t GetDevices(Gamepad::DeviceId* ids, Gamepad::State* states, size_t capacity)
+		{
+			Check();
+			return GamepadImpl_Mock::GetDevices(ids, states, capacity);
+		}
+
+		inline uint32_t Foreign() const { return m_foreign.load(std::memory_order_relaxed); }
+
+	private:
+
+		void Check() const
+		{
+			if (std::this_thread::get_id() != m_owner.load(std::memory_order_relaxed))
+				m_foreign.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		std::atomic<std::thread::id> m_owner;
+		mutable std::atomic<uint32_t> m_foreign;
+
+	};
+
+	/// <summary>Connects and disconnects each pad at its own rate, marking its readings with its index so states can be matched to device IDs.</summary>
+	GamepadImpl_Mock::RawState Churning(Gamepad::Index index, uint64_t update, void*)
+	{
+		size_t slot = static_cast<size_t>(index);
+
+		GamepadImpl_Mock::RawState raw = {};
+		raw.buttons = static_cast<uint16_t>(1u << slot);
+		raw.connected = ((update >> slot) & 1) != 0;
+		return raw;
+	}
+
+	/// <summary>Holds every pad still with both sticks pushed part way, so conversions through different curves differ.</summary>
+	GamepadImpl_Mock::RawState Steady(Gamepad::Index, uint64_t, void*)
+	{
+		GamepadImpl_Mock::RawState raw = {};
+		raw.thumbLX = 12000;
+		raw.thumbLY = -9000;
+		raw.thumbRX = 5000;
+		raw.leftTrigger = 100;
+		raw.connected = true;
+		return raw;
+	}
+
+}
+
+#if defined(__linux__)
+namespace
+{
+
+	/// <summary>Writes one evdev report moving the left stick's X axis to <paramref name='value'/>.</summary>
+	void WriteStickReport(int fd, int32_t value)
+	{
+		input_event events[2] = {};
+		events[0].type = EV_ABS;
+		events[0].code = ABS_X;
+		events[0].value = value;
+		events[1].type = EV_SYN;
+		events[1].code = SYN_REPORT;
+
+		CHECK(write(fd, events, sizeof(events)) == static_cast<ssize_t>(sizeof(events)));
+	}
+
+	/// <summary>Writes a press of the south button and its release as two evdev reports.</summary>
+	void WriteTap(int fd)
+	{
+		input_event events[4] = {};
+		events[0].type = EV_KEY;
+		events[0].code = BTN_SOUTH;
+		events[0].value = 1;
+		events[1].type = EV_SYN;
+		events[1].code = SYN_REPORT;
+		events[2].type = EV_KEY;
+		events[2].code = BTN_SOUTH;
+		events[2].value = 0;
+		events[3].type = EV_SYN;
+		events[3].code = SYN_REPORT;
+
+		CHECK(write(fd, events, sizeof(events)) == static_cast<ssize_t>(sizeof(events)));
+	}
+
+	/// <summary>Whether <paramref name='events'/> hold a press of A followed by its release.</summary>
+	template <typename GetEvent>
+	bool HasTap(size_t count, GetEvent event)
+	{
+		constexpr uint16_t A = static_cast<uint16_t>(Gamepad::Button::A);
+		bool pressed = false;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Gamepad::Event& e = event(i);
+
+			if (e.code == A && e.type == Gamepad::EventType::BUTTON_DOWN)
+				pressed = true;
+			else if (e.code == A && e.type == Gamepad::EventType::BUTTON_UP && pressed)
+				return true;
+		}
+
+		return false;
+	}
+
+}
+#endif
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(RepeatedPacketsConvertToTheSameState)
+{
+	GamepadImpl_Mock mock;
+	GamepadImpl_Mock::RawState raw = {};
+	raw.thumbLX = 20000;
+	raw.leftTrigger = 200;
+	raw.connected = true;
+	mock.SetRawState(Gamepad::Index::ONE, raw);
+
+	Gamepad::State first = mock.GetState(Gamepad::Index::ONE);
+	Gamepad::State second = mock.GetState(Gamepad::Index::ONE);
+
+	CHECK(first.connected && second.connected);
+	CHECK(first.packet == second.packet);
+	CHECK(first.leftStick[0] == second.leftStick[0] && first.leftTrigger == second.leftTrigger);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(SetResponseInvalidatesCachedStates)
+{
+	GamepadImpl_Mock mock;
+	GamepadImpl_Mock::RawState raw = {};
+	raw.thumbLX = 20000;
+	raw.connected = true;
+	mock.SetRawState(Gamepad::Index::ONE, raw);
+
+	mock.SetResponse(Gamepad::Index::ONE, GamepadResponse::XInput(0.5f));
+	Gamepad::State dead = mock.GetState(Gamepad::Index::ONE);
+
+	// Same packet, new curve: the cached conversion must not survive the swap.
+	mock.SetResponse(Gamepad::Index::ONE, GamepadResponse::Linear());
+	Gamepad::State linear = mock.GetState(Gamepad::Index::ONE);
+
+	CHECK(dead.packet == linear.packet);
+	CHECK(dead.leftStick[0] != linear.leftStick[0]);
+	CHECK(linear.leftStick[0] == GamepadResponse::Linear().leftStick.X(20000));
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(HotplugNotificationsMayComeFromAnotherThread)
+{
+	GamepadImpl_Mock mock;
+	std::atomic<bool> finished(false);
+
+	std::thread notifier([&]()
+	{
+		while (!finished.load(std::memory_order_relaxed))
+			mock.NotifyHotplug();
+	});
+
+	Gamepad::State states[Gamepad::IndexCount];
+
+	for (int i = 0; i < 10000; ++i)
+	{
+		mock.Update();
+		mock.GetStates(states, Gamepad::IndexCount);
+	}
+
+	finished.store(true, std::memory_order_relaxed);
+	notifier.join();
+
+	CHECK(!states[0].connected);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(DevicesAreReadFromTheSamplerWhileSampling)
+{
+	OwnedMock mock;
+	mock.SetGenerator(&Churning);
+	IGamepadImpl::SetInstance(&mock);
+	CHECK(Gamepad::StartSampling(std::chrono::microseconds(200)));
+
+	Gamepad::DeviceId ids[Gamepad::IndexCount];
+	Gamepad::State states[Gamepad::IndexCount];
+	uint32_t counts = 0;
+	bool consistent = true;
+
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+	while (std::chrono::steady_clock::now() < deadline)
+	{
+		CHECK(Gamepad::DeviceCount() <= Gamepad::IndexCount);
+
+		size_t count = Gamepad::GetDevices(ids, states, Gamepad::IndexCount);
+		counts |= 1u << count;
+
+		// Every device in a snapshot is connected and carries its own reading.
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (ids[i] == Gamepad::NoDevice || ids[i] > Gamepad::IndexCount || !states[i].connected || states[i].buttons != (1u << (ids[i] - 1)))
+				consistent = false;
+		}
+	}
+
+	Gamepad::StopSampling();
+	IGamepadImpl::SetInstance(nullptr);
+
+	CHECK(consistent);
+	CHECK(mock.Foreign() == 0);
+	// The pads came and went, so snapshots of several sizes were served.
+	CHECK((counts & (counts - 1)) != 0);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(CustomCurvesConvertTheSamplersReadingWhileSampling)
+{
+	OwnedMock mock;
+	mock.SetGenerator(&Steady);
+	IGamepadImpl::SetInstance(&mock);
+
+	DeadzoneSettings radial = { DeadzoneSettings::Mode::SCALED_RADIAL, 0.2f, 0.9f };
+
+	CHECK(Gamepad::StartSampling(std::chrono::milliseconds(1)));
+	Gamepad::State xinput = Gamepad::GetState(Gamepad::Index::TWO, 0.3f);
+	Gamepad::State scaled = Gamepad::GetState(Gamepad::Index::TWO, radial);
+	Gamepad::StopSampling();
+
+	CHECK(mock.Foreign() == 0);
+
+	// The same reading converted on this thread, now that it owns the backend again.
+	Gamepad::State expectedXInput = Gamepad::GetState(Gamepad::Index::TWO, 0.3f);
+	Gamepad::State expectedScaled = Gamepad::GetState(Gamepad::Index::TWO, radial);
+	IGamepadImpl::SetInstance(nullptr);
+
+	CHECK(xinput.connected && scaled.connected);
+	CHECK(xinput.leftStick == expectedXInput.leftStick && xinput.rightStick == expectedXInput.rightStick);
+	CHECK(xinput.leftTrigger == expectedXInput.leftTrigger && xinput.buttons == expectedXInput.buttons);
+	CHECK(scaled.leftStick == expectedScaled.leftStick && scaled.rightStick == expectedScaled.rightStick);
+	CHECK(xinput.leftStick != scaled.leftStick);
+}
+
+
+////////////////////////////////////////////////////////////
+#if defined(__linux__)
+DECAF_TEST(RebindingASlotDropsTheCachedState)
+{
+	GamepadImpl_Linux backend(false);
+	int first[2];
+	int second[2];
+	CHECK(pipe(first) == 0 && pipe(second) == 0);
+
+	CHECK(backend.Attach(Gamepad::Index::ONE, first[0]));
+	WriteStickReport(first[1], 10000);
+	backend.Update();
+	Gamepad::State before = backend.GetState(Gamepad::Index::ONE);
+
+	// The new device reaches the same packet count with a different reading.
+	CHECK(backend.Attach(Gamepad::Index::ONE, second[0]));
+	WriteStickReport(second[1], -10000);
+	backend.Update();
+	Gamepad::State after = backend.GetState(Gamepad::Index::ONE);
+
+	CHECK(before.packet == after.packet);
+	CHECK(before.leftStick[0] > 0 && after.leftStick[0] < 0);
+
+	close(first[1]);
+	close(second[1]);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(TapsWithinOneReadStillEmitBothEdges)
+{
+	GamepadImpl_Linux backend(false);
+	GamepadEventQueue events;
+	int fds[2];
+	CHECK(pipe(fds) == 0);
+
+	CHECK(backend.Attach(Gamepad::Index::ONE, fds[0]));
+	backend.SetEventQueue(&events);
+
+	// Press and release land in the same read, which ends with the button up again.
+	WriteTap(fds[1]);
+	backend.Update();
+
+	Gamepad::State state = backend.GetState(Gamepad::Index::ONE);
+	events.Sample(Gamepad::Index::ONE, state, GamepadEventQueue::Now());
+	CHECK(state.buttons == 0);
+
+	uint64_t end = events.Collect(Gamepad::Index::ONE);
+	CHECK(end == 2);
+	CHECK(HasTap(static_cast<size_t>(end), [&](size_t i) -> const Gamepad::Event& { return events.Get(Gamepad::Index::ONE, i); }));
+
+	close(fds[1]);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(TapsWithinOneFrameReachPolledPads)
+{
+	GamepadImpl_Linux backend(false);
+	int fds[2];
+	CHECK(pipe(fds) == 0);
+	CHECK(backend.Attach(Gamepad::Index::ONE, fds[0]));
+
+	IGamepadImpl::SetInstance(&backend);
+	Gamepad pad(Gamepad::Index::ONE);
+
+	WriteTap(fds[1]);
+	Gamepad::Update();
+	pad.Poll();
+
+	CHECK(!pad.IsButtonDown(Gamepad::Button::A));
+	CHECK(HasTap(pad.EventCount(), [&](size_t i) -> const Gamepad::Event& { return pad.GetEvent(i); }));
+
+	IGamepadImpl::SetInstance(nullptr);
+	close(fds[1]);
+}
+#endif
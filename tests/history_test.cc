@@ -0,0 +1,166 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "decaf/input/gamepad.hh"
+#include "decaf/input/gamepadevents.hh"
+#include "decaf/input/gamepadhistory.hh"
+#include "decaf/input/gamepadimpl.hh"
+#include "decaf/input/mock/gamepadimpl_mock.hh"
+
+#include "test.hh"
+
+using namespace decaf;
+
+namespace
+{
+
+	constexpr uint64_t Millisecond = 1000000;
+
+	constexpr uint16_t ButtonA = static_cast<uint16_t>(Gamepad::Button::A);
+	constexpr uint16_t ButtonB = static_cast<uint16_t>(Gamepad::Button::B);
+
+	Gamepad::RawState Holding(uint16_t buttons, int16_t thumbLX = 0)
+	{
+		Gamepad::RawState raw = {};
+		raw.buttons = buttons;
+		raw.thumbLX = thumbLX;
+		return raw;
+	}
+
+	std::atomic<uint16_t> g_buttons{ 0 };
+
+	GamepadImpl_Mock::RawState Scripted(Gamepad::Index, uint64_t, void*)
+	{
+		GamepadImpl_Mock::RawState raw = {};
+		raw.buttons = g_buttons.load(std::memory_order_relaxed);
+		raw.connected = true;
+		return raw;
+	}
+
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(PressAndReleaseWindowsAreInclusive)
+{
+	GamepadHistory history;
+	history.Push(Holding(0), true, 10 * Millisecond);
+	history.Push(Holding(ButtonA), true, 100 * Millisecond);
+
+	CHECK(history.IsDown(Gamepad::Button::A));
+	CHECK(history.WasPressedWithin(Gamepad::Button::A, 20 * Millisecond, 120 * Millisecond));
+	CHECK(!history.WasPressedWithin(Gamepad::Button::A, 20 * Millisecond, 120 * Millisecond + 1));
+	CHECK(!history.WasPressedWithin(Gamepad::Button::B, 1000 * Millisecond, 120 * Millisecond));
+	CHECK(!history.WasReleasedWithin(Gamepad::Button::A, 1000 * Millisecond, 120 * Millisecond));
+
+	CHECK(history.HeldDuration(Gamepad::Button::A, 250 * Millisecond) == 150 * Millisecond);
+
+	history.Push(Holding(0), true, 300 * Millisecond);
+	CHECK(!history.IsDown(Gamepad::Button::A));
+	CHECK(history.HeldDuration(Gamepad::Button::A, 350 * Millisecond) == 0);
+	CHECK(history.WasReleasedWithin(Gamepad::Button::A, 50 * Millisecond, 350 * Millisecond));
+	CHECK(!history.WasReleasedWithin(Gamepad::Button::A, 50 * Millisecond, 351 * Millisecond));
+
+	// The press is still remembered after the release.
+	CHECK(history.WasPressedWithin(Gamepad::Button::A, 250 * Millisecond, 350 * Millisecond));
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(PressCountsOnlyTheWindowAndCapsAtTheDepth)
+{
+	GamepadHistory history;
+
+	// A tap every 100 ms, from 100 ms to 1200 ms.
+	for (uint64_t tap = 1; tap <= 12; ++tap)
+	{
+		history.Push(Holding(ButtonB), true, tap * 100 * Millisecond);
+		history.Push(Holding(0), true, tap * 100 * Millisecond + 50 * Millisecond);
+	}
+
+	CHECK(history.PressCount(Gamepad::Button::B, 250 * Millisecond, 1200 * Millisecond) == 3);
+	CHECK(history.PressCount(Gamepad::Button::B, 0, 1200 * Millisecond) == 1);
+	CHECK(history.PressCount(Gamepad::Button::B, 50 * Millisecond, 1260 * Millisecond) == 0);
+	CHECK(history.PressCount(Gamepad::Button::B, 2000 * Millisecond, 1200 * Millisecond) == GamepadHistory::PressDepth);
+	CHECK(history.PressCount(Gamepad::Button::A, 2000 * Millisecond, 1200 * Millisecond) == 0);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(StateAtFindsTheSnapshotInEffect)
+{
+	GamepadHistory history(4);
+	CHECK(history.Capacity() == 4);
+
+	Gamepad::State state;
+	CHECK(!history.StateAt(0, state));
+
+	for (int16_t i = 1; i <= 3; ++i)
+		history.Push(Holding(0, static_cast<int16_t>(i * 1000)), true, static_cast<uint64_t>(i) * 10 * Millisecond);
+
+	// Repeats add nothing.
+	history.Push(Holding(0, 3000), true, 35 * Millisecond);
+	CHECK(history.Count() == 3);
+
+	CHECK(!history.StateAt(10 * Millisecond - 1, state));
+	CHECK(history.StateAt(10 * Millisecond, state) && state.leftStick[0] == 1000.0f / 32767 && state.timestamp == 10 * Millisecond);
+	CHECK(history.StateAt(25 * Millisecond, state) && state.leftStick[0] == 2000.0f / 32767);
+	CHECK(history.StateAt(30 * Millisecond, state) && state.leftStick[0] == 3000.0f / 32767);
+	CHECK(history.StateAt(1000 * Millisecond, state) && state.leftStick[0] == 3000.0f / 32767);
+
+	// Once the ring wraps, the oldest snapshots are gone.
+	for (int16_t i = 4; i <= 10; ++i)
+		history.Push(Holding(0, static_cast<int16_t>(i * 1000)), true, static_cast<uint64_t>(i) * 10 * Millisecond);
+
+	CHECK(history.Count() == 4);
+	CHECK(history.Get(0).state.thumbLX == 10000 && history.Get(3).state.thumbLX == 7000);
+	CHECK(!history.StateAt(69 * Millisecond, state));
+	CHECK(history.StateAt(85 * Millisecond, state) && state.leftStick[0] == 8000.0f / 32767);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(SnapshotsNeverGoBackInTime)
+{
+	GamepadHistory history;
+	history.Push(Holding(0), true, 50 * Millisecond);
+	history.Push(Holding(ButtonA), true, 40 * Millisecond);
+
+	CHECK(history.Get(0).timestamp == 50 * Millisecond);
+	CHECK(history.WasPressedWithin(Gamepad::Button::A, 0, 50 * Millisecond));
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(RecordedPadsKeepTapsShorterThanAPoll)
+{
+	GamepadImpl_Mock mock;
+	mock.SetGenerator(&Scripted);
+	IGamepadImpl::SetInstance(&mock);
+	CHECK(Gamepad::StartSampling(std::chrono::milliseconds(1)));
+
+	Gamepad pad(Gamepad::Index::ONE);
+	GamepadHistory history;
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	pad.Poll();
+	history.Record(pad);
+
+	// A tap between two polls: the snapshots never see A down, but the events do.
+	uint64_t before = GamepadEventQueue::Now();
+	g_buttons.store(ButtonA, std::memory_order_relaxed);
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	g_buttons.store(0, std::memory_order_relaxed);
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+	pad.Poll();
+	history.Record(pad);
+	uint64_t now = GamepadEventQueue::Now();
+
+	CHECK(!history.IsDown(Gamepad::Button::A));
+	CHECK(history.PressCount(Gamepad::Button::A, now - before, now) == 1);
+	CHECK(history.WasReleasedWithin(Gamepad::Button::A, now - before, now));
+
+	Gamepad::StopSampling();
+	IGamepadImpl::SetInstance(nullptr);
+}
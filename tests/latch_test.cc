@@ -0,0 +1,186 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#include "decaf/input/deadzone.hh"
+#include "decaf/input/gamepad.hh"
+#include "decaf/input/gamepadimpl.hh"
+#include "decaf/input/mock/gamepadimpl_mock.hh"
+
+#include "test.hh"
+
+using namespace decaf;
+
+namespace
+{
+
+	/// <summary>About 0.49 of full deflection, inside some of the deadzones below and outside others.</summary>
+	constexpr int16_t Deflection = 16056;
+
+	GamepadImpl_Mock::RawState Deflected(Gamepad::Index, uint64_t, void*)
+	{
+		GamepadImpl_Mock::RawState raw = {};
+		raw.thumbLX = Deflection;
+		raw.connected = true;
+		return raw;
+	}
+
+	GamepadSettings ScaledRadial(float inner, float outer)
+	{
+		GamepadSettings settings = {};
+		settings.leftStick = { DeadzoneSettings::Mode::SCALED_RADIAL, inner, outer };
+		settings.rightStick = settings.leftStick;
+		return settings;
+	}
+
+	struct FillLog
+	{
+		int order[8];
+		size_t count;
+	};
+
+	void Record(Gamepad::Index, const Gamepad::State&, void* slot, void* context)
+	{
+		FillLog& log = *static_cast<FillLog*>(context);
+		if (log.count < 8)
+			log.order[log.count] = *static_cast<int*>(slot);
+		++log.count;
+	}
+
+	void Store(Gamepad::Index, const Gamepad::State& state, void* slot, void*)
+	{
+		*static_cast<Gamepad::State*>(slot) = state;
+	}
+
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(FillsSlotsInRegistrationOrder)
+{
+	GamepadImpl_Mock mock;
+	mock.SetGenerator(&Deflected);
+	IGamepadImpl::SetInstance(&mock);
+
+	int ids[4] = { 0, 1, 2, 3 };
+	FillLog log = {};
+
+	uint32_t first = Gamepad::RegisterLatch(Gamepad::Index::TWO, &Record, &ids[0], &log);
+	uint32_t second = Gamepad::RegisterLatch(Gamepad::Index::ONE, &Record, &ids[1], &log);
+	uint32_t third = Gamepad::RegisterLatch(Gamepad::Index::TWO, &Record, &ids[2], &log);
+	CHECK(first != 0 && second != 0 && third != 0);
+
+	// Latching never calls into the backend, so nothing is filled until the sampler runs.
+	CHECK(Gamepad::Latch() == 0);
+	CHECK(log.count == 0);
+
+	CHECK(Gamepad::StartSampling(std::chrono::milliseconds(1)));
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+	CHECK(Gamepad::Latch() == 3);
+	CHECK(log.count == 3);
+	CHECK(log.order[0] == 0 && log.order[1] == 1 && log.order[2] == 2);
+
+	// A slot registered after an unregistration still comes last, not in the freed place.
+	Gamepad::UnregisterLatch(second);
+	uint32_t fourth = Gamepad::RegisterLatch(Gamepad::Index::ONE, &Record, &ids[3], &log);
+	CHECK(fourth != 0);
+
+	log = {};
+	CHECK(Gamepad::Latch() == 3);
+	CHECK(log.count == 3);
+	CHECK(log.order[0] == 0 && log.order[1] == 2 && log.order[2] == 3);
+
+	Gamepad::UnregisterLatch(first);
+	Gamepad::UnregisterLatch(third);
+	Gamepad::UnregisterLatch(fourth);
+	CHECK(Gamepad::Latch() == 0);
+
+	Gamepad::StopSampling();
+	IGamepadImpl::SetInstance(nullptr);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(LatchesTheNewestPublishedSettings)
+{
+	GamepadImpl_Mock mock;
+	mock.SetGenerator(&Deflected);
+	IGamepadImpl::SetInstance(&mock);
+
+	Gamepad::State latched = {};
+	uint32_t handle = Gamepad::RegisterLatch(Gamepad::Index::ONE, &Store, &latched);
+	CHECK(handle != 0);
+
+	Gamepad::SetSettings(Gamepad::Index::ONE, ScaledRadial(0.6f, 1.0f));
+	CHECK(Gamepad::StartSampling(std::chrono::milliseconds(1)));
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+	CHECK(Gamepad::Latch() == 1);
+	CHECK(latched.connected);
+	CHECK(latched.leftStick.X() == 0.0f);
+
+	Gamepad::SetSettings(Gamepad::Index::ONE, ScaledRadial(0.2f, 0.6f));
+	CHECK(Gamepad::Latch() == 1);
+	CHECK_NEAR(latched.leftStick.X(), (0.49f - 0.2f) / 0.4f, 0.01f);
+
+	Gamepad::UnregisterLatch(handle);
+	Gamepad::StopSampling();
+	Gamepad::SetSettings(Gamepad::Index::ONE, GamepadSettings{});
+	IGamepadImpl::SetInstance(nullptr);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(ConcurrentSettingsNeverTearLatchedDeadzones)
+{
+	GamepadImpl_Mock mock;
+	mock.SetGenerator(&Deflected);
+	IGamepadImpl::SetInstance(&mock);
+
+	// Each settings value scales the stick distinctly, and so would either mix of their inner and outer radii.
+	const GamepadSettings wide = ScaledRadial(0.1f, 1.0f);
+	const GamepadSettings narrow = ScaledRadial(0.2f, 0.6f);
+	const float wideX = (0.49f - 0.1f) / 0.9f;
+	const float narrowX = (0.49f - 0.2f) / 0.4f;
+
+	Gamepad::State latched = {};
+	uint32_t handle = Gamepad::RegisterLatch(Gamepad::Index::ONE, &Store, &latched);
+	CHECK(handle != 0);
+
+	Gamepad::SetSettings(Gamepad::Index::ONE, wide);
+	CHECK(Gamepad::StartSampling(std::chrono::milliseconds(1)));
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+	// This thread plays the game thread; the render thread latches concurrently.
+	std::atomic<bool> done{ false };
+	std::atomic<size_t> latches{ 0 };
+	size_t torn = 0;
+	std::thread render([&] {
+		while (!done.load(std::memory_order_acquire))
+		{
+			if (Gamepad::Latch() != 1)
+				continue;
+
+			latches.fetch_add(1, std::memory_order_relaxed);
+			float x = latched.leftStick.X();
+			if (std::abs(x - wideX) > 0.01f && std::abs(x - narrowX) > 0.01f)
+				++torn;
+		}
+	});
+
+	// Keep publishing until the render thread has latched often enough to have raced the writes.
+	for (int i = 0; i < 20000 || latches.load(std::memory_order_relaxed) < 1000; ++i)
+		Gamepad::SetSettings(Gamepad::Index::ONE, (i & 1) ? narrow : wide);
+
+	done.store(true, std::memory_order_release);
+	render.join();
+
+	CHECK(torn == 0);
+
+	Gamepad::UnregisterLatch(handle);
+	Gamepad::StopSampling();
+	Gamepad::SetSettings(Gamepad::Index::ONE, GamepadSettings{});
+	IGamepadImpl::SetInstance(nullptr);
+}
@@ -0,0 +1,88 @@
+#include <chrono>
+#include <thread>
+
+#include "decaf/input/gamepad.hh"
+#include "decaf/input/gamepadimpl.hh"
+#include "decaf/input/latency.hh"
+#include "decaf/input/mock/gamepadimpl_mock.hh"
+
+#include "test.hh"
+
+using namespace decaf;
+
+namespace
+{
+
+	void Press(GamepadImpl_Mock& mock, Gamepad::Index index, uint16_t buttons)
+	{
+		GamepadImpl_Mock::RawState raw = {};
+		raw.buttons = buttons;
+		raw.connected = true;
+		mock.SetRawState(index, raw);
+	}
+
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(SampleToPollCountsEachSampleOnce)
+{
+	GamepadImpl_Mock mock;
+	IGamepadImpl::SetInstance(&mock);
+	Gamepad::ResetLatency(Gamepad::Index::ONE);
+
+	Gamepad pad(Gamepad::Index::ONE);
+	Press(mock, Gamepad::Index::ONE, 0);
+
+	// An idle pad polled every few milliseconds delivers one sample, however often it is read.
+	for (int i = 0; i < 10; ++i)
+	{
+		pad.Poll();
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	}
+
+	LatencyStats stats = Gamepad::GetLatency(Gamepad::Index::ONE, Gamepad::Latency::SAMPLE_TO_POLL);
+
+#if defined (DECAF_INPUT_NO_LATENCY)
+	CHECK(stats.count == 0);
+#else
+	CHECK(stats.count == 1);
+	CHECK(stats.max < 2000000);
+
+	Press(mock, Gamepad::Index::ONE, static_cast<uint16_t>(Gamepad::Button::A));
+	pad.Poll();
+	pad.Poll();
+	CHECK(Gamepad::GetLatency(Gamepad::Index::ONE, Gamepad::Latency::SAMPLE_TO_POLL).count == 2);
+#endif
+
+	IGamepadImpl::SetInstance(nullptr);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(BatchedPollsCountEachSampleOnce)
+{
+	GamepadImpl_Mock mock;
+	IGamepadImpl::SetInstance(&mock);
+	Gamepad::ResetLatency(Gamepad::Index::TWO);
+
+	Gamepad pads[] = { Gamepad(Gamepad::Index::TWO) };
+	Press(mock, Gamepad::Index::TWO, 0);
+
+	for (int i = 0; i < 10; ++i)
+	{
+		Gamepad::Poll(pads, 1);
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	}
+
+	LatencyStats stats = Gamepad::GetLatency(Gamepad::Index::TWO, Gamepad::Latency::SAMPLE_TO_POLL);
+
+#if defined (DECAF_INPUT_NO_LATENCY)
+	CHECK(stats.count == 0);
+#else
+	CHECK(stats.count == 1);
+	CHECK(stats.max < 2000000);
+#endif
+
+	IGamepadImpl::SetInstance(nullptr);
+}
@@ -0,0 +1,6 @@
+#include "test.hh"
+
+int main(int argc, char** argv)
+{
+	return decaf::Test::Run(argc, argv);
+}
@@ -0,0 +1,257 @@
+#include <cstdint>
+#include <vector>
+
+#include "decaf/input/gamepad.hh"
+#include "decaf/input/remote/remotestream.hh"
+#include "decaf/input/remote/statecodec.hh"
+
+#include "test.hh"
+
+using namespace decaf;
+
+namespace
+{
+
+	/// <summary>A small deterministic generator, so every run sees the same losses.</summary>
+	struct Random
+	{
+		uint32_t seed;
+
+		inline uint32_t Next()
+		{
+			seed = seed * 1664525u + 1013904223u;
+			return seed >> 8;
+		}
+
+		inline bool Chance(uint32_t percent)
+		{
+			return Next() % 100 < percent;
+		}
+
+		inline float Unit()
+		{
+			return static_cast<float>(Next()) / 16777216.0f;
+		}
+	};
+
+	/// <summary>Moves a pad the way players do: mostly idle, sometimes drifting, now and then a flick or a press.</summary>
+	void Wander(Gamepad::State& state, Random& random)
+	{
+		if (random.Chance(40))
+			return;
+
+		float* axes[4] = { &state.leftStick[0], &state.leftStick[1], &state.rightStick[0], &state.rightStick[1] };
+		float& axis = *axes[random.Next() % 4];
+
+		if (random.Chance(80))
+			axis += (random.Unit() - 0.5f) * 0.02f;
+		else
+			axis = random.Unit() * 2.0f - 1.0f;
+
+		axis = axis < -1.0f ? -1.0f : (axis > 1.0f ? 1.0f : axis);
+
+		if (random.Chance(20))
+			state.buttons ^= static_cast<uint16_t>(1u << (random.Next() % 16));
+
+		if (random.Chance(10))
+			state.leftTrigger = random.Unit();
+
+		if (random.Chance(1))
+			state.connected = !state.connected;
+	}
+
+	bool SameFrame(const Gamepad::State* sent, const Gamepad::State* received, size_t pads)
+	{
+		for (size_t i = 0; i < pads; ++i)
+		{
+			StateCodec::Quantized a, b;
+			StateCodec::Quantize(sent[i], a);
+			StateCodec::Quantize(received[i], b);
+
+			if (!StateCodec::Equal(a, b))
+				return false;
+		}
+
+		return true;
+	}
+
+	/// <summary>Streams <paramref name='frames'/> frames of <paramref name='pads'/> pads through a channel that loses datagrams and
+	/// acknowledgements, and checks every frame the receiver ends up with against what was sent.</summary>
+	/// <param name='blackout'>A run of frames, starting at <paramref name='blackoutAt'/>, for which nothing gets through either way.</param>
+	void Stream(size_t pads, uint32_t frames, uint32_t loss, uint32_t ackLoss, uint32_t blackoutAt, uint32_t blackout)
+	{
+		RemoteSender sender;
+		RemoteReceiver receiver;
+		Random random = { 2024 + loss + ackLoss };
+
+		std::vector<std::vector<Gamepad::State>> sent(1);
+		Gamepad::State states[Gamepad::IndexCount] = {};
+
+		for (Gamepad::State& state : states)
+			state.connected = true;
+
+		uint8_t datagram[Remote::MaxDatagram];
+		std::vector<uint8_t> delayed;
+		uint32_t accepted = 0;
+
+		for (uint32_t n = 1; n <= frames; ++n)
+		{
+			for (size_t i = 0; i < pads; ++i)
+				Wander(states[i], random);
+
+			CHECK(sender.Push(states, pads) == n);
+			sent.emplace_back(states, states + pads);
+
+			size_t size = sender.Encode(datagram, sizeof(datagram));
+			CHECK(size != 0 && size <= Remote::MaxDatagram);
+
+			bool dark = (n >= blackoutAt && n < blackoutAt + blackout);
+
+			// Now and then a datagram turns up one frame late, behind the next one.
+			if (!dark && random.Chance(5))
+			{
+				delayed.assign(datagram, datagram + size);
+				continue;
+			}
+
+			if (dark || random.Chance(loss))
+				continue;
+
+			uint32_t before = receiver.LatestFrame();
+			CHECK(receiver.Decode(datagram, size));
+			CHECK(receiver.LatestFrame() == n);
+			++accepted;
+
+			if (!delayed.empty())
+			{
+				// A stale datagram may still decode, but must never roll the newest frame back.
+				receiver.Decode(delayed.data(), delayed.size());
+				CHECK(receiver.LatestFrame() == n);
+				delayed.clear();
+			}
+
+			Gamepad::State newest[Gamepad::IndexCount];
+			for (size_t i = 0; i < Gamepad::IndexCount; ++i)
+				newest[i] = receiver.GetState(static_cast<Gamepad::Index>(i));
+
+			CHECK(SameFrame(sent[n].data(), newest, pads));
+			CHECK(newest[0].packet == n && before < n);
+
+			if (!random.Chance(ackLoss))
+				sender.Acknowledge(receiver.LatestFrame());
+		}
+
+		CHECK(accepted > frames * (100 - loss) / 200);
+		CHECK(receiver.RejectedCount() == 0);
+
+		// Every frame still in the history must be exactly what was sent.
+		uint32_t checked = 0;
+
+		for (uint32_t n = frames > Remote::History ? frames - Remote::History + 1 : 1; n <= frames; ++n)
+		{
+			Gamepad::State received[Gamepad::IndexCount];
+
+			if (!receiver.GetFrame(n, received, Gamepad::IndexCount))
+				continue;
+
+			CHECK(SameFrame(sent[n].data(), received, pads));
+			++checked;
+		}
+
+		CHECK(checked != 0);
+	}
+
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(CodecRoundTripsEveryChange)
+{
+	Random random = { 7 };
+	Gamepad::State previous = {};
+	Gamepad::State current = {};
+	current.connected = true;
+
+	for (int i = 0; i < 20000; ++i)
+	{
+		Wander(current, random);
+
+		StateCodec::Quantized reference, state, decoded;
+		StateCodec::Quantize(previous, reference);
+		StateCodec::Quantize(current, state);
+
+		uint8_t buffer[(StateCodec::MaxPadBits + 7) / 8];
+		BitWriter writer(buffer, sizeof(buffer));
+		StateCodec::Encode(reference, state, writer);
+		CHECK(writer.BitCount() <= StateCodec::MaxPadBits);
+		CHECK(!StateCodec::Equal(reference, state) || writer.BitCount() == 1);
+
+		BitReader reader(buffer, writer.Finish());
+		StateCodec::Decode(reference, decoded, reader);
+		CHECK(!reader.Overflowed());
+		CHECK(StateCodec::Equal(state, decoded));
+
+		previous = current;
+	}
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(FullChangesFitTheWorstCase)
+{
+	StateCodec::Quantized low = { 0, { -32767, -32767, -32767, -32767 }, { 0, 0 }, 0 };
+	StateCodec::Quantized high = { 0xf3ff, { 32767, 32767, 32767, 32767 }, { 255, 255 }, 1 };
+
+	uint8_t buffer[(StateCodec::MaxPadBits + 7) / 8];
+	BitWriter writer(buffer, sizeof(buffer));
+	StateCodec::Encode(low, high, writer);
+	CHECK(!writer.Overflowed() && writer.BitCount() == StateCodec::MaxPadBits);
+
+	StateCodec::Quantized decoded;
+	BitReader reader(buffer, writer.Finish());
+	StateCodec::Decode(low, decoded, reader);
+	CHECK(StateCodec::Equal(high, decoded));
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(StreamsSurviveLossOfDatagramsAndAcks)
+{
+	Stream(1, 2000, 10, 10, 0, 0);
+	Stream(4, 2000, 30, 30, 0, 0);
+	Stream(4, 2000, 60, 80, 0, 0);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(StreamsRecoverFromOutagesLongerThanTheHistory)
+{
+	// Past Remote::History unacknowledged frames the sender must fall back to the zero baseline rather than one the receiver lost.
+	Stream(2, 1000, 10, 10, 300, Remote::History * 3);
+	Stream(4, 1000, 0, 0, 500, Remote::MaxFrames + 1);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(TruncatedDatagramsLeaveTheReceiverUntouched)
+{
+	RemoteSender sender;
+	RemoteReceiver receiver;
+	Gamepad::State states[2] = {};
+	states[0].connected = true;
+	states[0].leftStick = Vector2f(0.5f, -0.25f);
+	states[1].buttons = static_cast<uint16_t>(Gamepad::Button::A);
+
+	sender.Push(states, 2);
+	uint8_t datagram[Remote::MaxDatagram];
+	size_t size = sender.Encode(datagram, sizeof(datagram));
+
+	for (size_t cut = 0; cut < size; ++cut)
+		CHECK(!receiver.Decode(datagram, cut));
+
+	CHECK(receiver.LatestFrame() == 0);
+	CHECK(receiver.RejectedCount() == size);
+
+	CHECK(receiver.Decode(datagram, size));
+	CHECK(receiver.LatestFrame() == 1);
+}
@@ -0,0 +1,216 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "decaf/input/gamepad.hh"
+#include "decaf/input/mock/gamepadimpl_mock.hh"
+#include "decaf/input/replay/gamepadimpl_replay.hh"
+#include "decaf/input/replay/gamepadrecorder.hh"
+#include "decaf/input/replay/replayformat.hh"
+#include "decaf/input/response.hh"
+
+#include "test.hh"
+
+using namespace decaf;
+
+namespace
+{
+
+	const char* const Path = "replay_test.dgpr";
+
+	long FileSize(const char* path)
+	{
+		FILE* file = fopen(path, "rb");
+
+		if (file == nullptr)
+			return -1;
+
+		fseek(file, 0, SEEK_END);
+		long size = ftell(file);
+		fclose(file);
+		return size;
+	}
+
+	bool SamePacked(const Gamepad::State& a, const Gamepad::State& b)
+	{
+		Gamepad::RawState x, y;
+		GamepadResponse::Pack(a, x);
+		GamepadResponse::Pack(b, y);
+		return memcmp(&x, &y, sizeof(Gamepad::RawState)) == 0 && a.connected == b.connected;
+	}
+
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(PackInvertsTheLinearResponse)
+{
+	Gamepad::State state = {};
+	Gamepad::RawState raw = {};
+	Gamepad::RawState packed = {};
+
+	for (int32_t value = -32767; value <= 32767; ++value)
+	{
+		raw.thumbLX = static_cast<int16_t>(value);
+		raw.thumbRY = static_cast<int16_t>(-value);
+		raw.leftTrigger = static_cast<uint8_t>(value & 0xff);
+		raw.rightTrigger = static_cast<uint8_t>(~value & 0xff);
+		raw.buttons = static_cast<uint16_t>(value);
+
+		GamepadResponse::Linear().Decode(raw, state);
+		GamepadResponse::Pack(state, packed);
+		CHECK(memcmp(&raw, &packed, sizeof(Gamepad::RawState)) == 0);
+	}
+
+	// -32768 has no positive twin, so it decodes to -1 and packs back as -32767.
+	raw = Gamepad::RawState();
+	raw.thumbLY = -32768;
+	GamepadResponse::Linear().Decode(raw, state);
+	GamepadResponse::Pack(state, packed);
+	CHECK(state.leftStick[1] == -1.0f && packed.thumbLY == -32767);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(RecordedSessionsReplayAtPackedResolution)
+{
+	GamepadImpl_Mock mock;
+	std::vector<Gamepad::State> recorded;
+	uint32_t changes = 0;
+
+	{
+		GamepadRecorder recorder(&mock, Path);
+		CHECK(recorder.IsOpen());
+
+		GamepadImpl_Mock::RawState raw = {};
+		raw.connected = true;
+
+		for (int i = 0; i < 500; ++i)
+		{
+			// Hold every other reading, so only changes reach the file.
+			if ((i & 1) == 0)
+			{
+				raw.thumbLX = static_cast<int16_t>(i * 131 - 32000);
+				raw.thumbRY = static_cast<int16_t>(20000 - i * 97);
+				raw.leftTrigger = static_cast<uint8_t>(i);
+				raw.buttons = static_cast<uint16_t>(i & 0xf3ff);
+				++changes;
+			}
+
+			mock.SetRawState(Gamepad::Index::TWO, raw);
+
+			Gamepad::State states[Gamepad::IndexCount];
+			recorder.Update();
+			recorder.GetStates(states, Gamepad::IndexCount);
+
+			if ((i & 1) == 0)
+				recorded.push_back(states[1]);
+		}
+	}
+
+	// One record for each pad's first state, then one per change of pad two.
+	long records = static_cast<long>(Gamepad::IndexCount - 1 + changes);
+	CHECK(FileSize(Path) == static_cast<long>(sizeof(Replay::Header)) + records * static_cast<long>(sizeof(Replay::Record)));
+
+	GamepadImpl_Replay replay(Path, GamepadImpl_Replay::Mode::UNTHROTTLED);
+	CHECK(replay.RecordCount() == static_cast<size_t>(records));
+
+	size_t next = 0;
+
+	while (!replay.Finished())
+	{
+		replay.Update();
+		Gamepad::State state = replay.GetState(Gamepad::Index::TWO);
+
+		if (next < recorded.size() && state.connected && SamePacked(state, recorded[next]))
+			++next;
+	}
+
+	CHECK(next == recorded.size());
+	CHECK(replay.IsConnected(Gamepad::Index::TWO) && !replay.IsConnected(Gamepad::Index::ONE));
+
+	std::remove(Path);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(ReplayedTimestampsKeepTheRecordedTiming)
+{
+	GamepadImpl_Mock mock;
+	std::vector<uint64_t> recorded;
+
+	{
+		GamepadRecorder recorder(&mock, Path);
+		CHECK(recorder.IsOpen());
+
+		GamepadImpl_Mock::RawState raw = {};
+		raw.connected = true;
+
+		// Uneven gaps between changes, each polled several times, so the poll rate and the input's timing differ.
+		for (int i = 0; i < 12; ++i)
+		{
+			raw.buttons = static_cast<uint16_t>(i + 1);
+			mock.SetRawState(Gamepad::Index::TWO, raw);
+
+			for (int poll = 0; poll < 3; ++poll)
+			{
+				Gamepad::State states[Gamepad::IndexCount];
+				recorder.Update();
+				recorder.GetStates(states, Gamepad::IndexCount);
+
+				if (poll == 0)
+					recorded.push_back(states[1].timestamp);
+			}
+
+			std::this_thread::sleep_for(std::chrono::microseconds(200 * (i % 4)));
+		}
+	}
+
+	GamepadImpl_Replay replay(Path, GamepadImpl_Replay::Mode::UNTHROTTLED);
+	std::vector<uint64_t> replayed;
+	uint32_t previous = 0;
+
+	while (!replay.Finished())
+	{
+		replay.Update();
+		Gamepad::State state = replay.GetState(Gamepad::Index::TWO);
+
+		if (state.connected && state.packet != previous)
+		{
+			replayed.push_back(state.timestamp);
+			previous = state.packet;
+		}
+	}
+
+	// Playback runs as fast as it can, yet every state carries its recorded time after the first.
+	CHECK(replayed.size() == recorded.size());
+
+	for (size_t i = 1; i < replayed.size() && i < recorded.size(); ++i)
+		CHECK(replayed[i] - replayed[0] == recorded[i] - recorded[0]);
+
+	std::remove(Path);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(OldReplaysAreRejected)
+{
+	FILE* file = fopen(Path, "wb");
+	CHECK(file != nullptr);
+
+	Replay::Header header = { { 0 }, 1, 40, 0 };
+	memcpy(header.magic, Replay::Magic, sizeof(Replay::Magic));
+	uint8_t record[40] = {};
+
+	fwrite(&header, sizeof(header), 1, file);
+	fwrite(record, sizeof(record), 1, file);
+	fclose(file);
+
+	GamepadImpl_Replay replay;
+	CHECK(!replay.Open(Path));
+	CHECK(replay.RecordCount() == 0 && replay.Finished());
+
+	std::remove(Path);
+}
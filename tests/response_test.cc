@@ -0,0 +1,258 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "decaf/input/gamepad.hh"
+#include "decaf/input/gamepadimpl.hh"
+#include "decaf/input/mock/gamepadimpl_mock.hh"
+#include "decaf/input/response.hh"
+#include "decaf/input/responsebatch.hh"
+
+#include "test.hh"
+
+using namespace decaf;
+
+namespace
+{
+
+	/// <summary>The per-axis conversion the backends used before responses were compiled into tables.</summary>
+	float HistoricalStick(int16_t raw, float deadzone)
+	{
+		float n = fmaxf(-1.0f, (float)raw / 32767.0f);
+		float value = (fabsf(n) < deadzone ? 0 : (fabsf(n) - deadzone) * (n * fabsf(n)));
+		return value * (1 / (1 - deadzone));
+	}
+
+	/// <summary>Checks a stick table against the historical formula for every int16 reading.</summary>
+	bool MatchesHistorical(const StickResponse& response, float deadzone)
+	{
+		for (int32_t raw = -32768; raw <= 32767; ++raw)
+		{
+			if (response.X(static_cast<int16_t>(raw)) != HistoricalStick(static_cast<int16_t>(raw), deadzone))
+				return false;
+		}
+
+		return true;
+	}
+
+	bool MatchesLinearTrigger(const TriggerResponse& response)
+	{
+		for (int32_t raw = 0; raw <= 255; ++raw)
+		{
+			if (response(static_cast<uint8_t>(raw)) != (float)raw / 255)
+				return false;
+		}
+
+		return true;
+	}
+
+	/// <summary>Batch sizes covering whole vectors, every tail length and a misaligned start.</summary>
+	constexpr size_t BatchOffsets[] = { 0, 1, 3 };
+	constexpr size_t BatchTails[] = { 0, 1, 5, 7, 9, 15 };
+
+	/// <summary>Checks <c>ConvertAxis</c> and <c>ConvertStick</c> against <c>StickResponse::X</c> and <c>Y</c> for every int16 reading.</summary>
+	/// <remarks>Each axis is converted with the response's own inversion for it, so a response inverting only one axis covers both paths.</remarks>
+	bool BatchMatchesScalar(const StickResponse& response)
+	{
+		std::vector<int16_t> raw(65536);
+		std::vector<float> expectedX(raw.size());
+		std::vector<float> expectedY(raw.size());
+		for (size_t i = 0; i < raw.size(); ++i)
+		{
+			raw[i] = static_cast<int16_t>(static_cast<int32_t>(i) - 32768);
+			expectedX[i] = response.X(raw[i]);
+			expectedY[i] = response.Y(raw[i]);
+		}
+
+		std::vector<float> outX(raw.size());
+		std::vector<float> outY(raw.size());
+		bool matches = true;
+
+		for (size_t offset : BatchOffsets)
+		{
+			for (size_t tail : BatchTails)
+			{
+				size_t count = raw.size() - 16 - offset + tail;
+				size_t bytes = count * sizeof(float);
+
+				Response::ConvertAxis(response, response.InvertX(), raw.data() + offset, outX.data(), count);
+				Response::ConvertAxis(response, response.InvertY(), raw.data() + offset, outY.data(), count);
+				matches &= memcmp(outX.data(), expectedX.data() + offset, bytes) == 0;
+				matches &= memcmp(outY.data(), expectedY.data() + offset, bytes) == 0;
+
+				Response::ConvertStick(response, raw.data() + offset, raw.data() + offset, outX.data(), outY.data(), count);
+				matches &= memcmp(outX.data(), expectedX.data() + offset, bytes) == 0;
+				matches &= memcmp(outY.data(), expectedY.data() + offset, bytes) == 0;
+			}
+		}
+
+		// Batches shorter than a vector run on the tail path alone.
+		for (size_t count = 0; count < 16; ++count)
+		{
+			Response::ConvertStick(response, raw.data(), raw.data(), outX.data(), outY.data(), count);
+			matches &= memcmp(outX.data(), expectedX.data(), count * sizeof(float)) == 0;
+			matches &= memcmp(outY.data(), expectedY.data(), count * sizeof(float)) == 0;
+		}
+
+		return matches;
+	}
+
+	/// <summary>Checks <c>ConvertTrigger</c> against <c>TriggerResponse::operator()</c> for every uint8 reading.</summary>
+	bool BatchMatchesScalar(const TriggerResponse& response)
+	{
+		std::vector<uint8_t> raw(256 + 16);
+		std::vector<float> expected(raw.size());
+		for (size_t i = 0; i < raw.size(); ++i)
+		{
+			raw[i] = static_cast<uint8_t>(i);
+			expected[i] = response(raw[i]);
+		}
+
+		std::vector<float> out(raw.size());
+		bool matches = true;
+
+		for (size_t offset : BatchOffsets)
+		{
+			for (size_t tail : BatchTails)
+			{
+				size_t count = 256 - offset + tail;
+
+				Response::ConvertTrigger(response, raw.data() + offset, out.data(), count);
+				matches &= memcmp(out.data(), expected.data() + offset, count * sizeof(float)) == 0;
+			}
+		}
+
+		return matches;
+	}
+
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(XInputTablesMatchTheHistoricalFormula)
+{
+	const GamepadResponse& response = GamepadResponse::XInput();
+
+	CHECK(MatchesHistorical(response.leftStick, 7849.0f / 32767));
+	CHECK(MatchesHistorical(response.rightStick, 8689.0f / 32767));
+	CHECK(MatchesLinearTrigger(response.leftTrigger));
+	CHECK(MatchesLinearTrigger(response.rightTrigger));
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(XInputDeadzoneTablesMatchTheHistoricalFormula)
+{
+	for (float deadzone : { 0.0f, 0.1f, 0.24f, 0.5f, 0.9f })
+	{
+		const GamepadResponse& response = GamepadResponse::XInput(deadzone);
+
+		CHECK(MatchesHistorical(response.leftStick, deadzone));
+		CHECK(MatchesHistorical(response.rightStick, deadzone));
+		CHECK(MatchesLinearTrigger(response.leftTrigger));
+	}
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(LinearTableIsPlainScaling)
+{
+	const StickResponse& linear = StickResponse::Linear();
+	bool matches = true;
+
+	for (int32_t raw = -32768; raw <= 32767; ++raw)
+		matches &= linear.X(static_cast<int16_t>(raw)) == fmaxf(-1.0f, (float)raw / 32767.0f);
+
+	CHECK(matches);
+	CHECK(MatchesLinearTrigger(GamepadResponse::Linear().leftTrigger));
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(XInputCacheIsKeyedByDeadzone)
+{
+	const float* first = GamepadResponse::XInput(0.1f).leftStick.Table();
+	const float* second = GamepadResponse::XInput(0.2f).leftStick.Table();
+
+	CHECK(first != second);
+
+	// Alternating deadzones reuses the tables built for each.
+	for (int i = 0; i < 100; ++i)
+	{
+		CHECK(GamepadResponse::XInput(0.1f).leftStick.Table() == first);
+		CHECK(GamepadResponse::XInput(0.2f).leftStick.Table() == second);
+	}
+
+	// Past the cache size the oldest deadzone is rebuilt, with the same values.
+	for (size_t i = 0; i < GamepadResponse::XInputCacheSize; ++i)
+		GamepadResponse::XInput(0.3f + 0.01f * i);
+
+	CHECK(MatchesHistorical(GamepadResponse::XInput(0.1f).leftStick, 0.1f));
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(ResponsesReachTheSamplerThroughTheMailbox)
+{
+	GamepadImpl_Mock mock;
+	GamepadImpl_Mock::RawState raw = {};
+	raw.thumbLX = 20000;
+	raw.connected = true;
+	mock.SetRawState(Gamepad::Index::ONE, raw);
+	IGamepadImpl::SetInstance(&mock);
+
+	CHECK(Gamepad::StartSampling(std::chrono::milliseconds(1)));
+
+	Gamepad pad(Gamepad::Index::ONE);
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	pad.Poll();
+	CHECK_NEAR(pad.LeftStick()[0], HistoricalStick(20000, 7849.0f / 32767), 1.0f / 32767);
+
+	// Swap curves while the sampler decodes through them; the idle pad keeps its packet but must still pick up the new curve.
+	AxisCurve steep = { AxisCurve::Shape::POWER, 0.0f, 1.0f, 2.0f };
+	GamepadResponse custom = { StickResponse(steep), StickResponse(steep), TriggerResponse(), TriggerResponse() };
+
+	for (int i = 0; i < 200; ++i)
+	{
+		Gamepad::SetResponse(Gamepad::Index::ONE, (i & 1) != 0 ? custom : GamepadResponse::XInput(0.05f * (i % 7)));
+		pad.Poll();
+	}
+
+	Gamepad::SetResponse(Gamepad::Index::ONE, GamepadResponse::Linear());
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	pad.Poll();
+	CHECK_NEAR(pad.LeftStick()[0], 20000.0f / 32767, 1.0f / 32767);
+
+	Gamepad::StopSampling();
+	Gamepad::SetResponse(Gamepad::Index::ONE, GamepadResponse::XInput());
+	IGamepadImpl::SetInstance(nullptr);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(BatchKernelsMatchTheScalarLookupsBitForBit)
+{
+	AxisCurve steep = { AxisCurve::Shape::POWER, 0.1f, 0.95f, 2.2f };
+	StickResponse inverted(steep, true, false);
+	TriggerResponse curved(steep);
+
+	Response::Kernel previous = Response::ActiveKernel();
+
+	for (Response::Kernel kernel : { Response::Kernel::SCALAR, Response::Kernel::SSE2, Response::Kernel::AVX2 })
+	{
+		// Kernels the CPU lacks fall back to one already covered.
+		if (Response::SelectKernel(kernel) != kernel)
+			continue;
+
+		CHECK(BatchMatchesScalar(StickResponse::XInputLeft()));
+		CHECK(BatchMatchesScalar(StickResponse::Linear()));
+		CHECK(BatchMatchesScalar(inverted));
+		CHECK(BatchMatchesScalar(TriggerResponse::Linear()));
+		CHECK(BatchMatchesScalar(curved));
+	}
+
+	Response::SelectKernel(previous);
+}
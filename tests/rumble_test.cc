@@ -0,0 +1,199 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "decaf/input/gamepad.hh"
+#include "decaf/input/gamepadimpl.hh"
+#include "decaf/input/mock/gamepadimpl_mock.hh"
+#include "decaf/input/rumble.hh"
+
+#include "test.hh"
+
+using namespace decaf;
+
+namespace
+{
+
+	/// <summary>A mock that counts rumble writes and flags those from any thread but the one updating it.</summary>
+	class OwnedMock : public GamepadImpl_Mock
+	{
+
+	public:
+
+		OwnedMock()
+			: m_foreign{ 0 }, m_writes{ 0 } { }
+
+		virtual void Update()
+		{
+			m_owner = std::this_thread::get_id();
+			GamepadImpl_Mock::Update();
+		}
+
+		virtual void SetRumble(Gamepad::Index index, float left, float right)
+		{
+			if (std::this_thread::get_id() != m_owner)
+				m_foreign.fetch_add(1, std::memory_order_relaxed);
+
+			m_writes.fetch_add(1, std::memory_order_relaxed);
+
+			GamepadImpl_Mock::SetRumble(index, left, right);
+		}
+
+		inline uint32_t Foreign() const { return m_foreign.load(std::memory_order_relaxed); }
+
+		inline uint32_t Writes() const { return m_writes.load(std::memory_order_relaxed); }
+
+	private:
+
+		std::thread::id m_owner;
+		std::atomic<uint32_t> m_foreign;
+		std::atomic<uint32_t> m_writes;
+
+	};
+
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(MixerSubmitsOnlyChangedMixes)
+{
+	GamepadImpl_Mock mock;
+	RumbleMixer mixer;
+
+	mixer.SetLevel(Gamepad::Index::TWO, 0.5f, 0.25f, 0);
+	mixer.SetLevel(Gamepad::Index::TWO, 0.5f, 0.25f, 1);
+	CHECK(mixer.IsPending());
+	CHECK(mixer.SubmitCount() == 0);
+
+	mixer.Submit(mock);
+	mixer.Submit(mock);
+	CHECK(!mixer.IsPending());
+	CHECK(mixer.SubmitCount() == 1);
+
+	float left, right;
+	mock.GetRumble(Gamepad::Index::TWO, left, right);
+	CHECK_NEAR(left, 0.5f, 1.0f / 65535);
+	CHECK_NEAR(right, 0.25f, 1.0f / 65535);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(MixesThatComeBackBeforeSubmissionAreNotWritten)
+{
+	GamepadImpl_Mock mock;
+	RumbleMixer mixer;
+
+	mixer.SetLevel(Gamepad::Index::ONE, 0.5f, 0.5f, 0);
+	mixer.Submit(mock);
+	CHECK(mixer.SubmitCount() == 1);
+
+	// Away and back between two submissions: the motors already run at the mix.
+	mixer.SetLevel(Gamepad::Index::ONE, 0.25f, 0.5f, 1);
+	mixer.SetLevel(Gamepad::Index::ONE, 0.5f, 0.5f, 2);
+	CHECK(mixer.IsPending());
+	mixer.Submit(mock);
+	CHECK(!mixer.IsPending());
+	CHECK(mixer.SubmitCount() == 1);
+
+	// A different backend is written, whatever the previous one was left at.
+	GamepadImpl_Mock other;
+	mixer.SetLevel(Gamepad::Index::ONE, 0.25f, 0.5f, 3);
+	mixer.SetLevel(Gamepad::Index::ONE, 0.5f, 0.5f, 4);
+	mixer.Submit(other);
+	CHECK(mixer.SubmitCount() == 2);
+
+	float left, right;
+	other.GetRumble(Gamepad::Index::ONE, left, right);
+	CHECK_NEAR(left, 0.5f, 1.0f / 65535);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(UpdateWritesEachChangedPadAtMostOnce)
+{
+	OwnedMock mock;
+	IGamepadImpl::SetInstance(&mock);
+	Gamepad::Update();
+	uint32_t before = mock.Writes();
+
+	for (int frame = 1; frame <= 10; ++frame)
+	{
+		for (int i = 0; i < 20; ++i)
+		{
+			Gamepad::SetRumble(Gamepad::Index::ONE, (frame * 20 + i) / 1000.0f, 0.0f);
+			Gamepad::SetRumble(Gamepad::Index::TWO, 0.0f, (frame * 20 + i) / 1000.0f);
+		}
+
+		Gamepad::Update();
+		CHECK(mock.Writes() - before == static_cast<uint32_t>(frame * 2));
+	}
+
+	// Unchanged mixes write nothing.
+	Gamepad::Update();
+	CHECK(mock.Writes() - before == 20);
+
+	Gamepad::SetRumble(Gamepad::Index::ONE, 0.0f, 0.0f);
+	Gamepad::SetRumble(Gamepad::Index::TWO, 0.0f, 0.0f);
+	Gamepad::FlushRumble();
+	CHECK(mock.Foreign() == 0);
+
+	IGamepadImpl::SetInstance(nullptr);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(RumbleReachesTheBackendOnUpdate)
+{
+	OwnedMock mock;
+	IGamepadImpl::SetInstance(&mock);
+	Gamepad::Update();
+
+	float left, right;
+	Gamepad::SetRumble(Gamepad::Index::ONE, 0.75f, 0.5f);
+	mock.GetRumble(Gamepad::Index::ONE, left, right);
+	CHECK(left == 0.0f && right == 0.0f);
+
+	Gamepad::Update();
+	mock.GetRumble(Gamepad::Index::ONE, left, right);
+	CHECK_NEAR(left, 0.75f, 1.0f / 65535);
+	CHECK_NEAR(right, 0.5f, 1.0f / 65535);
+
+	Gamepad::SetRumble(Gamepad::Index::ONE, 0.0f, 0.0f);
+	Gamepad::FlushRumble();
+	mock.GetRumble(Gamepad::Index::ONE, left, right);
+	CHECK(left == 0.0f && right == 0.0f);
+	CHECK(mock.Foreign() == 0);
+
+	IGamepadImpl::SetInstance(nullptr);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(SamplerSubmitsRumbleWhileSampling)
+{
+	OwnedMock mock;
+	IGamepadImpl::SetInstance(&mock);
+	CHECK(Gamepad::StartSampling(std::chrono::microseconds(200)));
+
+	// Every change must go through the sampler thread, however often the game thread mixes.
+	for (int i = 0; i < 2000; ++i)
+	{
+		Gamepad::SetRumble(Gamepad::Index::THREE, (i % 100) / 100.0f, 0.5f);
+		Gamepad::Update();
+	}
+
+	Gamepad::SetRumble(Gamepad::Index::THREE, 1.0f, 0.125f);
+	Gamepad::FlushRumble();
+
+	float left, right;
+	mock.GetRumble(Gamepad::Index::THREE, left, right);
+	CHECK_NEAR(left, 1.0f, 1.0f / 65535);
+	CHECK_NEAR(right, 0.125f, 1.0f / 65535);
+
+	Gamepad::SetRumble(Gamepad::Index::THREE, 0.0f, 0.0f);
+	Gamepad::FlushRumble();
+	Gamepad::StopSampling();
+
+	CHECK(mock.Foreign() == 0);
+	IGamepadImpl::SetInstance(nullptr);
+}
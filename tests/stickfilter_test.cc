@@ -0,0 +1,210 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "decaf/input/gamepad.hh"
+#include "decaf/input/gamepadimpl.hh"
+#include "decaf/input/mock/gamepadimpl_mock.hh"
+#include "decaf/input/response.hh"
+#include "decaf/input/stickfilter.hh"
+
+#include "test.hh"
+
+using namespace decaf;
+
+namespace
+{
+
+	constexpr uint64_t Millisecond = 1000000;
+
+	/// <summary>A recorded left-stick X trace: samples every <c>period</c> ns, at rest, then a step to <c>level</c> at <c>stepAt</c>, with uniform noise.</summary>
+	struct Replay
+	{
+		uint64_t period;
+		uint64_t stepAt;
+		float level;
+		float noise;
+		std::vector<float> samples;
+
+		Replay(uint64_t period, uint64_t duration, uint64_t stepAt, float level, float noise)
+			: period{ period }, stepAt{ stepAt }, level{ level }, noise{ noise }
+		{
+			uint32_t seed = 12345;
+
+			for (uint64_t t = 0; t < duration; t += period)
+			{
+				seed = seed * 1664525u + 1013904223u;
+				float jitter = (static_cast<float>(seed >> 8) / 16777216.0f * 2.0f - 1.0f) * noise;
+				samples.push_back((t >= stepAt ? level : 0.0f) + jitter);
+			}
+		}
+
+		/// <summary>Gets the newest sample at <paramref name='now'/>, as a backend would hand it out.</summary>
+		Gamepad::State At(uint64_t now) const
+		{
+			size_t i = static_cast<size_t>(now / period);
+			i = i < samples.size() ? i : samples.size() - 1;
+
+			Gamepad::State state = {};
+			state.leftStick = Vector2f(samples[i], 0.0f);
+			state.connected = true;
+			state.packet = static_cast<uint32_t>(i + 1);
+			state.timestamp = i * period;
+			return state;
+		}
+	};
+
+	/// <summary>What a filter made of a replay polled every <c>pollPeriod</c>.</summary>
+	struct Response
+	{
+		/// <summary>How long after the step the output first reached 90% of it.</summary>
+		uint64_t rise;
+		/// <summary>The standard deviation of the output around the level, once settled, and of the raw samples over the same span.</summary>
+		float jitter;
+		float rawJitter;
+	};
+
+	Response Play(const Replay& replay, const StickFilterSettings& settings, uint64_t pollPeriod, uint64_t settleFrom)
+	{
+		StickFilter filter;
+		filter.SetSettings(Gamepad::Index::ONE, settings, StickFilterSettings::None());
+
+		Response response = { UINT64_MAX, 0.0f, 0.0f };
+		double squares = 0.0;
+		double rawSquares = 0.0;
+		size_t count = 0;
+		uint64_t duration = replay.samples.size() * replay.period;
+
+		for (uint64_t now = 0; now < duration; now += pollPeriod)
+		{
+			Gamepad::State state = replay.At(now);
+			float raw = state.leftStick[0];
+			filter.Apply(Gamepad::Index::ONE, state, now);
+			float out = state.leftStick[0];
+
+			if (now >= replay.stepAt && response.rise == UINT64_MAX && out >= 0.9f * replay.level)
+				response.rise = now - replay.stepAt;
+
+			if (now >= settleFrom)
+			{
+				squares += (out - replay.level) * (out - replay.level);
+				rawSquares += (raw - replay.level) * (raw - replay.level);
+				++count;
+			}
+		}
+
+		response.jitter = static_cast<float>(std::sqrt(squares / count));
+		response.rawJitter = static_cast<float>(std::sqrt(rawSquares / count));
+		return response;
+	}
+
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(AHeldSampleKeepsConverging)
+{
+	StickFilter filter;
+	filter.SetSettings(Gamepad::Index::ONE, StickFilterSettings::CriticallyDamped(0.05f), StickFilterSettings::None());
+
+	Gamepad::State rest = {};
+	rest.connected = true;
+	rest.packet = 1;
+	filter.Apply(Gamepad::Index::ONE, rest, 0);
+
+	// One sample of the step, then the device goes quiet while the game keeps polling.
+	Gamepad::State step = rest;
+	step.leftStick = Vector2f(1.0f, 0.0f);
+	step.packet = 2;
+	step.timestamp = Millisecond;
+
+	float out = 0.0f;
+
+	for (uint64_t now = Millisecond; now <= 500 * Millisecond; now += Millisecond)
+	{
+		Gamepad::State state = step;
+		filter.Apply(Gamepad::Index::ONE, state, now);
+		CHECK(state.leftStick[0] >= out);
+		out = state.leftStick[0];
+	}
+
+	CHECK(out == 1.0f);
+	CHECK(filter.IsSettled(Gamepad::Index::ONE));
+
+	// Reading again at the same instant does not advance the filter.
+	Gamepad::State again = step;
+	filter.Apply(Gamepad::Index::ONE, again, 500 * Millisecond);
+	CHECK(again.leftStick[0] == out);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(ReplayedStepsRiseQuicklyAndRestQuietly)
+{
+	// A 1 kHz device stepping to 0.8 with +-0.02 of sensor noise.
+	Replay replay(Millisecond, 2000 * Millisecond, 200 * Millisecond, 0.8f, 0.02f);
+
+	Response damped = Play(replay, StickFilterSettings::CriticallyDamped(0.05f), Millisecond, 1000 * Millisecond);
+	CHECK(damped.rise > 50 * Millisecond && damped.rise < 150 * Millisecond);
+	CHECK(damped.jitter < 0.25f * damped.rawJitter);
+
+	Response euro = Play(replay, StickFilterSettings::OneEuro(), Millisecond, 1000 * Millisecond);
+	CHECK(euro.rise < 30 * Millisecond);
+	CHECK(euro.jitter < 0.5f * euro.rawJitter);
+
+	Response none = Play(replay, StickFilterSettings::None(), Millisecond, 1000 * Millisecond);
+	CHECK(none.rise == 0);
+	CHECK(none.jitter == none.rawJitter);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(PollingFasterThanTheDeviceDoesNotChangeTheLag)
+{
+	// The same trace at 125 Hz, read by a game polling at 1 kHz and at 125 Hz.
+	Replay replay(8 * Millisecond, 2000 * Millisecond, 200 * Millisecond, 0.8f, 0.0f);
+
+	Response fast = Play(replay, StickFilterSettings::CriticallyDamped(0.05f), Millisecond, 1000 * Millisecond);
+	Response slow = Play(replay, StickFilterSettings::CriticallyDamped(0.05f), 8 * Millisecond, 1000 * Millisecond);
+
+	CHECK(fast.rise < 150 * Millisecond);
+	CHECK(slow.rise < 150 * Millisecond);
+	CHECK((fast.rise > slow.rise ? fast.rise - slow.rise : slow.rise - fast.rise) <= 8 * Millisecond);
+	CHECK(fast.jitter == 0.0f && slow.jitter == 0.0f);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(PollsOfAnIdlePadFollowTheFilter)
+{
+	GamepadImpl_Mock mock;
+	IGamepadImpl::SetInstance(&mock);
+	Gamepad::SetResponse(Gamepad::Index::ONE, GamepadResponse::Linear());
+	Gamepad::SetStickFilter(Gamepad::Index::ONE, StickFilterSettings::CriticallyDamped(0.05f), StickFilterSettings::None());
+
+	GamepadImpl_Mock::RawState raw = {};
+	raw.connected = true;
+	mock.SetRawState(Gamepad::Index::ONE, raw);
+
+	Gamepad pad(Gamepad::Index::ONE);
+	pad.Poll();
+
+	// The stick moves once and then holds, so every later poll sees the same packet.
+	raw.thumbLX = 32767;
+	mock.SetRawState(Gamepad::Index::ONE, raw);
+
+	for (int i = 0; i < 100; ++i)
+	{
+		pad.Poll();
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+
+	pad.Poll();
+	CHECK(pad.LeftStick()[0] == 1.0f);
+
+	Gamepad::SetStickFilter(Gamepad::Index::ONE, StickFilterSettings::None(), StickFilterSettings::None());
+	Gamepad::SetResponse(Gamepad::Index::ONE, GamepadResponse::XInput());
+	IGamepadImpl::SetInstance(nullptr);
+}
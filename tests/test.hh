@@ -0,0 +1,80 @@
+#ifndef DECAF_TESTS_TEST_HH_
+#define DECAF_TESTS_TEST_HH_
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace decaf
+{
+	namespace Test
+	{
+
+		struct Case
+		{
+			const char* name;
+			void (*run)();
+		};
+
+		inline std::vector<Case>& Cases()
+		{
+			static std::vector<Case> cases;
+			return cases;
+		}
+
+		inline int& Failures()
+		{
+			static int failures = 0;
+			return failures;
+		}
+
+		/// <summary>Adds a test case to the executable it is linked into. Used through <c>DECAF_TEST</c>.</summary>
+		struct Registrar
+		{
+			Registrar(const char* name, void (*run)()) { Cases().push_back({ name, run }); }
+		};
+
+		inline bool Check(bool passed, const char* expression, const char* file, int line)
+		{
+			if (!passed)
+			{
+				++Failures();
+				std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+			}
+
+			return passed;
+		}
+
+		/// <summary>Runs every registered case whose name contains <c>argv[1]</c>, or all of them. Returns non-zero if any check failed.</summary>
+		inline int Run(int argc, char** argv)
+		{
+			const char* filter = argc > 1 ? argv[1] : "";
+
+			for (const Case& c : Cases())
+			{
+				if (std::strstr(c.name, filter) == nullptr)
+					continue;
+
+				int before = Failures();
+				c.run();
+				std::printf("%-48s %s\n", c.name, Failures() == before ? "ok" : "FAILED");
+			}
+
+			return Failures() == 0 ? 0 : 1;
+		}
+
+	}
+}
+
+#define DECAF_TEST(name) \
+	static void name(); \
+	static decaf::Test::Registrar name##Registrar(#name, &name); \
+	static void name()
+
+#define CHECK(expression) decaf::Test::Check((expression), #expression, __FILE__, __LINE__)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+	decaf::Test::Check(std::fabs(double(actual) - double(expected)) <= double(tolerance), #actual " ~ " #expected, __FILE__, __LINE__)
+
+#endif
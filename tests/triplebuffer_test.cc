@@ -0,0 +1,170 @@
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "decaf/concurrent/triplebuffer.hh"
+#include "decaf/input/gamepadimpl.hh"
+#include "decaf/input/gamepadsampler.hh"
+#include "decaf/input/mock/gamepadimpl_mock.hh"
+#include "decaf/input/response.hh"
+
+#include "test.hh"
+
+using namespace decaf;
+
+namespace
+{
+
+	/// <summary>A value large enough to span several cache lines, every word of which holds the same serial.</summary>
+	struct Wide
+	{
+		uint64_t words[48];
+	};
+
+	/// <summary>Scripts every field of a pad from one counter, so a state mixing two updates is detectable.</summary>
+	GamepadImpl_Mock::RawState Counter(Gamepad::Index index, uint64_t update, void*)
+	{
+		GamepadImpl_Mock::RawState raw = {};
+		int16_t value = static_cast<int16_t>((update * 7 + static_cast<uint64_t>(index)) % 30000);
+
+		raw.thumbLX = value;
+		raw.thumbLY = static_cast<int16_t>(-value);
+		raw.thumbRX = static_cast<int16_t>(value / 2);
+		raw.thumbRY = static_cast<int16_t>(-value / 3);
+		raw.leftTrigger = static_cast<uint8_t>(value);
+		raw.rightTrigger = static_cast<uint8_t>(value >> 7);
+		raw.buttons = static_cast<uint16_t>(value);
+		raw.connected = true;
+
+		return raw;
+	}
+
+	/// <summary>Whether a state is exactly the decoding of the <c>Counter</c> reading its buttons name.</summary>
+	bool IsWhole(const Gamepad::State& state)
+	{
+		Gamepad::RawState raw = {};
+		int16_t value = static_cast<int16_t>(state.buttons);
+
+		raw.thumbLX = value;
+		raw.thumbLY = static_cast<int16_t>(-value);
+		raw.thumbRX = static_cast<int16_t>(value / 2);
+		raw.thumbRY = static_cast<int16_t>(-value / 3);
+		raw.leftTrigger = static_cast<uint8_t>(value);
+		raw.rightTrigger = static_cast<uint8_t>(value >> 7);
+		raw.buttons = static_cast<uint16_t>(value);
+
+		Gamepad::State expected = {};
+		GamepadResponse::Linear().Decode(raw, expected);
+
+		return state.connected
+			&& state.leftStick.X() == expected.leftStick.X() && state.leftStick.Y() == expected.leftStick.Y()
+			&& state.rightStick.X() == expected.rightStick.X() && state.rightStick.Y() == expected.rightStick.Y()
+			&& state.leftTrigger == expected.leftTrigger && state.rightTrigger == expected.rightTrigger;
+	}
+
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(TripleBufferReadsArePublishedWhole)
+{
+	constexpr uint64_t Publishes = 1000000;
+
+	TripleBuffer<Wide> buffer;
+	std::atomic<bool> done{ false };
+
+	std::thread producer([&]()
+	{
+		for (uint64_t serial = 1; serial <= Publishes; ++serial)
+		{
+			Wide& value = buffer.WriteBuffer();
+
+			for (uint64_t& word : value.words)
+				word = serial;
+
+			buffer.Publish();
+		}
+
+		done.store(true, std::memory_order_release);
+	});
+
+	uint64_t last = 0;
+	uint64_t reads = 0;
+	bool whole = true;
+	bool ordered = true;
+
+	for (;;)
+	{
+		bool finished = done.load(std::memory_order_acquire);
+
+		if (buffer.Acquire())
+		{
+			const Wide& value = buffer.ReadBuffer();
+
+			for (uint64_t word : value.words)
+				whole &= word == value.words[0];
+
+			ordered &= value.words[0] > last;
+			last = value.words[0];
+			++reads;
+		}
+		else if (finished)
+			break;
+	}
+
+	producer.join();
+
+	CHECK(whole);
+	CHECK(ordered);
+	CHECK(reads > 0);
+	CHECK(last == Publishes);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(SamplerReadsAreWholeUnderLoad)
+{
+	GamepadImpl_Mock mock;
+
+	for (size_t i = 0; i < Gamepad::IndexCount; ++i)
+		mock.SetResponse(static_cast<Gamepad::Index>(i), GamepadResponse::Linear());
+
+	mock.SetGenerator(&Counter);
+
+	GamepadSampler sampler;
+	CHECK(sampler.Start(&mock, std::chrono::microseconds(0)));
+
+	uint32_t lastPacket[Gamepad::IndexCount] = {};
+	uint64_t fresh = 0;
+	bool whole = true;
+	bool ordered = true;
+
+	auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(300);
+
+	while (std::chrono::steady_clock::now() < end)
+	{
+		for (size_t i = 0; i < Gamepad::IndexCount; ++i)
+		{
+			Gamepad::State state;
+			Gamepad::Index index = static_cast<Gamepad::Index>(i);
+
+			if (sampler.Read(index, state))
+			{
+				whole &= IsWhole(state);
+				ordered &= state.packet > lastPacket[i];
+				lastPacket[i] = state.packet;
+				++fresh;
+			}
+
+			Gamepad::State latest;
+			sampler.ReadLatest(index, latest);
+			whole &= IsWhole(latest);
+		}
+	}
+
+	sampler.Stop();
+
+	CHECK(whole);
+	CHECK(ordered);
+	CHECK(fresh > 0);
+}
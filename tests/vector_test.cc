@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "decaf/math/vector.hh"
+#include "decaf/math/vectorarray.hh"
+
+#include "test.hh"
+
+using namespace decaf;
+
+namespace
+{
+
+	/// <summary>Three ranges, the last one short, each ending off a multiple of four so the SSE loops leave a scalar tail.</summary>
+	constexpr size_t BulkCount = 3 * VectorArray3f::ParallelChunk + 7;
+	constexpr size_t BulkThreads = 3;
+
+	/// <summary>Fills an array with reproducible values in [-8, 8), with a zero vector at <paramref name='zero'/>.</summary>
+	VectorArray3f Filled(size_t count, uint32_t seed, size_t zero)
+	{
+		VectorArray3f result(count);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			Vector3f v;
+			for (size_t c = 0; c < 3; ++c)
+			{
+				seed = seed * 1664525u + 1013904223u;
+				v[c] = static_cast<float>(seed >> 8) / static_cast<float>(1u << 24) * 16.0f - 8.0f;
+			}
+
+			result.Set(i, i == zero ? Vector3f(0.0f) : v);
+		}
+
+		return result;
+	}
+
+	/// <summary>Whether a bulk result matches its per-element counterpart, up to the rounding of a differently ordered sum. NaN matches NaN.</summary>
+	bool Matches(float bulk, float single)
+	{
+		if (std::isnan(single))
+			return std::isnan(bulk);
+
+		return std::fabs(bulk - single) <= 1e-5f * std::max(1.0f, std::fabs(single));
+	}
+
+	bool Matches(const Vector3f& bulk, const Vector3f& single)
+	{
+		return Matches(bulk[0], single[0]) && Matches(bulk[1], single[1]) && Matches(bulk[2], single[2]);
+	}
+
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(LengthFastOfAZeroVectorIsZero)
+{
+	CHECK(Vector2f(0.0f).LengthFast() == 0.0f);
+	CHECK(Vector3f(0.0f).LengthFast() == 0.0f);
+	CHECK(Vector4f(0.0f).LengthFast() == 0.0f);
+	CHECK(Vector3d(0.0).LengthFast() == 0.0);
+
+	CHECK_NEAR(Vector2f(3.0f, 4.0f).LengthFast(), 5.0f, 1e-3f);
+	CHECK_NEAR(Vector3f(2.0f, 3.0f, 6.0f).LengthFast(), 7.0f, 1e-3f);
+	CHECK_NEAR(Vector4f(1.0f, 1.0f, 1.0f, 1.0f).LengthFast(), 2.0f, 1e-3f);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(OperatorResultsOwnTheirValues)
+{
+	auto sum = Vector3f(1.0f, 2.0f, 3.0f) + Vector3f(4.0f, 5.0f, 6.0f);
+
+	CHECK(sum[0] == 5.0f && sum[1] == 7.0f && sum[2] == 9.0f);
+
+	Vector2f a(3.0f, 0.0f);
+	Vector2f b(0.0f, 4.0f);
+	auto scaled = (a + b) * 2.0f;
+	a = Vector2f(100.0f);
+
+	CHECK(scaled[0] == 6.0f && scaled[1] == 8.0f);
+	CHECK((Vector2f(3.0f, 0.0f) + b).Length() == 5.0f);
+	CHECK((-b).LengthSquared() == 16.0f);
+	CHECK(Vector::Dot(a - b, Vector2f(1.0f, 1.0f)) == 196.0f);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(CompoundOperatorsMatchTheirBinaryForms)
+{
+	Vector4f v(1.0f, 2.0f, 3.0f, 4.0f);
+	const Vector4f w(2.0f);
+
+	v += w;
+	CHECK(v == Vector4f(3.0f, 4.0f, 5.0f, 6.0f));
+	v -= w;
+	CHECK(v == Vector4f(1.0f, 2.0f, 3.0f, 4.0f));
+	v *= w;
+	CHECK(v == Vector4f(2.0f, 4.0f, 6.0f, 8.0f));
+	v /= 2.0f;
+	CHECK(v == Vector4f(1.0f, 2.0f, 3.0f, 4.0f));
+
+	// Aliasing the destination is fine, because every operator evaluates into a new vector.
+	v = v * v - v;
+	CHECK(v == Vector4f(0.0f, 2.0f, 6.0f, 12.0f));
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(BulkLengthsMatchTheirVectorForms)
+{
+	VectorArray3f vectors = Filled(BulkCount, 1, 5);
+	std::vector<float> lengths(BulkCount);
+	std::vector<float> squared(BulkCount);
+
+	Vector::Length(vectors, lengths.data(), BulkThreads);
+	Vector::LengthSquared(vectors, squared.data(), BulkThreads);
+
+	bool matches = true;
+	for (size_t i = 0; i < BulkCount; ++i)
+		matches &= Matches(lengths[i], vectors.Get(i).Length()) && Matches(squared[i], vectors.Get(i).LengthSquared());
+
+	CHECK(matches);
+
+	VectorArray3f normalized = Filled(BulkCount, 1, 5);
+	Vector::Normalize(normalized, BulkThreads);
+
+	// Including the zero vector, which both forms turn into NaNs.
+	matches = true;
+	for (size_t i = 0; i < BulkCount; ++i)
+		matches &= Matches(normalized.Get(i), Vector3f(vectors.Get(i)).Normalize());
+
+	CHECK(matches);
+	CHECK(std::isnan(normalized.Get(5)[0]));
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(BulkPairwiseFunctionsMatchTheirVectorForms)
+{
+	VectorArray3f lhs = Filled(BulkCount, 2, 9);
+	VectorArray3f rhs = Filled(BulkCount + 3, 3, 11);
+	std::vector<float> dots(BulkCount);
+	VectorArray3f minimum;
+	VectorArray3f maximum;
+	VectorArray3f reflected;
+
+	Vector::Dot(lhs, rhs, dots.data(), BulkThreads);
+	Vector::Min(lhs, rhs, minimum, BulkThreads);
+	Vector::Max(lhs, rhs, maximum, BulkThreads);
+	Vector::Reflect(lhs, rhs, reflected, BulkThreads);
+
+	// Pairwise results cover the shorter operand.
+	CHECK(minimum.Size() == BulkCount && maximum.Size() == BulkCount && reflected.Size() == BulkCount);
+
+	bool matches = true;
+	for (size_t i = 0; i < BulkCount; ++i)
+	{
+		Vector3f a = lhs.Get(i);
+		Vector3f b = rhs.Get(i);
+
+		matches &= Matches(dots[i], Vector::Dot(a, b));
+		matches &= minimum.Get(i) == Vector::Min(a, b) && maximum.Get(i) == Vector::Max(a, b);
+		matches &= Matches(reflected.Get(i), Vector::Reflect(a, b));
+	}
+
+	CHECK(matches);
+
+	// Reflecting in place gives the same vectors.
+	Vector::Reflect(lhs, rhs, lhs, BulkThreads);
+
+	matches = true;
+	for (size_t i = 0; i < BulkCount; ++i)
+		matches &= lhs.Get(i) == reflected.Get(i);
+
+	CHECK(matches);
+}
+
+
+////////////////////////////////////////////////////////////
+DECAF_TEST(BulkFunctionsAcceptEmptyArrays)
+{
+	VectorArray3f empty;
+	VectorArray3f other = Filled(4, 4, 0);
+	VectorArray3f out = Filled(2, 5, 0);
+	float sentinel = 42.0f;
+
+	Vector::Length(empty, &sentinel, 0);
+	Vector::LengthSquared(empty, &sentinel, 0);
+	Vector::Normalize(empty, 0);
+	Vector::Dot(empty, other, &sentinel, 0);
+	CHECK(sentinel == 42.0f && empty.Empty());
+
+	Vector::Min(empty, other, out, 0);
+	CHECK(out.Empty());
+
+	out = Filled(2, 5, 0);
+	Vector::Max(other, empty, out, 0);
+	CHECK(out.Empty());
+
+	out = Filled(2, 5, 0);
+	Vector::Reflect(empty, other, out, 0);
+	CHECK(out.Empty());
+}